@@ -0,0 +1,1986 @@
+#include <assert.h>
+#include <complex.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Coefficients.h"
+
+// under these degrees, the quadratic algorithms are faster than the fast ones
+#define PRODUCT_SCHOOLBOOK_THRESHOLD 32
+#define TAYLOR_SHIFT_HORNER_THRESHOLD 64
+#define COMPOSE_HORNER_THRESHOLD 4
+#define CHEBYSHEV_CONVERSION_THRESHOLD 32
+
+#define PI 3.14159265358979323846
+
+// the error of a FFT product is taken as at most this many times ||left|| ||right|| log2(size) DBL_EPSILON
+#define FFT_ERROR_FACTOR 16
+
+// number of coefficients hashed together by coefficients_hash, the width of a SSE2 register
+#define HASH_WIDTH 2
+
+// added to degrees before mixing them, so that x^0 doesn't mix 0
+#define HASH_DEGREE_SEED 0x9e3779b97f4a7c15ULL
+
+#define DOUBLE_SIGN_BIT 0x8000000000000000ULL
+#define DOUBLE_ONE_HALF_BITS 0x3fe0000000000000ULL
+
+typedef unsigned long long HashVector __attribute__((vector_size(HASH_WIDTH * sizeof(unsigned long long))));
+typedef long long HashIntegersVector __attribute__((vector_size(HASH_WIDTH * sizeof(long long))));
+typedef double HashCoefficientsVector __attribute__((vector_size(HASH_WIDTH * sizeof(double))));
+
+// number of points computed together by coefficients_horner_compensated_points, the width of a SSE2 register
+#define HORNER_WIDTH 2
+
+// 2^27 + 1, which splits a double into two halves of 26 bits
+#define HORNER_SPLIT_FACTOR 134217729.0
+
+typedef double HornerVector __attribute__((vector_size(HORNER_WIDTH * sizeof(double))));
+typedef long long HornerIntegersVector __attribute__((vector_size(HORNER_WIDTH * sizeof(long long))));
+
+
+static void* coefficients_allocate(size_t size) {
+  void *memory = malloc(size);
+  if(!memory) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return memory;
+}
+
+
+/*
+ * Element-wise kernels, in one scalar version and one version per SIMD instruction set,
+ * selected once at startup from what the processor supports (see coefficients_set_kernels).
+ * Every version does the same operations on every coefficient, in the same order, with no contraction:
+ * their results are identical, bit for bit.
+ * Lengths are numbers of coefficients, not degrees.
+ */
+typedef struct {
+  void (*add)(double *destination, const double *source, long length);
+  void (*axpy)(double *destination, double factor, const double *source, long length);
+  long (*compact)(const double *coefficients, long length, double tolerance, double *compacted, long *degrees);
+  long (*degree)(const double *coefficients, long length, double tolerance);
+  void (*derivative)(const double *coefficients, long length, double *result);
+  void (*scale)(double *coefficients, long length, double factor);
+} CoefficientsKernels;
+
+
+static void kernel_add_scalar(double *destination, const double *source, long length) {
+  long index;
+  for(index = 0; index < length; index++) {
+    destination[index] += source[index];
+  }
+}
+
+
+static void kernel_axpy_scalar(double *destination, double factor, const double *source, long length) {
+  long index;
+  for(index = 0; index < length; index++) {
+    destination[index] += factor * source[index];
+  }
+}
+
+
+static long kernel_compact_scalar(const double *coefficients, long length, double tolerance, double *compacted, long *degrees) {
+  long index, count = 0;
+  for(index = 0; index < length; index++) {
+    // written so that NaN is kept, as is_coefficient_null does
+    if(!(fabs(coefficients[index]) < tolerance)) {
+      compacted[count] = coefficients[index];
+      degrees[count] = index;
+      count++;
+    }
+  }
+
+  return count;
+}
+
+
+static long kernel_degree_scalar(const double *coefficients, long length, double tolerance) {
+  long index;
+  for(index = length - 1; index >= 0; index--) {
+    if(!(fabs(coefficients[index]) < tolerance)) {
+      return index;
+    }
+  }
+
+  return -1;
+}
+
+
+static void kernel_derivative_scalar(const double *coefficients, long length, double *result) {
+  long index;
+  for(index = 0; index < length; index++) {
+    result[index] = coefficients[index + 1] * (double) (index + 1);
+  }
+}
+
+
+static void kernel_scale_scalar(double *coefficients, long length, double factor) {
+  long index;
+  for(index = 0; index < length; index++) {
+    coefficients[index] *= factor;
+  }
+}
+
+
+static const CoefficientsKernels kernels_scalar = {
+  kernel_add_scalar, kernel_axpy_scalar, kernel_compact_scalar, kernel_degree_scalar, kernel_derivative_scalar, kernel_scale_scalar
+};
+
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define COEFFICIENTS_KERNELS_X86
+
+/*
+ * The SIMD versions process width coefficients at a time, then finish with the scalar version.
+ * isa is the instruction set the compiler may use in them, whatever the flags of the build.
+ * |x| < tolerance is computed on the bits of x, clearing its sign, so that NaN compares as it does in scalar code.
+ */
+#define DEFINE_COEFFICIENTS_KERNELS(suffix, width, isa) \
+  typedef double KernelVector_##suffix __attribute__((vector_size((width) * sizeof(double)))); \
+  typedef long long KernelIntegersVector_##suffix __attribute__((vector_size((width) * sizeof(long long)))); \
+  \
+  __attribute__((target(isa))) static void kernel_add_##suffix(double *destination, const double *source, long length) { \
+    long index; \
+    for(index = 0; index + (width) <= length; index += (width)) { \
+      KernelVector_##suffix left, right; \
+      memcpy(&left, destination + index, sizeof(left)); \
+      memcpy(&right, source + index, sizeof(right)); \
+      left += right; \
+      memcpy(destination + index, &left, sizeof(left)); \
+    } \
+    kernel_add_scalar(destination + index, source + index, length - index); \
+  } \
+  \
+  __attribute__((target(isa))) static void kernel_axpy_##suffix(double *destination, double factor, const double *source, long length) { \
+    KernelVector_##suffix factors = (KernelVector_##suffix) { 0 } + factor; \
+    long index; \
+    for(index = 0; index + (width) <= length; index += (width)) { \
+      KernelVector_##suffix left, right; \
+      memcpy(&left, destination + index, sizeof(left)); \
+      memcpy(&right, source + index, sizeof(right)); \
+      left += factors * right; \
+      memcpy(destination + index, &left, sizeof(left)); \
+    } \
+    kernel_axpy_scalar(destination + index, factor, source + index, length - index); \
+  } \
+  \
+  __attribute__((target(isa))) static long kernel_compact_##suffix(const double *coefficients, long length, double tolerance, double *compacted, long *degrees) { \
+    KernelIntegersVector_##suffix magnitude = (KernelIntegersVector_##suffix) { 0 } + 0x7fffffffffffffffLL; \
+    KernelVector_##suffix tolerances = (KernelVector_##suffix) { 0 } + tolerance; \
+    long index, count = 0; \
+    for(index = 0; index + (width) <= length; index += (width)) { \
+      KernelVector_##suffix values; \
+      memcpy(&values, coefficients + index, sizeof(values)); \
+      KernelIntegersVector_##suffix kept = ~((KernelVector_##suffix) ((KernelIntegersVector_##suffix) values & magnitude) < tolerances); \
+      \
+      int lane, number_kept = 0; \
+      for(lane = 0; lane < (width); lane++) { \
+        number_kept += (kept[lane] != 0); \
+      } \
+      if(number_kept == (width)) { \
+        memcpy(compacted + count, &values, sizeof(values)); \
+        for(lane = 0; lane < (width); lane++) { \
+          degrees[count++] = index + lane; \
+        } \
+      } else if(number_kept > 0) { \
+        for(lane = 0; lane < (width); lane++) { \
+          if(kept[lane]) { \
+            compacted[count] = values[lane]; \
+            degrees[count++] = index + lane; \
+          } \
+        } \
+      } \
+    } \
+    \
+    long tail = kernel_compact_scalar(coefficients + index, length - index, tolerance, compacted + count, degrees + count); \
+    long last; \
+    for(last = count; last < count + tail; last++) { \
+      degrees[last] += index; \
+    } \
+    return count + tail; \
+  } \
+  \
+  __attribute__((target(isa))) static long kernel_degree_##suffix(const double *coefficients, long length, double tolerance) { \
+    KernelIntegersVector_##suffix magnitude = (KernelIntegersVector_##suffix) { 0 } + 0x7fffffffffffffffLL; \
+    KernelVector_##suffix tolerances = (KernelVector_##suffix) { 0 } + tolerance; \
+    long index; \
+    for(index = length; index >= (width); index -= (width)) { \
+      KernelVector_##suffix values; \
+      memcpy(&values, coefficients + index - (width), sizeof(values)); \
+      KernelIntegersVector_##suffix kept = ~((KernelVector_##suffix) ((KernelIntegersVector_##suffix) values & magnitude) < tolerances); \
+      \
+      int lane; \
+      for(lane = (width) - 1; lane >= 0; lane--) { \
+        if(kept[lane]) { \
+          return index - (width) + lane; \
+        } \
+      } \
+    } \
+    return kernel_degree_scalar(coefficients, index, tolerance); \
+  } \
+  \
+  __attribute__((target(isa))) static void kernel_derivative_##suffix(const double *coefficients, long length, double *result) { \
+    KernelVector_##suffix indices, step = (KernelVector_##suffix) { 0 } + (width); \
+    int lane; \
+    for(lane = 0; lane < (width); lane++) { \
+      indices[lane] = lane + 1; \
+    } \
+    long index; \
+    for(index = 0; index + (width) <= length; index += (width)) { \
+      KernelVector_##suffix values; \
+      memcpy(&values, coefficients + index + 1, sizeof(values)); \
+      values *= indices; \
+      memcpy(result + index, &values, sizeof(values)); \
+      indices += step; \
+    } \
+    for(; index < length; index++) { \
+      result[index] = coefficients[index + 1] * (double) (index + 1); \
+    } \
+  } \
+  \
+  __attribute__((target(isa))) static void kernel_scale_##suffix(double *coefficients, long length, double factor) { \
+    KernelVector_##suffix factors = (KernelVector_##suffix) { 0 } + factor; \
+    long index; \
+    for(index = 0; index + (width) <= length; index += (width)) { \
+      KernelVector_##suffix values; \
+      memcpy(&values, coefficients + index, sizeof(values)); \
+      values *= factors; \
+      memcpy(coefficients + index, &values, sizeof(values)); \
+    } \
+    kernel_scale_scalar(coefficients + index, length - index, factor); \
+  } \
+  \
+  static const CoefficientsKernels kernels_##suffix = { \
+    kernel_add_##suffix, kernel_axpy_##suffix, kernel_compact_##suffix, kernel_degree_##suffix, kernel_derivative_##suffix, kernel_scale_##suffix \
+  };
+
+DEFINE_COEFFICIENTS_KERNELS(sse2, 2, "sse2")
+DEFINE_COEFFICIENTS_KERNELS(avx2, 4, "avx2")
+DEFINE_COEFFICIENTS_KERNELS(avx512, 8, "avx512f")
+
+#endif
+
+static const CoefficientsKernels *coefficients_kernels = &kernels_scalar;
+static COEFFICIENTS_KERNELS coefficients_kernels_selected = COEFFICIENTS_KERNELS_SCALAR;
+
+
+// picks the best kernels before main, __builtin_cpu_supports reads CPUID and checks that the OS saves the registers
+__attribute__((constructor)) static void coefficients_kernels_initialize(void) {
+  coefficients_set_kernels(COEFFICIENTS_KERNELS_AUTO);
+}
+
+
+/*
+ * @function fft
+ *
+ * In-place iterative radix-2 FFT.
+ *
+ * @param size_t size
+ * Must be a power of 2.
+ *
+ * @param const double complex *roots
+ * The size / 2 first powers of exp(-2iπ / size).
+ */
+static void fft(double complex *data, size_t size, const double complex *roots, int inverse) {
+  size_t index, reversed = 0;
+
+  // bit-reversal permutation
+  for(index = 1; index < size; index++) {
+    size_t bit = size >> 1;
+    while(reversed & bit) {
+      reversed ^= bit;
+      bit >>= 1;
+    }
+    reversed |= bit;
+
+    if(index < reversed) {
+      double complex tmp = data[index];
+      data[index] = data[reversed];
+      data[reversed] = tmp;
+    }
+  }
+
+  size_t length;
+  for(length = 2; length <= size; length <<= 1) {
+    size_t half = length >> 1, stride = size / length;
+
+    size_t start;
+    for(start = 0; start < size; start += length) {
+      size_t offset;
+      for(offset = 0; offset < half; offset++) {
+        double complex root = roots[offset * stride];
+        if(inverse) {
+          root = conj(root);
+        }
+
+        double complex even = data[start + offset];
+        double complex odd = data[start + offset + half] * root;
+
+        data[start + offset] = even + odd;
+        data[start + offset + half] = even - odd;
+      }
+    }
+  }
+}
+
+
+// the size / 2 first powers of exp(-2iπ / size), for fft
+static double complex* fft_roots(size_t size) {
+  double complex *roots = coefficients_allocate(sizeof(double complex) * (size / 2 + 1));
+
+  size_t index;
+  for(index = 0; index < size / 2; index++) {
+    double angle = -2 * PI * (double) index / (double) size;
+    roots[index] = cos(angle) + sin(angle) * I;
+  }
+
+  return roots;
+}
+
+
+/*
+ * @function fft_forward
+ *
+ * @return double complex*
+ * The transform of coefficients, padded with zeros up to size. Must be freed with free after use.
+ */
+static double complex* fft_forward(const double *coefficients, long degree, size_t size, const double complex *roots) {
+  double complex *transform = coefficients_allocate(sizeof(double complex) * size);
+
+  size_t index;
+  for(index = 0; index < size; index++) {
+    transform[index] = (index <= (size_t) degree) ? coefficients[index] : 0;
+  }
+
+  fft(transform, size, roots, 0);
+
+  return transform;
+}
+
+
+// scales back an inverse FFT, rounded to integers if rounded is set, without negative zeros
+static double fft_coefficient(double value, size_t size, int rounded) {
+  value /= (double) size;
+
+  return rounded ? round(value) + 0.0 : value;
+}
+
+
+// multiplies transform by other_transform, then computes the result_degree + 1 coefficients of the product
+static void fft_product_inverse(double complex *transform, const double complex *other_transform, size_t size, const double complex *roots, long result_degree, double *result, int rounded) {
+  size_t index;
+  for(index = 0; index < size; index++) {
+    transform[index] *= other_transform[index];
+  }
+
+  fft(transform, size, roots, 1);
+
+  for(index = 0; index <= (size_t) result_degree; index++) {
+    result[index] = fft_coefficient(creal(transform[index]), size, rounded);
+  }
+}
+
+
+static size_t fft_product_size(long result_degree) {
+  size_t size = 1;
+  while(size < (size_t) (result_degree + 1)) {
+    size <<= 1;
+  }
+
+  return size;
+}
+
+
+/*
+ * @function fft_integral_norm
+ *
+ * @return double
+ * The euclidean norm of coefficients if they are all integers, -1 otherwise.
+ */
+static double fft_integral_norm(const double *coefficients, long degree) {
+  double norm = 0;
+
+  long index;
+  for(index = 0; index <= degree; index++) {
+    if(coefficients[index] != floor(coefficients[index])) {
+      return -1;
+    }
+
+    norm += coefficients[index] * coefficients[index];
+  }
+
+  return sqrt(norm);
+}
+
+
+typedef enum {
+  PRODUCT_FFT,
+  PRODUCT_FFT_ROUNDED,
+  PRODUCT_SCHOOLBOOK
+} PRODUCT_METHOD;
+
+
+/*
+ * @function fft_product_method
+ *
+ * The product of integral operands is integral, but a FFT only approximates it.
+ * When the error bound stays below 1/2, rounding the FFT to integers gives the exact product,
+ * otherwise the schoolbook product is used: products of integral operands are exact either way,
+ * and the same as polynomial_product's.
+ *
+ * @param double left_norm, right_norm
+ * Computed by fft_integral_norm.
+ */
+static PRODUCT_METHOD fft_product_method(double left_norm, double right_norm, size_t size) {
+  if(left_norm < 0 || right_norm < 0) {
+    return PRODUCT_FFT;
+  }
+
+  double levels = 1;
+  size_t level;
+  for(level = size; level > 1; level >>= 1) {
+    levels++;
+  }
+
+  return (left_norm * right_norm * levels * FFT_ERROR_FACTOR * DBL_EPSILON < 0.5) ? PRODUCT_FFT_ROUNDED : PRODUCT_SCHOOLBOOK;
+}
+
+
+static void coefficients_product_fft(const double *left, long left_degree, const double *right, long right_degree, double *result, int rounded) {
+  long result_degree = left_degree + right_degree;
+  size_t size = fft_product_size(result_degree);
+
+  double complex *roots = fft_roots(size);
+  double complex *left_transform = fft_forward(left, left_degree, size, roots);
+  double complex *right_transform = fft_forward(right, right_degree, size, roots);
+
+  fft_product_inverse(left_transform, right_transform, size, roots, result_degree, result, rounded);
+
+  free(roots);
+  free(left_transform);
+  free(right_transform);
+}
+
+
+/*
+ * @function fft_forward_halves
+ *
+ * Transforms the coefficients of degree < half as real part and those of degree half to 2 half - 1 as imaginary part,
+ * in a single FFT, then separates both transforms with the conjugate symmetry of real sequences.
+ */
+static void fft_forward_halves(const double *coefficients, long degree, long half, size_t size, const double complex *roots, double complex *low, double complex *high) {
+  size_t index;
+  for(index = 0; index < size; index++) {
+    double real = (index < (size_t) half && index <= (size_t) degree) ? coefficients[index] : 0;
+    double imaginary = (index < (size_t) half && index + half <= (size_t) degree) ? coefficients[index + half] : 0;
+    low[index] = real + imaginary * I;
+  }
+
+  fft(low, size, roots, 0);
+
+  for(index = 0; index <= size / 2; index++) {
+    size_t opposite = (size - index) & (size - 1);
+    double complex packed = low[index], opposite_packed = conj(low[opposite]);
+
+    low[index] = (packed + opposite_packed) / 2;
+    high[index] = (packed - opposite_packed) / (2 * I);
+    low[opposite] = conj(low[index]);
+    high[opposite] = conj(high[index]);
+  }
+}
+
+
+/*
+ * @function coefficients_product_low_fft
+ *
+ * The operands are split into halves of half = ceil(order / 2) coefficients, l + x^half u and r + x^half v:
+ * the product mod x^order is l r + x^half (l v + u r), u v never contributes.
+ * Both l r and l v + u r have a degree < 2 half - 1, so that cyclic convolutions of about order coefficients compute them,
+ * instead of 2 order for the full product. Each operand is transformed by a single FFT, see fft_forward_halves,
+ * and both products are transformed back together, l r as real part and l v + u r as imaginary part:
+ * three FFTs of about order coefficients in all.
+ */
+static void coefficients_product_low_fft(const double *left, long left_degree, const double *right, long right_degree, double *result, long order, size_t size, int rounded) {
+  long half = (order + 1) / 2;
+
+  double complex *roots = fft_roots(size);
+  double complex *transforms = coefficients_allocate(sizeof(double complex) * 4 * size);
+  double complex *left_low = transforms, *left_high = transforms + size;
+  double complex *right_low = transforms + 2 * size, *right_high = transforms + 3 * size;
+
+  fft_forward_halves(left, left_degree, half, size, roots, left_low, left_high);
+  fft_forward_halves(right, right_degree, half, size, roots, right_low, right_high);
+
+  size_t index;
+  for(index = 0; index < size; index++) {
+    left_low[index] = left_low[index] * right_low[index] + (left_low[index] * right_high[index] + left_high[index] * right_low[index]) * I;
+  }
+
+  fft(left_low, size, roots, 1);
+
+  long degree;
+  for(degree = 0; degree < order; degree++) {
+    double value = (degree < 2 * half - 1) ? creal(left_low[degree]) : 0;
+    if(degree >= half) {
+      value += cimag(left_low[degree - half]);
+    }
+
+    result[degree] = fft_coefficient(value, size, rounded);
+  }
+
+  free(roots);
+  free(transforms);
+}
+
+
+void coefficients_product(const double *left, long left_degree, const double *right, long right_degree, double *result) {
+  assert(left != NULL);
+  assert(right != NULL);
+  assert(result != NULL);
+  assert(left_degree >= 0 && right_degree >= 0);
+
+  long smallest_degree = (left_degree < right_degree) ? left_degree : right_degree;
+  if(smallest_degree >= PRODUCT_SCHOOLBOOK_THRESHOLD) {
+    size_t size = fft_product_size(left_degree + right_degree);
+    PRODUCT_METHOD method = fft_product_method(fft_integral_norm(left, left_degree), fft_integral_norm(right, right_degree), size);
+    if(method != PRODUCT_SCHOOLBOOK) {
+      coefficients_product_fft(left, left_degree, right, right_degree, result, method == PRODUCT_FFT_ROUNDED);
+      return;
+    }
+  }
+
+  long index_left;
+  for(index_left = 0; index_left <= left_degree + right_degree; index_left++) {
+    result[index_left] = 0;
+  }
+
+  for(index_left = 0; index_left <= left_degree; index_left++) {
+    double coefficient = left[index_left];
+    if(coefficient == 0) {
+      continue;
+    }
+
+    coefficients_axpy(result + index_left, coefficient, right, right_degree);
+  }
+}
+
+
+void coefficients_product_low(const double *left, long left_degree, const double *right, long right_degree, double *result, long order) {
+  assert(left != NULL);
+  assert(right != NULL);
+  assert(result != NULL);
+  assert(order > 0);
+
+  // terms of degree >= order can't contribute
+  if(left_degree >= order) {
+    left_degree = order - 1;
+  }
+
+  if(right_degree >= order) {
+    right_degree = order - 1;
+  }
+
+  long index_left;
+  long smallest_degree = (left_degree < right_degree) ? left_degree : right_degree;
+
+  if(smallest_degree >= PRODUCT_SCHOOLBOOK_THRESHOLD) {
+    if(left_degree + right_degree < order) {
+      // nothing to truncate
+      coefficients_product(left, left_degree, right, right_degree, result);
+      for(index_left = left_degree + right_degree + 1; index_left < order; index_left++) {
+        result[index_left] = 0;
+      }
+
+      return;
+    }
+
+    size_t size = fft_product_size(2 * ((order + 1) / 2) - 2);
+    PRODUCT_METHOD method = fft_product_method(fft_integral_norm(left, left_degree), fft_integral_norm(right, right_degree), size);
+    if(method != PRODUCT_SCHOOLBOOK) {
+      coefficients_product_low_fft(left, left_degree, right, right_degree, result, order, size, method == PRODUCT_FFT_ROUNDED);
+      return;
+    }
+  }
+
+  for(index_left = 0; index_left < order; index_left++) {
+    result[index_left] = 0;
+  }
+
+  for(index_left = 0; index_left <= left_degree; index_left++) {
+    double coefficient = left[index_left];
+    if(coefficient == 0) {
+      continue;
+    }
+
+    long last_right = order - 1 - index_left;
+    if(last_right > right_degree) {
+      last_right = right_degree;
+    }
+
+    coefficients_axpy(result + index_left, coefficient, right, last_right);
+  }
+}
+
+
+/*
+ * The transform of a prepared operand for one size of FFT, with the roots of that size.
+ * Transforms are computed on first use, and published with an atomic compare-and-swap:
+ * threads computing the same one at once keep the first, and free theirs.
+ */
+typedef struct {
+  double complex *roots;
+  double complex *transform;
+} CoefficientsTransform;
+
+struct CoefficientsPrepared {
+  double *coefficients;
+  long degree;
+  double integral_norm; // see fft_integral_norm
+  CoefficientsTransform *transforms[sizeof(size_t) * CHAR_BIT]; // by log2 of the size
+};
+
+
+CoefficientsPrepared* coefficients_prepare(const double *coefficients, long degree) {
+  assert(coefficients != NULL);
+  assert(degree >= 0);
+
+  CoefficientsPrepared *prepared = coefficients_allocate(sizeof(CoefficientsPrepared));
+  prepared->coefficients = coefficients_allocate(sizeof(double) * (degree + 1));
+  memcpy(prepared->coefficients, coefficients, sizeof(double) * (degree + 1));
+  prepared->degree = degree;
+  prepared->integral_norm = fft_integral_norm(coefficients, degree);
+  memset(prepared->transforms, 0, sizeof(prepared->transforms));
+
+  return prepared;
+}
+
+
+void coefficients_prepared_free(CoefficientsPrepared **prepared) {
+  assert(prepared != NULL);
+  assert(*prepared != NULL);
+
+  size_t level;
+  for(level = 0; level < sizeof((*prepared)->transforms) / sizeof((*prepared)->transforms[0]); level++) {
+    CoefficientsTransform *transform = (*prepared)->transforms[level];
+    if(transform != NULL) {
+      free(transform->roots);
+      free(transform->transform);
+      free(transform);
+    }
+  }
+
+  free((*prepared)->coefficients);
+  free(*prepared);
+
+  *prepared = NULL;
+}
+
+
+static const CoefficientsTransform* coefficients_prepared_transform(CoefficientsPrepared *prepared, size_t size) {
+  size_t level = 0;
+  while(((size_t) 1 << level) < size) {
+    level++;
+  }
+
+  CoefficientsTransform *transform = __atomic_load_n(&prepared->transforms[level], __ATOMIC_ACQUIRE);
+  if(transform != NULL) {
+    return transform;
+  }
+
+  transform = coefficients_allocate(sizeof(CoefficientsTransform));
+  transform->roots = fft_roots(size);
+  transform->transform = fft_forward(prepared->coefficients, prepared->degree, size, transform->roots);
+
+  CoefficientsTransform *expected = NULL;
+  if(!__atomic_compare_exchange_n(&prepared->transforms[level], &expected, transform, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    free(transform->roots);
+    free(transform->transform);
+    free(transform);
+    transform = expected;
+  }
+
+  return transform;
+}
+
+
+void coefficients_product_prepared(CoefficientsPrepared *prepared, const double *other, long other_degree, double *result) {
+  assert(prepared != NULL);
+  assert(other != NULL);
+  assert(result != NULL);
+  assert(other_degree >= 0);
+
+  // the same choices as coefficients_product
+  long result_degree = prepared->degree + other_degree;
+  size_t size = fft_product_size(result_degree);
+  long smallest_degree = (prepared->degree < other_degree) ? prepared->degree : other_degree;
+  PRODUCT_METHOD method = (smallest_degree < PRODUCT_SCHOOLBOOK_THRESHOLD) ? PRODUCT_SCHOOLBOOK
+    : fft_product_method(prepared->integral_norm, fft_integral_norm(other, other_degree), size);
+
+  if(method == PRODUCT_SCHOOLBOOK) {
+    coefficients_product(prepared->coefficients, prepared->degree, other, other_degree, result);
+    return;
+  }
+
+  // the transform of prepared and the roots are reused: only two FFTs are left, instead of three
+  const CoefficientsTransform *transform = coefficients_prepared_transform(prepared, size);
+
+  double complex *other_transform = fft_forward(other, other_degree, size, transform->roots);
+  fft_product_inverse(other_transform, transform->transform, size, transform->roots, result_degree, result, method == PRODUCT_FFT_ROUNDED);
+
+  free(other_transform);
+}
+
+
+void coefficients_remainder(double *dividend, long dividend_degree, const double *divisor, long divisor_degree) {
+  assert(dividend != NULL);
+  assert(divisor != NULL);
+  assert(divisor[divisor_degree] != 0);
+
+  double leading = divisor[divisor_degree];
+
+  long index_dividend;
+  for(index_dividend = dividend_degree; index_dividend >= divisor_degree; index_dividend--) {
+    double quotient = dividend[index_dividend] / leading;
+    if(quotient == 0) {
+      continue;
+    }
+
+    if(divisor_degree > 0) {
+      coefficients_axpy(dividend + index_dividend - divisor_degree, -quotient, divisor, divisor_degree - 1);
+    }
+    dividend[index_dividend] = 0;
+  }
+}
+
+
+/*
+ * @function coefficients_compose_recursive
+ *
+ * Composes the length first coefficients of p with q.
+ *
+ * @param double **powers
+ * powers[k] holds q^(2^k), of degree q_degree * 2^k.
+ */
+static void coefficients_compose_recursive(const double *p, long length, const double *q, long q_degree, double **powers, double *result) {
+  long index;
+
+  if(length <= COMPOSE_HORNER_THRESHOLD) {
+    // Horner: result = (((p[n] * q) + p[n - 1]) * q + ...) + p[0]
+    double *tmp = coefficients_allocate(sizeof(double) * ((length - 1) * q_degree + 1));
+
+    long result_degree = 0;
+    result[0] = p[length - 1];
+
+    for(index = length - 2; index >= 0; index--) {
+      coefficients_product(result, result_degree, q, q_degree, tmp);
+      result_degree += q_degree;
+
+      memcpy(result, tmp, sizeof(double) * (result_degree + 1));
+      result[0] += p[index];
+    }
+
+    free(tmp);
+    return;
+  }
+
+  // half is the biggest power of 2 strictly smaller than length
+  long half = 1;
+  int level = 0;
+  while(half * 2 < length) {
+    half *= 2;
+    level++;
+  }
+
+  long low_degree = (half - 1) * q_degree;
+  long high_degree = (length - half - 1) * q_degree;
+  long power_degree = half * q_degree;
+
+  double *high = coefficients_allocate(sizeof(double) * (high_degree + 1));
+
+  coefficients_compose_recursive(p, half, q, q_degree, powers, result);
+  coefficients_compose_recursive(p + half, length - half, q, q_degree, powers, high);
+
+  double *high_product = coefficients_allocate(sizeof(double) * (high_degree + power_degree + 1));
+  coefficients_product(high, high_degree, powers[level], power_degree, high_product);
+
+  for(index = 0; index <= high_degree + power_degree; index++) {
+    result[index] = ((index <= low_degree) ? result[index] : 0) + high_product[index];
+  }
+
+  free(high);
+  free(high_product);
+}
+
+
+void coefficients_compose(const double *p, long p_degree, const double *q, long q_degree, double *result) {
+  assert(p != NULL);
+  assert(q != NULL);
+  assert(result != NULL);
+
+  if(q_degree == 0) {
+    // p(constant) is a constant
+    double value = 0;
+    long index;
+    for(index = p_degree; index >= 0; index--) {
+      value = value * q[0] + p[index];
+    }
+
+    result[0] = value;
+    return;
+  }
+
+  // powers[k] = q^(2^k), as long as 2^k < p_degree + 1
+  int number_of_powers = 1;
+  while(((long) 1 << number_of_powers) < p_degree + 1) {
+    number_of_powers++;
+  }
+
+  double **powers = coefficients_allocate(sizeof(double*) * number_of_powers);
+  powers[0] = coefficients_allocate(sizeof(double) * (q_degree + 1));
+  memcpy(powers[0], q, sizeof(double) * (q_degree + 1));
+
+  int level;
+  for(level = 1; level < number_of_powers; level++) {
+    long previous_degree = q_degree << (level - 1);
+    powers[level] = coefficients_allocate(sizeof(double) * (2 * previous_degree + 1));
+    coefficients_product(powers[level - 1], previous_degree, powers[level - 1], previous_degree, powers[level]);
+  }
+
+  coefficients_compose_recursive(p, p_degree + 1, q, q_degree, powers, result);
+
+  for(level = 0; level < number_of_powers; level++) {
+    free(powers[level]);
+  }
+  free(powers);
+}
+
+
+/*
+ * @function coefficients_product_modulo
+ *
+ * result = left * right mod r, where left and right have r_degree coefficients.
+ *
+ * @param double *tmp
+ * A buffer of at least 2 * r_degree - 1 doubles.
+ */
+static void coefficients_product_modulo(const double *left, const double *right, const double *r, long r_degree, double *tmp, double *result) {
+  coefficients_product(left, r_degree - 1, right, r_degree - 1, tmp);
+  coefficients_remainder(tmp, 2 * r_degree - 2, r, r_degree);
+  memcpy(result, tmp, sizeof(double) * r_degree);
+}
+
+
+void coefficients_compose_modulo(const double *p, long p_degree, const double *q, long q_degree, const double *r, long r_degree, double *result) {
+  assert(p != NULL);
+  assert(q != NULL);
+  assert(r != NULL);
+  assert(result != NULL);
+  assert(r[r_degree] != 0);
+
+  if(r_degree == 0) {
+    // everything is null modulo a constant
+    return;
+  }
+
+  long index, step;
+
+  // baby steps: q^0, q^1, ..., q^steps mod r
+  long steps = (long) ceil(sqrt((double) (p_degree + 1)));
+
+  double *tmp = coefficients_allocate(sizeof(double) * (2 * r_degree - 1 > q_degree + 1 ? 2 * r_degree - 1 : q_degree + 1));
+  double *baby_steps = coefficients_allocate(sizeof(double) * r_degree * (steps + 1));
+  memset(baby_steps, 0, sizeof(double) * r_degree * (steps + 1));
+
+  baby_steps[0] = 1;
+
+  memcpy(tmp, q, sizeof(double) * (q_degree + 1));
+  coefficients_remainder(tmp, q_degree, r, r_degree);
+  memcpy(baby_steps + r_degree, tmp, sizeof(double) * (q_degree < r_degree ? q_degree + 1 : r_degree));
+
+  for(step = 2; step <= steps; step++) {
+    coefficients_product_modulo(baby_steps + (step - 1) * r_degree, baby_steps + r_degree, r, r_degree, tmp, baby_steps + step * r_degree);
+  }
+
+  // giant steps: Horner in q^steps over the blocks of steps coefficients of p
+  const double *giant_step = baby_steps + steps * r_degree;
+  double *block = coefficients_allocate(sizeof(double) * r_degree);
+
+  for(index = 0; index < r_degree; index++) {
+    result[index] = 0;
+  }
+
+  long block_start = (p_degree / steps) * steps;
+  for(; block_start >= 0; block_start -= steps) {
+    coefficients_product_modulo(result, giant_step, r, r_degree, tmp, result);
+
+    for(index = 0; index < r_degree; index++) {
+      block[index] = 0;
+    }
+
+    for(step = 0; step < steps && block_start + step <= p_degree; step++) {
+      double coefficient = p[block_start + step];
+      for(index = 0; index < r_degree; index++) {
+        block[index] += coefficient * baby_steps[step * r_degree + index];
+      }
+    }
+
+    for(index = 0; index < r_degree; index++) {
+      result[index] += block[index];
+    }
+  }
+
+  free(tmp);
+  free(block);
+  free(baby_steps);
+}
+
+
+/*
+ * @function dft
+ *
+ * In-place forward discrete Fourier transform of any size.
+ * Powers of 2 go straight to fft, other sizes are turned into a convolution of size a power of 2
+ * by Bluestein's algorithm: jk = (j^2 + k^2 - (k - j)^2) / 2.
+ */
+static void dft(double complex *data, size_t size) {
+  size_t length = 1;
+  while(length < size) {
+    length <<= 1;
+  }
+
+  if(length == size) {
+    double complex *roots = fft_roots(size);
+    fft(data, size, roots, 0);
+    free(roots);
+    return;
+  }
+
+  while(length < 2 * size - 1) {
+    length <<= 1;
+  }
+
+  double complex *roots = fft_roots(length);
+  double complex *chirp = coefficients_allocate(sizeof(double complex) * size);
+  double complex *signal = coefficients_allocate(sizeof(double complex) * length);
+  double complex *filter = coefficients_allocate(sizeof(double complex) * length);
+
+  size_t index;
+  for(index = 0; index < size; index++) {
+    // j^2 modulo 2 * size keeps the angle small, and accurate
+    double angle = -PI * (double) ((index * index) % (2 * size)) / (double) size;
+    chirp[index] = cos(angle) + sin(angle) * I;
+  }
+
+  for(index = 0; index < length; index++) {
+    signal[index] = (index < size) ? data[index] * chirp[index] : 0;
+    filter[index] = 0;
+  }
+
+  filter[0] = conj(chirp[0]);
+  for(index = 1; index < size; index++) {
+    filter[index] = filter[length - index] = conj(chirp[index]);
+  }
+
+  fft(signal, length, roots, 0);
+  fft(filter, length, roots, 0);
+
+  for(index = 0; index < length; index++) {
+    signal[index] *= filter[index];
+  }
+
+  fft(signal, length, roots, 1);
+
+  for(index = 0; index < size; index++) {
+    data[index] = chirp[index] * signal[index] / (double) length;
+  }
+
+  free(roots);
+  free(chirp);
+  free(signal);
+  free(filter);
+}
+
+
+/*
+ * @function dct
+ *
+ * In-place type I discrete cosine transform, through the dft of the even extension of data:
+ * data[k] becomes data[0] + (-1)^k data[degree] + 2 * sum of data[j] cos(π jk / degree) for 0 < j < degree.
+ * degree must be > 0.
+ */
+static void dct(double *data, long degree) {
+  size_t size = 2 * (size_t) degree;
+  double complex *extended = coefficients_allocate(sizeof(double complex) * size);
+
+  long index;
+  for(index = 0; index <= degree; index++) {
+    extended[index] = data[index];
+  }
+  for(index = 1; index < degree; index++) {
+    extended[size - index] = data[index];
+  }
+
+  dft(extended, size);
+
+  for(index = 0; index <= degree; index++) {
+    data[index] = creal(extended[index]);
+  }
+
+  free(extended);
+}
+
+
+void coefficients_chebyshev_nodes(long degree, double *nodes) {
+  assert(nodes != NULL);
+  assert(degree >= 0);
+
+  if(degree == 0) {
+    nodes[0] = 1;
+    return;
+  }
+
+  // cos(π j / degree), written as a sine so that nodes[j] = -nodes[degree - j] exactly
+  long index;
+  for(index = 0; index <= degree; index++) {
+    nodes[index] = sin(PI * (double) (degree - 2 * index) / (double) (2 * degree));
+  }
+}
+
+
+void coefficients_chebyshev_interpolate(const double *values, long degree, double *chebyshev) {
+  assert(values != NULL);
+  assert(chebyshev != NULL);
+  assert(degree >= 0);
+
+  memmove(chebyshev, values, sizeof(double) * (degree + 1));
+  if(degree == 0) {
+    return;
+  }
+
+  dct(chebyshev, degree);
+
+  long index;
+  for(index = 0; index <= degree; index++) {
+    chebyshev[index] /= (double) degree;
+  }
+  chebyshev[0] /= 2;
+  chebyshev[degree] /= 2;
+}
+
+
+void coefficients_chebyshev_values(const double *chebyshev, long degree, double *values) {
+  assert(chebyshev != NULL);
+  assert(values != NULL);
+  assert(degree >= 0);
+
+  memmove(values, chebyshev, sizeof(double) * (degree + 1));
+  if(degree == 0) {
+    return;
+  }
+
+  values[0] *= 2;
+  values[degree] *= 2;
+  dct(values, degree);
+
+  coefficients_scale(values, degree, 0.5);
+}
+
+
+/*
+ * @function coefficients_chebyshev_product
+ *
+ * Product of two Chebyshev series, with T_i T_j = (T_(i + j) + T_|i - j|) / 2:
+ * the first terms are a usual product, the second ones are two correlations,
+ * which are products with the operands reversed.
+ *
+ * @param double *result
+ * Its length must be at least left_degree + right_degree + 1. It may not overlap left or right.
+ */
+static void coefficients_chebyshev_product(const double *left, long left_degree, const double *right, long right_degree, double *result) {
+  long degree = left_degree + right_degree;
+  double *reversed = coefficients_allocate(sizeof(double) * (degree + 1));
+  double *correlation = coefficients_allocate(sizeof(double) * (degree + 1));
+
+  coefficients_product(left, left_degree, right, right_degree, result);
+
+  // sum of left[j + k] * right[j] is the coefficient of x^(left_degree - k) of reversed left * right
+  long index;
+  for(index = 0; index <= left_degree; index++) {
+    reversed[index] = left[left_degree - index];
+  }
+  coefficients_product(reversed, left_degree, right, right_degree, correlation);
+  for(index = 0; index <= left_degree; index++) {
+    result[index] += correlation[left_degree - index];
+  }
+
+  // and the other way around, T_0 being counted only once
+  for(index = 0; index <= right_degree; index++) {
+    reversed[index] = right[right_degree - index];
+  }
+  coefficients_product(reversed, right_degree, left, left_degree, correlation);
+  for(index = 1; index <= right_degree; index++) {
+    result[index] += correlation[right_degree - index];
+  }
+
+  for(index = 0; index <= degree; index++) {
+    result[index] /= 2;
+  }
+
+  free(reversed);
+  free(correlation);
+}
+
+
+// the Horner method in the Chebyshev basis, with x T_0 = T_1 and x T_k = (T_(k + 1) + T_(k - 1)) / 2
+static void coefficients_chebyshev_from_monomial_horner(const double *monomial, long degree, double *chebyshev) {
+  double *tmp = coefficients_allocate(sizeof(double) * (degree + 1));
+
+  long step, index;
+  for(index = 0; index <= degree; index++) {
+    chebyshev[index] = 0;
+  }
+  chebyshev[0] = monomial[degree];
+
+  for(step = 1; step <= degree; step++) {
+    for(index = 0; index <= step; index++) {
+      tmp[index] = 0;
+    }
+
+    tmp[1] = chebyshev[0];
+    for(index = 1; index < step; index++) {
+      tmp[index - 1] += chebyshev[index] / 2;
+      tmp[index + 1] += chebyshev[index] / 2;
+    }
+
+    tmp[0] += monomial[degree - step];
+    memcpy(chebyshev, tmp, sizeof(double) * (step + 1));
+  }
+
+  free(tmp);
+}
+
+
+void coefficients_chebyshev_from_monomial(const double *monomial, long degree, double *chebyshev) {
+  assert(monomial != NULL);
+  assert(chebyshev != NULL);
+  assert(degree >= 0);
+
+  if(degree < CHEBYSHEV_CONVERSION_THRESHOLD) {
+    coefficients_chebyshev_from_monomial_horner(monomial, degree, chebyshev);
+    return;
+  }
+
+  // p = low + x^half * high, with x^half = 2^(1 - half) * sum of C(half, m) T_(half - 2m), the T_0 term halved
+  long half = (degree + 1) / 2;
+
+  double *high = coefficients_allocate(sizeof(double) * (degree - half + 1));
+  double *power = coefficients_allocate(sizeof(double) * (half + 1));
+  double *product = coefficients_allocate(sizeof(double) * (degree + 1));
+
+  coefficients_chebyshev_from_monomial(monomial, half - 1, chebyshev);
+  coefficients_chebyshev_from_monomial(monomial + half, degree - half, high);
+
+  /*
+   * The binomial coefficients are computed from the middle one outwards, where they only decrease,
+   * then normalized by their sum, since x^half = 1 at x = 1 = T_k(1).
+   */
+  long index;
+  for(index = 0; index <= half; index++) {
+    power[index] = 0;
+  }
+
+  double binomial = 1, sum = 0;
+  long m;
+  for(m = half / 2; m >= 0; m--) {
+    power[half - 2 * m] = (half - 2 * m == 0) ? binomial : 2 * binomial;
+    sum += power[half - 2 * m];
+    binomial *= (double) m / (double) (half - m + 1);
+  }
+  for(index = 0; index <= half; index++) {
+    power[index] /= sum;
+  }
+
+  coefficients_chebyshev_product(power, half, high, degree - half, product);
+
+  for(index = 0; index <= degree; index++) {
+    chebyshev[index] = ((index < half) ? chebyshev[index] : 0) + product[index];
+  }
+
+  free(high);
+  free(power);
+  free(product);
+}
+
+
+// the recurrence T_(k + 1) = 2x T_k - T_(k - 1), on monomial coefficients
+static void coefficients_chebyshev_to_monomial_recurrence(const double *chebyshev, long degree, double *monomial) {
+  double *previous = coefficients_allocate(sizeof(double) * (degree + 2));
+  double *current = coefficients_allocate(sizeof(double) * (degree + 2));
+
+  long step, index;
+  for(index = 0; index <= degree + 1; index++) {
+    previous[index] = current[index] = 0;
+    if(index <= degree) {
+      monomial[index] = 0;
+    }
+  }
+
+  // previous = T_(step - 1), current = T_step
+  current[0] = 1;
+  for(step = 0; step <= degree; step++) {
+    for(index = 0; index <= step; index++) {
+      monomial[index] += chebyshev[step] * current[index];
+    }
+
+    for(index = step + 1; index > 0; index--) {
+      double next = ((step == 0) ? 1 : 2) * current[index - 1] - previous[index];
+      previous[index] = current[index];
+      current[index] = next;
+    }
+    double next = -previous[0];
+    previous[0] = current[0];
+    current[0] = next;
+  }
+
+  free(previous);
+  free(current);
+}
+
+
+int coefficients_chebyshev_to_monomial(const double *chebyshev, long degree, double *monomial) {
+  assert(chebyshev != NULL);
+  assert(monomial != NULL);
+  assert(degree >= 0);
+
+  if(degree > COEFFICIENTS_CHEBYSHEV_MAX_DEGREE) {
+    return 0;
+  }
+
+  if(degree < CHEBYSHEV_CONVERSION_THRESHOLD) {
+    coefficients_chebyshev_to_monomial_recurrence(chebyshev, degree, monomial);
+    return 1;
+  }
+
+  /*
+   * With T_(half + j) = 2 T_half T_j - T_(half - j) for j <= half,
+   * p = low + 2 T_half * high, where low has degree half and high degree - half.
+   */
+  long half = (degree + 1) / 2;
+
+  double *low = coefficients_allocate(sizeof(double) * (half + 1));
+  double *high = coefficients_allocate(sizeof(double) * (degree - half + 1));
+  double *low_monomial = coefficients_allocate(sizeof(double) * (half + 1));
+  double *high_monomial = coefficients_allocate(sizeof(double) * (degree - half + 1));
+  double *chebyshev_half = coefficients_allocate(sizeof(double) * (half + 1));
+
+  long index;
+  for(index = 0; index < half; index++) {
+    low[index] = chebyshev[index];
+  }
+  low[half] = 0;
+
+  for(index = 0; index <= degree - half; index++) {
+    low[half - index] -= chebyshev[half + index];
+    high[index] = 2 * chebyshev[half + index];
+  }
+
+  coefficients_chebyshev_to_monomial(low, half, low_monomial);
+  coefficients_chebyshev_to_monomial(high, degree - half, high_monomial);
+
+  // T_half = sum of t_k x^(half - 2k), t_0 = 2^(half - 1), t_(k + 1) / t_k = -(half - 2k)(half - 2k - 1) / (4 (k + 1)(half - k - 1))
+  for(index = 0; index <= half; index++) {
+    chebyshev_half[index] = 0;
+  }
+
+  double term = ldexp(1, (int) half - 1);
+  long k;
+  for(k = 0; 2 * k <= half; k++) {
+    chebyshev_half[half - 2 * k] = term;
+    if(half - k - 1 > 0) {
+      term *= -(double) ((half - 2 * k) * (half - 2 * k - 1)) / (double) (4 * (k + 1) * (half - k - 1));
+    }
+  }
+
+  coefficients_product(chebyshev_half, half, high_monomial, degree - half, monomial);
+
+  for(index = 0; index <= half; index++) {
+    monomial[index] += low_monomial[index];
+  }
+
+  free(low);
+  free(high);
+  free(low_monomial);
+  free(high_monomial);
+  free(chebyshev_half);
+
+  return 1;
+}
+
+
+static inline unsigned long long fingerprint_reduce(unsigned __int128 x) {
+  // 2^61 = 1 modulo 2^61 - 1: fold the high bits onto the low ones
+  unsigned long long folded = (unsigned long long) (x & COEFFICIENTS_FINGERPRINT_PRIME) + (unsigned long long) (x >> 61);
+  folded = (folded & COEFFICIENTS_FINGERPRINT_PRIME) + (folded >> 61);
+  return (folded >= COEFFICIENTS_FINGERPRINT_PRIME) ? folded - COEFFICIENTS_FINGERPRINT_PRIME : folded;
+}
+
+
+static inline unsigned long long fingerprint_product(unsigned long long left, unsigned long long right) {
+  return fingerprint_reduce((unsigned __int128) left * right);
+}
+
+
+static int fingerprint_residue(double coefficient, unsigned long long *residue) {
+  if(coefficient != floor(coefficient) || fabs(coefficient) >= 9223372036854775808.0) {
+    return 0;
+  }
+
+  long long value = (long long) coefficient;
+  unsigned long long magnitude = (value < 0) ? -(unsigned long long) value : (unsigned long long) value;
+  magnitude %= COEFFICIENTS_FINGERPRINT_PRIME;
+
+  *residue = (value < 0 && magnitude != 0) ? COEFFICIENTS_FINGERPRINT_PRIME - magnitude : magnitude;
+  return 1;
+}
+
+
+int coefficients_fingerprint(const double *coefficients, long degree, unsigned long long point, unsigned long long *fingerprint) {
+  assert(coefficients != NULL);
+  assert(fingerprint != NULL);
+
+  point %= COEFFICIENTS_FINGERPRINT_PRIME;
+
+  unsigned long long value = 0;
+  long index;
+  for(index = degree; index >= 0; index--) {
+    unsigned long long residue;
+    if(!fingerprint_residue(coefficients[index], &residue)) {
+      return 0;
+    }
+
+    value = fingerprint_product(value, point) + residue;
+    if(value >= COEFFICIENTS_FINGERPRINT_PRIME) {
+      value -= COEFFICIENTS_FINGERPRINT_PRIME;
+    }
+  }
+
+  *fingerprint = value;
+  return 1;
+}
+
+
+unsigned long long coefficients_fingerprint_bits(const double *coefficients, long degree, unsigned long long point, unsigned long long value) {
+  assert(coefficients != NULL || degree < 0);
+
+  point %= COEFFICIENTS_FINGERPRINT_PRIME;
+
+  long index;
+  for(index = degree; index >= 0; index--) {
+    unsigned long long bits;
+    memcpy(&bits, &coefficients[index], sizeof(bits));
+
+    value = fingerprint_product(value, point) + bits % COEFFICIENTS_FINGERPRINT_PRIME;
+    if(value >= COEFFICIENTS_FINGERPRINT_PRIME) {
+      value -= COEFFICIENTS_FINGERPRINT_PRIME;
+    }
+  }
+
+  return value;
+}
+
+
+int coefficients_fingerprint_term(long degree, double coefficient, unsigned long long point, unsigned long long *fingerprint) {
+  assert(fingerprint != NULL);
+
+  unsigned long long residue;
+  if(!fingerprint_residue(coefficient, &residue)) {
+    return 0;
+  }
+
+  // residue * point^degree, by binary exponentiation
+  unsigned long long base = point % COEFFICIENTS_FINGERPRINT_PRIME;
+  unsigned long long value = residue;
+  while(degree > 0) {
+    if(degree & 1) {
+      value = fingerprint_product(value, base);
+    }
+    base = fingerprint_product(base, base);
+    degree >>= 1;
+  }
+
+  *fingerprint = value;
+  return 1;
+}
+
+
+// the finalizer of splitmix64: every bit of x affects every bit of the result
+static inline unsigned long long hash_mix(unsigned long long x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+
+static inline HashVector hash_mix_vector(HashVector x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+
+unsigned long long coefficients_hash(const double *coefficients, long degree, double tolerance) {
+  assert(coefficients != NULL);
+
+  HashVector sums = { 0 };
+  HashVector degrees;
+  unsigned int lane;
+  for(lane = 0; lane < HASH_WIDTH; lane++) {
+    degrees[lane] = lane + HASH_DEGREE_SEED;
+  }
+
+  /*
+   * The same computation as coefficients_hash_term, on HASH_WIDTH terms at once.
+   * Null terms are masked out instead of skipped, so that there is no branch.
+   */
+  long length = degree + 1, index = 0;
+  for(; index + HASH_WIDTH <= length; index += HASH_WIDTH) {
+    HashCoefficientsVector values;
+    memcpy(&values, coefficients + index, sizeof(values));
+
+    HashVector bits;
+    HashIntegersVector non_null;
+    if(tolerance > 0) {
+      HashCoefficientsVector quotients = values / tolerance;
+
+      // copysign(0.5, quotients), so that the conversion rounds to the nearest integer
+      HashVector signs = ((HashVector) quotients & DOUBLE_SIGN_BIT) | DOUBLE_ONE_HALF_BITS;
+      HashIntegersVector rounded = __builtin_convertvector(quotients + (HashCoefficientsVector) signs, HashIntegersVector);
+
+      non_null = (rounded != 0);
+      bits = (HashVector) rounded;
+    } else {
+      non_null = (values != 0);
+      bits = (HashVector) values;
+    }
+
+    sums += hash_mix_vector(bits ^ hash_mix_vector(degrees)) & (HashVector) non_null;
+    degrees += HASH_WIDTH;
+  }
+
+  unsigned long long hash = 0;
+  for(lane = 0; lane < HASH_WIDTH; lane++) {
+    hash += sums[lane];
+  }
+
+  for(; index < length; index++) {
+    hash += coefficients_hash_term(index, coefficients[index], tolerance);
+  }
+
+  return hash;
+}
+
+
+unsigned long long coefficients_hash_term(long degree, double coefficient, double tolerance) {
+  unsigned long long bits;
+
+  if(tolerance > 0) {
+    double quotient = coefficient / tolerance;
+    long long rounded = (long long) (quotient + copysign(0.5, quotient));
+    if(rounded == 0) {
+      return 0;
+    }
+    bits = (unsigned long long) rounded;
+  } else {
+    if(coefficient == 0) {
+      return 0;
+    }
+    memcpy(&bits, &coefficient, sizeof(bits));
+  }
+
+  return hash_mix(bits ^ hash_mix((unsigned long long) degree + HASH_DEGREE_SEED));
+}
+
+
+/*
+ * Error-free transformations: a + b = sum + error and a * b = product + error exactly,
+ * where sum and product are the rounded results.
+ * Without a hardware FMA, a product is split into halves of 26 bits, whose products are exact (Dekker).
+ * The split overflows for |a| > 2^996.
+ */
+#define DEFINE_TWO_SUM_FUNCTION(name, type) \
+  static inline type name(type a, type b, type *error) { \
+    type sum = a + b; \
+    type b_virtual = sum - a; \
+    *error = (a - (sum - b_virtual)) + (b - b_virtual); \
+    return sum; \
+  }
+
+#define DEFINE_SPLIT_FUNCTION(name, type) \
+  static inline void name(type a, type *high, type *low) { \
+    type c = HORNER_SPLIT_FACTOR * a; \
+    *high = c - (c - a); \
+    *low = a - *high; \
+  }
+
+#define DEFINE_TWO_PRODUCT_FUNCTION(name, type, split) \
+  static inline type name(type a, type b, type *error) { \
+    type product = a * b; \
+    type a_high, a_low, b_high, b_low; \
+    split(a, &a_high, &a_low); \
+    split(b, &b_high, &b_low); \
+    *error = ((a_high * b_high - product) + a_high * b_low + a_low * b_high) + a_low * b_low; \
+    return product; \
+  }
+
+DEFINE_TWO_SUM_FUNCTION(two_sum, double)
+DEFINE_TWO_SUM_FUNCTION(two_sum_vector, HornerVector)
+DEFINE_SPLIT_FUNCTION(split_vector, HornerVector)
+DEFINE_TWO_PRODUCT_FUNCTION(two_product_vector, HornerVector, split_vector)
+
+#ifdef FP_FAST_FMA
+static inline double two_product(double a, double b, double *error) {
+  double product = a * b;
+  *error = fma(a, b, -product);
+  return product;
+}
+#else
+DEFINE_SPLIT_FUNCTION(split, double)
+DEFINE_TWO_PRODUCT_FUNCTION(two_product, double, split)
+#endif
+
+
+static inline HornerVector horner_absolute_vector(HornerVector x) {
+  HornerIntegersVector mask = (HornerIntegersVector) {0} + (long long) ~DOUBLE_SIGN_BIT;
+  return (HornerVector) ((HornerIntegersVector) x & mask);
+}
+
+
+/*
+ * The error bound of Langlois and Louvet: with u the unit roundoff and γ_k = ku / (1 - ku),
+ * |result - p(x)| <= (u |result| + (γ_(4n + 2) * sum of (|π_i| + |σ_i|) |x|^i + 2u^2 |result|)) / (1 - 2u),
+ * where π_i and σ_i are the errors of the i-th product and sum, accumulated by the Horner method too.
+ */
+static inline double horner_compensated_bound(long degree, double result, double errors) {
+  double unit_roundoff = DBL_EPSILON / 2;
+  double gamma = (4 * degree + 2) * unit_roundoff / (1 - (4 * degree + 2) * unit_roundoff);
+  double absolute = fabs(result);
+
+  return (unit_roundoff * absolute + (gamma * errors + 2 * unit_roundoff * unit_roundoff * absolute)) / (1 - 2 * unit_roundoff);
+}
+
+
+double coefficients_horner_compensated(const double *coefficients, long degree, double x, double *error_bound) {
+  assert(coefficients != NULL);
+  assert(degree >= 0);
+
+  double result = coefficients[degree], correction = 0, errors = 0;
+
+  long index;
+  for(index = degree - 1; index >= 0; index--) {
+    double product_error, sum_error;
+    double product = two_product(result, x, &product_error);
+    result = two_sum(product, coefficients[index], &sum_error);
+
+    correction = correction * x + (product_error + sum_error);
+    errors = errors * fabs(x) + (fabs(product_error) + fabs(sum_error));
+  }
+
+  result += correction;
+  if(error_bound != NULL) {
+    *error_bound = horner_compensated_bound(degree, result, errors);
+  }
+
+  return result;
+}
+
+
+void coefficients_horner_compensated_points(const double *coefficients, long degree, const double *points, unsigned long number_of_points, double *values, double *error_bounds) {
+  assert(coefficients != NULL);
+  assert(degree >= 0);
+  assert(points != NULL);
+  assert(values != NULL);
+
+  unsigned long point = 0;
+  for(; point + HORNER_WIDTH <= number_of_points; point += HORNER_WIDTH) {
+    HornerVector x;
+    memcpy(&x, points + point, sizeof(x));
+
+    HornerVector absolute_x = horner_absolute_vector(x);
+    HornerVector result = (HornerVector) {0} + coefficients[degree];
+    HornerVector correction = {0}, errors = {0};
+
+    long index;
+    for(index = degree - 1; index >= 0; index--) {
+      HornerVector product_error, sum_error;
+      HornerVector product = two_product_vector(result, x, &product_error);
+      result = two_sum_vector(product, (HornerVector) {0} + coefficients[index], &sum_error);
+
+      correction = correction * x + (product_error + sum_error);
+      errors = errors * absolute_x + (horner_absolute_vector(product_error) + horner_absolute_vector(sum_error));
+    }
+
+    result += correction;
+    memcpy(values + point, &result, sizeof(result));
+
+    if(error_bounds != NULL) {
+      unsigned long lane;
+      for(lane = 0; lane < HORNER_WIDTH; lane++) {
+        error_bounds[point + lane] = horner_compensated_bound(degree, result[lane], errors[lane]);
+      }
+    }
+  }
+
+  for(; point < number_of_points; point++) {
+    values[point] = coefficients_horner_compensated(coefficients, degree, points[point], (error_bounds != NULL) ? &error_bounds[point] : NULL);
+  }
+}
+
+
+void coefficients_scale_variable(double *coefficients, long degree, double scale) {
+  assert(coefficients != NULL);
+
+  double power = 1;
+  long index;
+  for(index = 0; index <= degree; index++) {
+    coefficients[index] *= power;
+    power *= scale;
+  }
+}
+
+
+static void coefficients_taylor_shift_horner(double *coefficients, long degree, double shift) {
+  long step, index;
+  for(step = 0; step < degree; step++) {
+    for(index = degree - 1; index >= step; index--) {
+      coefficients[index] += shift * coefficients[index + 1];
+    }
+  }
+}
+
+
+/*
+ * @function coefficients_taylor_shift_split
+ *
+ * p(x) = low(x) + x^half * high(x)
+ * so p(x + shift) = low(x + shift) + (x + shift)^half * high(x + shift)
+ *
+ * Coefficients and shift must be integers: coefficients_product then rounds its FFT products,
+ * or falls back to the schoolbook method, and its results are integers too.
+ * Otherwise the error of a FFT is relative to the biggest coefficient of the product,
+ * which grows like 2^degree, and wipes out the small ones.
+ */
+static void coefficients_taylor_shift_split(double *coefficients, long degree, double shift) {
+  if(degree < TAYLOR_SHIFT_HORNER_THRESHOLD) {
+    coefficients_taylor_shift_horner(coefficients, degree, shift);
+    return;
+  }
+
+  long half = (degree + 1) / 2;
+
+  coefficients_taylor_shift_split(coefficients, half - 1, shift);
+  coefficients_taylor_shift_split(coefficients + half, degree - half, shift);
+
+  // binomial[k] = C(half, k) * shift^(half - k)
+  double *binomial = coefficients_allocate(sizeof(double) * (half + 1));
+  binomial[half] = 1;
+
+  long index;
+  for(index = half; index > 0; index--) {
+    binomial[index - 1] = binomial[index] * shift * index / (half - index + 1);
+  }
+
+  double *high = coefficients_allocate(sizeof(double) * (degree + 1));
+  coefficients_product(coefficients + half, degree - half, binomial, half, high);
+
+  for(index = 0; index <= degree; index++) {
+    coefficients[index] = ((index < half) ? coefficients[index] : 0) + high[index];
+  }
+
+  free(binomial);
+  free(high);
+}
+
+
+void coefficients_taylor_shift(double *coefficients, long degree, double shift) {
+  assert(coefficients != NULL);
+
+  if(shift == 0) {
+    return;
+  }
+
+  if(degree >= TAYLOR_SHIFT_HORNER_THRESHOLD && shift == floor(shift) && fft_integral_norm(coefficients, degree) >= 0) {
+    coefficients_taylor_shift_split(coefficients, degree, shift);
+  } else {
+    coefficients_taylor_shift_horner(coefficients, degree, shift);
+  }
+}
+
+
+
+int coefficients_series_inverse(const double *series, long degree, double *result, long order) {
+  assert(series != NULL);
+  assert(result != NULL);
+  assert(order > 0);
+
+  if(series[0] == 0) {
+    return 0;
+  }
+
+  double *error = coefficients_allocate(sizeof(double) * order);
+  double *next = coefficients_allocate(sizeof(double) * order);
+
+  long index, precision = 1;
+  result[0] = 1 / series[0];
+
+  // g <- g * (2 - f * g), exact modulo x^(2 * precision)
+  while(precision < order) {
+    long next_precision = (2 * precision < order) ? 2 * precision : order;
+
+    coefficients_product_low(series, degree, result, precision - 1, error, next_precision);
+    for(index = 0; index < next_precision; index++) {
+      error[index] = -error[index];
+    }
+    error[0] += 2;
+
+    coefficients_product_low(result, precision - 1, error, next_precision - 1, next, next_precision);
+    memcpy(result, next, sizeof(double) * next_precision);
+
+    precision = next_precision;
+  }
+
+  free(error);
+  free(next);
+
+  return 1;
+}
+
+
+int coefficients_series_sqrt(const double *series, long degree, double *result, long order) {
+  assert(series != NULL);
+  assert(result != NULL);
+  assert(order > 0);
+
+  if(series[0] <= 0) {
+    return 0;
+  }
+
+  double *inverse = coefficients_allocate(sizeof(double) * order);
+  double *quotient = coefficients_allocate(sizeof(double) * order);
+
+  long index, precision = 1;
+  result[0] = sqrt(series[0]);
+
+  // s <- (s + f / s) / 2, exact modulo x^(2 * precision)
+  while(precision < order) {
+    long next_precision = (2 * precision < order) ? 2 * precision : order;
+
+    for(index = precision; index < next_precision; index++) {
+      result[index] = 0;
+    }
+
+    coefficients_series_inverse(result, precision - 1, inverse, next_precision);
+    coefficients_product_low(series, degree, inverse, next_precision - 1, quotient, next_precision);
+
+    for(index = 0; index < next_precision; index++) {
+      result[index] = (result[index] + quotient[index]) / 2;
+    }
+
+    precision = next_precision;
+  }
+
+  free(inverse);
+  free(quotient);
+
+  return 1;
+}
+
+
+int coefficients_series_log(const double *series, long degree, double *result, long order) {
+  assert(series != NULL);
+  assert(result != NULL);
+  assert(order > 0);
+
+  if(series[0] <= 0) {
+    return 0;
+  }
+
+  if(degree >= order) {
+    degree = order - 1;
+  }
+
+  long index;
+  result[0] = log(series[0]);
+
+  if(order == 1) {
+    return 1;
+  }
+
+  // log(f) = log(f(0)) + integral of f' / f
+  long derivative_degree = (degree > 0) ? degree - 1 : 0;
+  double *derivative = coefficients_allocate(sizeof(double) * (derivative_degree + 1));
+  double *inverse = coefficients_allocate(sizeof(double) * (order - 1));
+  double *quotient = coefficients_allocate(sizeof(double) * (order - 1));
+
+  derivative[0] = 0;
+  for(index = 1; index <= degree; index++) {
+    derivative[index - 1] = series[index] * index;
+  }
+
+  coefficients_series_inverse(series, degree, inverse, order - 1);
+  coefficients_product_low(derivative, derivative_degree, inverse, order - 2, quotient, order - 1);
+
+  for(index = 1; index < order; index++) {
+    result[index] = quotient[index - 1] / index;
+  }
+
+  free(derivative);
+  free(inverse);
+  free(quotient);
+
+  return 1;
+}
+
+
+int coefficients_series_exp(const double *series, long degree, double *result, long order) {
+  assert(series != NULL);
+  assert(result != NULL);
+  assert(order > 0);
+
+  if(degree >= order) {
+    degree = order - 1;
+  }
+
+  double *logarithm = coefficients_allocate(sizeof(double) * order);
+  double *next = coefficients_allocate(sizeof(double) * order);
+
+  // exp(f) = exp(f(0)) * exp(f - f(0)), and the latter starts with 1
+  long index, precision = 1;
+  result[0] = 1;
+
+  // g <- g * (1 - log(g) + f), exact modulo x^(2 * precision)
+  while(precision < order) {
+    long next_precision = (2 * precision < order) ? 2 * precision : order;
+
+    for(index = precision; index < next_precision; index++) {
+      result[index] = 0;
+    }
+
+    coefficients_series_log(result, precision - 1, logarithm, next_precision);
+    for(index = 0; index < next_precision; index++) {
+      logarithm[index] = ((index > 0 && index <= degree) ? series[index] : 0) - logarithm[index];
+    }
+    logarithm[0] += 1;
+
+    coefficients_product_low(result, precision - 1, logarithm, next_precision - 1, next, next_precision);
+    memcpy(result, next, sizeof(double) * next_precision);
+
+    precision = next_precision;
+  }
+
+  coefficients_scale(result, order - 1, exp(series[0]));
+
+  free(logarithm);
+  free(next);
+
+  return 1;
+}
+
+
+void coefficients_add(double *destination, const double *source, long degree) {
+  assert(destination != NULL);
+  assert(source != NULL);
+
+  coefficients_kernels->add(destination, source, degree + 1);
+}
+
+
+void coefficients_axpy(double *destination, double factor, const double *source, long degree) {
+  assert(destination != NULL);
+  assert(source != NULL);
+
+  coefficients_kernels->axpy(destination, factor, source, degree + 1);
+}
+
+
+long coefficients_compact(const double *coefficients, long degree, double tolerance, double *compacted, long *degrees) {
+  assert(coefficients != NULL);
+  assert(compacted != NULL);
+  assert(degrees != NULL);
+
+  return coefficients_kernels->compact(coefficients, degree + 1, tolerance, compacted, degrees);
+}
+
+
+long coefficients_degree(const double *coefficients, long degree, double tolerance) {
+  assert(coefficients != NULL);
+
+  return coefficients_kernels->degree(coefficients, degree + 1, tolerance);
+}
+
+
+void coefficients_derivative(const double *coefficients, long degree, double *result) {
+  assert(coefficients != NULL);
+  assert(result != NULL);
+
+  coefficients_kernels->derivative(coefficients, degree, result);
+}
+
+
+COEFFICIENTS_KERNELS coefficients_get_kernels(void) {
+  return coefficients_kernels_selected;
+}
+
+
+void coefficients_scale(double *coefficients, long degree, double factor) {
+  assert(coefficients != NULL);
+
+  coefficients_kernels->scale(coefficients, degree + 1, factor);
+}
+
+
+int coefficients_set_kernels(COEFFICIENTS_KERNELS kernels) {
+  COEFFICIENTS_KERNELS best = COEFFICIENTS_KERNELS_SCALAR;
+
+#ifdef COEFFICIENTS_KERNELS_X86
+  __builtin_cpu_init();
+  best = COEFFICIENTS_KERNELS_SSE2;
+  if(__builtin_cpu_supports("avx2")) {
+    best = COEFFICIENTS_KERNELS_AVX2;
+  }
+  if(__builtin_cpu_supports("avx512f")) {
+    best = COEFFICIENTS_KERNELS_AVX512;
+  }
+#endif
+
+  if(kernels == COEFFICIENTS_KERNELS_AUTO) {
+    kernels = best;
+  } else if(kernels > best) {
+    return 0;
+  }
+
+  switch(kernels) {
+#ifdef COEFFICIENTS_KERNELS_X86
+    case COEFFICIENTS_KERNELS_SSE2: coefficients_kernels = &kernels_sse2; break;
+    case COEFFICIENTS_KERNELS_AVX2: coefficients_kernels = &kernels_avx2; break;
+    case COEFFICIENTS_KERNELS_AVX512: coefficients_kernels = &kernels_avx512; break;
+#endif
+    default: coefficients_kernels = &kernels_scalar; break;
+  }
+  coefficients_kernels_selected = kernels;
+
+  return 1;
+}
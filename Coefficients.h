@@ -0,0 +1,416 @@
+#ifndef H_COEFFICIENTS
+#define H_COEFFICIENTS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Kernels working on dense arrays of coefficients.
+ *
+ * An array of coefficients is always sorted in ascending order:
+ * array[i] is the coefficient of x^i, and an array of degree n holds n + 1 doubles.
+ * These functions never create any Monomial.
+ */
+
+
+/*
+ * Element-wise kernels: add, axpy, scale, derivative, compact and degree.
+ * Each has a scalar version and SSE2, AVX2 and AVX-512 versions on x86-64,
+ * the best one the processor supports being selected at startup, through CPUID.
+ * All versions give identical results, bit for bit.
+ */
+typedef enum {
+  COEFFICIENTS_KERNELS_AUTO,
+  COEFFICIENTS_KERNELS_SCALAR,
+  COEFFICIENTS_KERNELS_SSE2,
+  COEFFICIENTS_KERNELS_AVX2,
+  COEFFICIENTS_KERNELS_AVX512
+} COEFFICIENTS_KERNELS;
+
+
+/*
+ * @function coefficients_add
+ *
+ * destination += source, for degree + 1 coefficients.
+ */
+extern void coefficients_add(double *destination, const double *source, long degree);
+
+
+/*
+ * @function coefficients_axpy
+ *
+ * destination += factor * source, for degree + 1 coefficients.
+ */
+extern void coefficients_axpy(double *destination, double factor, const double *source, long degree);
+
+
+/*
+ * Chebyshev series: chebyshev[k] is the coefficient of T_k, the Chebyshev polynomial of the first kind,
+ * with T_k(cos θ) = cos(kθ). On [-1, 1], they are much better conditioned than monomials.
+ * Conversions cost O(n log^2 n) for big degrees, by divide and conquer over coefficients_product.
+ */
+
+/*
+ * @function coefficients_chebyshev_from_monomial
+ *
+ * @param double *chebyshev
+ * Its length must be at least degree + 1. It may not overlap monomial.
+ */
+extern void coefficients_chebyshev_from_monomial(const double *monomial, long degree, double *chebyshev);
+
+
+/*
+ * @function coefficients_chebyshev_interpolate
+ *
+ * Computes the Chebyshev series of degree degree which takes values[j] at the j-th node of coefficients_chebyshev_nodes,
+ * with a type I discrete cosine transform, in O(n log n).
+ * values and chebyshev may be the same array.
+ */
+extern void coefficients_chebyshev_interpolate(const double *values, long degree, double *chebyshev);
+
+
+/*
+ * @function coefficients_chebyshev_nodes
+ *
+ * Sets nodes[j] to cos(π j / degree), for 0 <= j <= degree: the extrema of T_degree, from 1 down to -1.
+ */
+extern void coefficients_chebyshev_nodes(long degree, double *nodes);
+
+
+// the leading monomial coefficient of T_n is 2^(n - 1), which isn't a finite double over this degree
+#define COEFFICIENTS_CHEBYSHEV_MAX_DEGREE 1024
+
+/*
+ * @function coefficients_chebyshev_to_monomial
+ *
+ * The monomial coefficients of T_n grow like 2^n: they may overflow to infinity from degree 700 or so.
+ *
+ * @param double *monomial
+ * Its length must be at least degree + 1. It may not overlap chebyshev.
+ *
+ * @return int
+ * 1 on success, 0 if degree is over COEFFICIENTS_CHEBYSHEV_MAX_DEGREE: monomial is then left unchanged.
+ */
+extern int coefficients_chebyshev_to_monomial(const double *chebyshev, long degree, double *monomial);
+
+
+/*
+ * @function coefficients_chebyshev_values
+ *
+ * The inverse of coefficients_chebyshev_interpolate: the values of a Chebyshev series at the nodes, in O(n log n).
+ * chebyshev and values may be the same array.
+ */
+extern void coefficients_chebyshev_values(const double *chebyshev, long degree, double *values);
+
+
+/*
+ * @function coefficients_compact
+ *
+ * Copies the coefficients which are not null, |c| >= tolerance, to the start of compacted, in ascending order,
+ * and their degrees to degrees. compacted may be coefficients itself.
+ *
+ * @return long
+ * The number of coefficients kept.
+ */
+extern long coefficients_compact(const double *coefficients, long degree, double tolerance, double *compacted, long *degrees);
+
+
+/*
+ * @function coefficients_compose
+ *
+ * Computes p(q(x)) by divide and conquer:
+ * p = low + x^half * high gives p(q) = low(q) + q^half * high(q),
+ * where the powers q^half are computed once, by repeated squaring.
+ *
+ * @param double *result
+ * Its length must be at least p_degree * q_degree + 1.
+ */
+extern void coefficients_compose(const double *p, long p_degree, const double *q, long q_degree, double *result);
+
+
+/*
+ * @function coefficients_compose_modulo
+ *
+ * Computes p(q(x)) mod r(x) with the baby-step giant-step algorithm of Brent and Kung.
+ * r's leading coefficient must not be 0.
+ *
+ * @param double *result
+ * Its length must be at least r_degree, result will be of degree r_degree - 1 at most.
+ */
+extern void coefficients_compose_modulo(const double *p, long p_degree, const double *q, long q_degree, const double *r, long r_degree, double *result);
+
+
+/*
+ * Fingerprints: the value of a polynomial with integer coefficients at a point, modulo the prime 2^61 - 1.
+ * Two different polynomials of degree <= n have the same fingerprint at a random point
+ * with probability at most n / (2^61 - 1) (Schwartz-Zippel lemma), so comparing fingerprints is an equality test.
+ * They return 1 on success, 0 if a coefficient is not an integer or doesn't fit in 63 bits.
+ */
+#define COEFFICIENTS_FINGERPRINT_PRIME ((1ULL << 61) - 1)
+
+/*
+ * @function coefficients_degree
+ *
+ * @return long
+ * The highest degree whose coefficient is not null, |c| >= tolerance, -1 if they all are.
+ */
+extern long coefficients_degree(const double *coefficients, long degree, double tolerance);
+
+
+/*
+ * @function coefficients_derivative
+ *
+ * @param double *result
+ * Its length must be at least degree. result[i] is set to (i + 1) * coefficients[i + 1].
+ */
+extern void coefficients_derivative(const double *coefficients, long degree, double *result);
+
+
+/*
+ * @function coefficients_fingerprint
+ *
+ * Fingerprint of a dense polynomial, by the Horner method.
+ */
+extern int coefficients_fingerprint(const double *coefficients, long degree, unsigned long long point, unsigned long long *fingerprint);
+
+
+/*
+ * @function coefficients_fingerprint_bits
+ *
+ * Fingerprint of the polynomial whose coefficients are the bit patterns of coefficients, as 64-bit integers:
+ * it works for any double, and tells apart arrays which differ in a single bit.
+ * The Horner method starts from value, the result for the coefficients of higher degree,
+ * so that a long array can be fingerprinted by blocks, from the last one: start from 0.
+ *
+ * @return unsigned long long
+ * The fingerprint, always computed.
+ */
+extern unsigned long long coefficients_fingerprint_bits(const double *coefficients, long degree, unsigned long long point, unsigned long long value);
+
+
+/*
+ * @function coefficients_fingerprint_term
+ *
+ * Fingerprint of coefficient * x^degree. The fingerprint of a sum is the sum of fingerprints, modulo the prime.
+ */
+extern int coefficients_fingerprint_term(long degree, double coefficient, unsigned long long point, unsigned long long *fingerprint);
+
+
+/*
+ * Hashes: the hash of a polynomial is the sum of the hashes of its non-null terms, modulo 2^64,
+ * so the terms may be hashed in any order, and several at once.
+ * When tolerance is > 0, coefficients are first rounded to the nearest multiple of tolerance,
+ * and terms rounded to 0 are ignored: polynomials whose coefficients round the same have the same hash.
+ * Close coefficients on either side of a rounding boundary still round differently.
+ */
+
+/*
+ * @function coefficients_get_kernels
+ *
+ * @return COEFFICIENTS_KERNELS
+ * The version of the element-wise kernels in use, never COEFFICIENTS_KERNELS_AUTO.
+ */
+extern COEFFICIENTS_KERNELS coefficients_get_kernels(void);
+
+
+/*
+ * @function coefficients_hash
+ *
+ * Hash of a dense polynomial, several coefficients at a time.
+ */
+extern unsigned long long coefficients_hash(const double *coefficients, long degree, double tolerance);
+
+
+/*
+ * @function coefficients_hash_term
+ *
+ * Hash of coefficient * x^degree, 0 if it is null.
+ */
+extern unsigned long long coefficients_hash_term(long degree, double coefficient, double tolerance);
+
+
+/*
+ * Compensated Horner method: the rounding error of every product and sum of the Horner method
+ * is computed exactly, by error-free transformations, and their sum is added to the result at the end.
+ * The result is as accurate as if it had been computed with twice the precision of a double, then rounded,
+ * and it costs only plain double operations, which are vectorized for several points.
+ * Coefficients and points must be below 2^996 in magnitude.
+ *
+ * If error_bound is not NULL, it is set to a bound of |result - p(x)|, computed along the evaluation.
+ */
+
+/*
+ * @function coefficients_horner_compensated
+ */
+extern double coefficients_horner_compensated(const double *coefficients, long degree, double x, double *error_bound);
+
+
+/*
+ * @function coefficients_horner_compensated_points
+ *
+ * values[i] (and error_bounds[i], if error_bounds is not NULL) are set for points[i], several points at a time.
+ */
+extern void coefficients_horner_compensated_points(const double *coefficients, long degree, const double *points, unsigned long number_of_points, double *values, double *error_bounds);
+
+
+/*
+ * A prepared operand, for repeated products by the same polynomial:
+ * it keeps the FFT of the polynomial for each size of product it was used for, with the roots of that size.
+ * It may be used by several threads at once.
+ */
+typedef struct CoefficientsPrepared CoefficientsPrepared;
+
+
+/*
+ * @function coefficients_prepare
+ *
+ * @return CoefficientsPrepared*
+ * A prepared copy of coefficients, whose transforms are computed on first use.
+ * Must be freed with coefficients_prepared_free after use.
+ */
+extern CoefficientsPrepared* coefficients_prepare(const double *coefficients, long degree);
+
+
+/*
+ * @function coefficients_prepared_free
+ *
+ * Frees associated resources and sets *prepared to NULL to prevent further use.
+ */
+extern void coefficients_prepared_free(CoefficientsPrepared **prepared);
+
+
+/*
+ * @function coefficients_product
+ *
+ * Computes the product of two dense polynomials.
+ * Small operands are multiplied the schoolbook way, bigger ones through a FFT.
+ * The FFT of integral operands is rounded back to integers, which makes their product exact,
+ * or replaced by the schoolbook product if their coefficients are too big for rounding to be safe.
+ *
+ * @param double *result
+ * Its length must be at least left_degree + right_degree + 1.
+ * It may not overlap left or right.
+ */
+extern void coefficients_product(const double *left, long left_degree, const double *right, long right_degree, double *result);
+
+
+/*
+ * @function coefficients_product_low
+ *
+ * Computes the order first coefficients of the product of left and right (a "mullow").
+ * Only the terms of degree < order are computed: for big operands, the FFTs have about order coefficients
+ * instead of twice as many for the full product. Integral operands give an exact result, as with coefficients_product.
+ *
+ * @param double *result
+ * Its length must be at least order. It may not overlap left or right.
+ */
+extern void coefficients_product_low(const double *left, long left_degree, const double *right, long right_degree, double *result, long order);
+
+
+/*
+ * @function coefficients_product_prepared
+ *
+ * Same as coefficients_product, with prepared as left operand, and the same result, bit for bit.
+ * Big products only compute the transform of other and the inverse one, two FFTs instead of three.
+ *
+ * @param double *result
+ * Its length must be at least the degree of prepared + other_degree + 1. It may not overlap other.
+ */
+extern void coefficients_product_prepared(CoefficientsPrepared *prepared, const double *other, long other_degree, double *result);
+
+
+/*
+ * @function coefficients_remainder
+ *
+ * Replaces dividend with its remainder in the division by divisor, in place.
+ * After the call, dividend[0..divisor_degree - 1] holds the remainder.
+ * divisor's leading coefficient must not be 0.
+ */
+extern void coefficients_remainder(double *dividend, long dividend_degree, const double *divisor, long divisor_degree);
+
+
+/*
+ * @function coefficients_scale
+ *
+ * coefficients *= factor, for degree + 1 coefficients.
+ */
+extern void coefficients_scale(double *coefficients, long degree, double factor);
+
+
+/*
+ * @function coefficients_scale_variable
+ *
+ * Replaces p(x) with p(scale * x), in place, in O(n).
+ */
+extern void coefficients_scale_variable(double *coefficients, long degree, double scale);
+
+
+/*
+ * Power series functions.
+ * They compute their result modulo x^order by Newton iteration, doubling the precision at each step.
+ * result must have room for order coefficients and may not overlap the series.
+ * They return 1 on success, 0 if the series' constant term is not in their domain.
+ */
+
+/*
+ * @function coefficients_series_exp
+ *
+ * Any constant term is allowed.
+ */
+extern int coefficients_series_exp(const double *series, long degree, double *result, long order);
+
+
+/*
+ * @function coefficients_series_inverse
+ *
+ * The constant term must not be 0.
+ */
+extern int coefficients_series_inverse(const double *series, long degree, double *result, long order);
+
+
+/*
+ * @function coefficients_series_log
+ *
+ * The constant term must be > 0.
+ */
+extern int coefficients_series_log(const double *series, long degree, double *result, long order);
+
+
+/*
+ * @function coefficients_series_sqrt
+ *
+ * The constant term must be > 0.
+ */
+extern int coefficients_series_sqrt(const double *series, long degree, double *result, long order);
+
+
+/*
+ * @function coefficients_set_kernels
+ *
+ * Selects a version of the element-wise kernels, COEFFICIENTS_KERNELS_AUTO for the best one, the default.
+ * Must not be called while other threads use the kernels.
+ *
+ * @return int
+ * 1 on success, 0 if the processor doesn't support that version: the kernels are then unchanged.
+ */
+extern int coefficients_set_kernels(COEFFICIENTS_KERNELS kernels);
+
+
+/*
+ * @function coefficients_taylor_shift
+ *
+ * Replaces p(x) with p(x + shift), in place.
+ * Small degrees and non-integral inputs use the O(n^2) Horner scheme.
+ * Bigger ones with integral coefficients and shift split the polynomial in two halves,
+ * and recombine them with coefficients_product, as accurate as the schoolbook method on integers: O(M(n) log n).
+ */
+extern void coefficients_taylor_shift(double *coefficients, long degree, double shift);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
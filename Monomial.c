@@ -9,7 +9,7 @@
 
 #include "Monomial.h"
 
-MONOMIALS_ERRNO monomials_errno;
+__thread MONOMIALS_ERRNO monomials_errno;
 
 struct Monomial {
   double coefficient;
@@ -335,6 +335,21 @@ Monomial* monomial_product(const Monomial* leftm, const Monomial* rightm) {
 }
 
 
+void monomial_set_coefficient(Monomial *monomial, double coefficient) {
+  assert(monomial != NULL);
+
+  monomial->coefficient = coefficient;
+}
+
+
+void monomial_set_degree(Monomial *monomial, long degree) {
+  assert(monomial != NULL);
+  assert(degree >= 0);
+
+  monomial->degree = degree;
+}
+
+
 void monomial_set_next(Monomial *monomial, Monomial *next) {
   assert(monomial != NULL);
 
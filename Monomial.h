@@ -2,6 +2,10 @@
 #ifndef H_MONOMIAL
 #define H_MONOMIAL
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct Monomial Monomial;
 
 typedef enum {
@@ -14,8 +18,9 @@ typedef enum {
 /*
  * This variable must be set to SUCCESS before calling a monomial_* function.
  * monomial_* functions may change its value to indicate an error.
+ * Like errno, each thread has its own copy.
  */
-extern MONOMIALS_ERRNO monomials_errno;
+extern __thread MONOMIALS_ERRNO monomials_errno;
 
 
 /*
@@ -126,6 +131,18 @@ extern void monomial_print(const Monomial* monomial);
 extern Monomial* monomial_product(const Monomial* leftm, const Monomial* rightm);
 
 
+/*
+ * @function monomial_set_coefficient
+ */
+extern void monomial_set_coefficient(Monomial *monomial, double coefficient);
+
+
+/*
+ * @function monomial_set_degree
+ */
+extern void monomial_set_degree(Monomial *monomial, long degree);
+
+
 /*
  * @function monomial_set_next
  */
@@ -141,5 +158,9 @@ extern void monomial_set_next(Monomial *monomial, Monomial *next);
 extern Monomial* monomial_sum(const Monomial* leftm, const Monomial* rightm);
 
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
@@ -1,27 +1,61 @@
 
 #include <assert.h>
+#include <complex.h>
 #include <errno.h>
+#include <float.h>
+#include <math.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
+#include "Coefficients.h"
 #include "Monomial.h"
 #include "Polynomial.h"
 
 #define MAX_STDIN_BUFFER_SIZE 1000
 #define MAX_POLYNOMIAL_DEGREE 50
 
-POLYNOMIALS_ERRNO polynomials_errno;
+// polynomial_product uses the sparse algorithm when the dense array would be this many times bigger than the pairs of terms
+#define SPARSE_PRODUCT_RATIO 8
 
+// number of points computed together by polynomial_compute_derivatives_batch, the width of a SSE2 register
+#define DERIVATIVES_BATCH_WIDTH 2
+
+// number of coefficients compacted at a time by polynomial_assign_coefficients, on the stack
+#define ASSIGN_COMPACT_BLOCK 64
+
+// number of monomials polynomial_compute_exact gathers on the stack, more are gathered into an allocated array
+#define EXACT_MONOMIALS_BUFFER 50
+
+typedef double PointsVector __attribute__((vector_size(DERIVATIVES_BATCH_WIDTH * sizeof(double))));
+
+__thread POLYNOMIALS_ERRNO polynomials_errno;
+
+static POLYNOMIAL_COMPUTE_METHOD polynomial_compute_method = POLYNOMIAL_COMPUTE_LONG_DOUBLE;
+
+/*
+ * Every polynomial is kept in canonical form:
+ * its monomials are sorted by ascending degree, there is at most one monomial per degree, none is null,
+ * and degree and leading_coefficient are those of the last monomial (both 0 for the null polynomial).
+ * Functions must preserve it, so that no normalization pass is ever needed.
+ *
+ * The list of monomials may be shared by several polynomials, copies of each other.
+ * It is then counted by references, and is read-only: functions modifying a polynomial
+ * must first call polynomial_make_unique, which duplicates the list if it is shared (copy-on-write).
+ */
 struct Polynomial {
   Monomial *first;
   long degree;
+  double leading_coefficient;
+  Monomial *spare; // unused monomials, kept to be reused by in-place functions
+  long *references; // number of polynomials sharing first, NULL until the polynomial is first copied
 };
 
 
 static inline int is_coefficient_null(double coefficient) {
   // comparing a double to 0 may fail because of its internal representation
-  return (coefficient > -0.0001 && coefficient < 0.0001);
+  return (coefficient > -POLYNOMIAL_NULL_TOLERANCE && coefficient < POLYNOMIAL_NULL_TOLERANCE);
 }
 
 
@@ -34,25 +68,215 @@ static Polynomial* polynomial_create_empty(void) {
 
   new_polynomial->first = NULL;
   new_polynomial->degree = 0;
+  new_polynomial->leading_coefficient = 0;
+  new_polynomial->spare = NULL;
+  new_polynomial->references = NULL;
 
   return new_polynomial;
 }
 
 
-static void polynomial_recalculate_degree(Polynomial *polynomial) {
+/*
+ * @function polynomial_set_last
+ *
+ * Updates the cached degree and leading coefficient of polynomial.
+ *
+ * @param Monomial *last
+ * The last monomial of polynomial, NULL if it is null.
+ */
+static inline void polynomial_set_last(Polynomial *polynomial, Monomial *last) {
+  if(last == NULL) {
+    polynomial->degree = 0;
+    polynomial->leading_coefficient = 0;
+  } else {
+    polynomial->degree = monomial_get_degree(last);
+    polynomial->leading_coefficient = monomial_get_coefficient(last);
+  }
+}
+
+
+static long polynomial_count_monomials(const Polynomial *polynomial) {
   assert(polynomial != NULL);
 
-  long degree = 0;
+  long count = 0;
   Monomial *monomial = polynomial->first;
   while(monomial != NULL) {
-    long new_degree = monomial_get_degree(monomial);
-    if(new_degree > degree) {
-      degree = new_degree;
-    }
+    count++;
     monomial = monomial_get_next(monomial);
   }
 
-  polynomial->degree = degree;
+  return count;
+}
+
+
+/*
+ * @function polynomial_take_monomial
+ *
+ * @return Monomial*
+ * A monomial taken from the spare ones of polynomial if any, else a new one.
+ */
+static Monomial* polynomial_take_monomial(Polynomial *polynomial, double coefficient, long degree) {
+  Monomial *monomial = polynomial->spare;
+  if(monomial == NULL) {
+    return monomial_create(coefficient, degree);
+  }
+
+  polynomial->spare = monomial_get_next(monomial);
+
+  monomial_set_coefficient(monomial, coefficient);
+  monomial_set_degree(monomial, degree);
+  monomial_set_next(monomial, NULL);
+
+  return monomial;
+}
+
+
+/*
+ * @function polynomial_give_back_monomial
+ *
+ * Stores an unlinked monomial in the spare ones of polynomial.
+ */
+static void polynomial_give_back_monomial(Polynomial *polynomial, Monomial *monomial) {
+  monomial_set_next(monomial, polynomial->spare);
+  polynomial->spare = monomial;
+}
+
+
+/*
+ * @function polynomial_append_monomial
+ *
+ * Appends coefficient * x^degree to polynomial, with a spare monomial if any.
+ * Monomials must be appended by ascending degree, and polynomial_set_last called once they all are.
+ *
+ * @param Monomial *last
+ * The last monomial of polynomial, NULL if it has none yet.
+ *
+ * @return Monomial*
+ * The appended monomial, the new last one.
+ */
+static Monomial* polynomial_append_monomial(Polynomial *polynomial, Monomial *last, double coefficient, long degree) {
+  Monomial *monomial = polynomial_take_monomial(polynomial, coefficient, degree);
+  if(last == NULL) {
+    polynomial->first = monomial;
+  } else {
+    monomial_set_next(last, monomial);
+  }
+
+  return monomial;
+}
+
+
+/*
+ * @function polynomial_assign_coefficients
+ *
+ * Replaces the monomials of polynomial with the non-null coefficients of the array,
+ * reusing its monomials before allocating new ones.
+ * Trailing null coefficients are skipped at once, and the others are found by blocks, by the SIMD kernels.
+ */
+static void polynomial_assign_coefficients(Polynomial *polynomial, const double *coefficients, long degree) {
+  Monomial *reused = polynomial->first, *last = NULL;
+  polynomial->first = NULL;
+
+  double kept[ASSIGN_COMPACT_BLOCK];
+  long kept_degrees[ASSIGN_COMPACT_BLOCK];
+
+  long highest = coefficients_degree(coefficients, degree, POLYNOMIAL_NULL_TOLERANCE);
+  long start;
+  for(start = 0; start <= highest; start += ASSIGN_COMPACT_BLOCK) {
+    long block_degree = (highest - start < ASSIGN_COMPACT_BLOCK) ? highest - start : ASSIGN_COMPACT_BLOCK - 1;
+    long count = coefficients_compact(coefficients + start, block_degree, POLYNOMIAL_NULL_TOLERANCE, kept, kept_degrees);
+
+    long index;
+    for(index = 0; index < count; index++) {
+      // the previous monomials are reused first, through the spare ones
+      if(reused != NULL) {
+        Monomial *next = monomial_get_next(reused);
+        polynomial_give_back_monomial(polynomial, reused);
+        reused = next;
+      }
+
+      last = polynomial_append_monomial(polynomial, last, kept[index], start + kept_degrees[index]);
+    }
+  }
+
+  while(reused != NULL) {
+    Monomial *next = monomial_get_next(reused);
+    polynomial_give_back_monomial(polynomial, reused);
+    reused = next;
+  }
+
+  polynomial_set_last(polynomial, last);
+}
+
+
+/*
+ * @function polynomial_release_monomials
+ *
+ * Drops the reference of polynomial to its list of monomials, and frees the list if it was the last one.
+ * The monomials must not be used by polynomial afterwards.
+ */
+static void polynomial_release_monomials(Polynomial *polynomial) {
+  if(polynomial->references != NULL) {
+    if(__atomic_sub_fetch(polynomial->references, 1, __ATOMIC_ACQ_REL) > 0) {
+      // still used by other polynomials
+      polynomial->references = NULL;
+      polynomial->first = NULL;
+      return;
+    }
+
+    free(polynomial->references);
+    polynomial->references = NULL;
+  }
+
+  Monomial* current = polynomial->first, *next = NULL;
+  while(current != NULL) {
+    next = monomial_get_next(current);
+    monomial_free(&current);
+    current = next;
+  }
+
+  polynomial->first = NULL;
+}
+
+
+/*
+ * @function polynomial_make_unique
+ *
+ * Makes sure that the list of monomials of polynomial is not shared with any other polynomial,
+ * by duplicating it if needed. Must be called before any modification of the list.
+ */
+static void polynomial_make_unique(Polynomial *polynomial) {
+  if(polynomial->references == NULL) {
+    return;
+  }
+
+  if(__atomic_load_n(polynomial->references, __ATOMIC_ACQUIRE) == 1) {
+    // the other copies are gone
+    free(polynomial->references);
+    polynomial->references = NULL;
+    return;
+  }
+
+  Monomial *shared = polynomial->first, *last = NULL;
+  Monomial *original = shared;
+  polynomial->first = NULL;
+
+  while(shared != NULL) {
+    Monomial *monomial = polynomial_take_monomial(polynomial, monomial_get_coefficient(shared), monomial_get_degree(shared));
+    if(last == NULL) {
+      polynomial->first = monomial;
+    } else {
+      monomial_set_next(last, monomial);
+    }
+
+    last = monomial;
+    shared = monomial_get_next(shared);
+  }
+
+  Monomial *unique = polynomial->first;
+  polynomial->first = original;
+  polynomial_release_monomials(polynomial);
+  polynomial->first = unique;
 }
 
 
@@ -106,6 +330,66 @@ static void polynomial_convert_to_array(const Polynomial *polynomial, double *ar
 }
 
 
+/*
+ * @function polynomial_to_coefficients
+ *
+ * @return double*
+ * An array of polynomial->degree + 1 coefficients, sorted in ascending order.
+ * Must be freed with free after use.
+ */
+static double* polynomial_to_coefficients(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  size_t size_coeff_array = sizeof(double) * (polynomial->degree + 1);
+  double *coeff_array = calloc(polynomial->degree + 1, sizeof(double));
+  if(!coeff_array) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size_coeff_array);
+    exit(EXIT_FAILURE);
+  }
+
+  if(polynomial->first != NULL) {
+    polynomial_convert_to_array(polynomial, coeff_array);
+  }
+
+  return coeff_array;
+}
+
+
+// most of a dense array for the product would remain null: polynomial_product_sparse is used instead
+static int polynomial_product_is_sparse(long left_monomials, long right_monomials, long result_degree) {
+  return (double) (result_degree + 1) > SPARSE_PRODUCT_RATIO * ((double) left_monomials * right_monomials);
+}
+
+
+/*
+ * @function polynomial_product_dense
+ *
+ * The dense product of polynomial_product and polynomial_mul_into, by coefficients_product,
+ * so that both give the same result, exact for integral operands.
+ *
+ * @return double*
+ * The leftp->degree + rightp->degree + 1 coefficients of the product. Must be freed with free after use.
+ */
+static double* polynomial_product_dense(const Polynomial *leftp, const Polynomial *rightp) {
+  long result_degree = leftp->degree + rightp->degree;
+
+  double *left_coefficients = polynomial_to_coefficients(leftp);
+  double *right_coefficients = polynomial_to_coefficients(rightp);
+  double *result_coefficients = malloc(sizeof(double) * (result_degree + 1));
+  if(!result_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (result_degree + 1));
+    exit(EXIT_FAILURE);
+  }
+
+  coefficients_product(left_coefficients, leftp->degree, right_coefficients, rightp->degree, result_coefficients);
+
+  free(left_coefficients);
+  free(right_coefficients);
+
+  return result_coefficients;
+}
+
+
 static inline long double polynomial_compute_method_horner(const Polynomial* polynomial, int x) {
   assert(polynomial != NULL);
   assert(polynomial->first != NULL);
@@ -141,204 +425,1158 @@ static inline long double polynomial_compute_method_horner(const Polynomial* pol
 }
 
 
-long double polynomial_compute(const Polynomial* polynomial, int x) {
-  return polynomial_compute_method_horner(polynomial, x);
+void polynomial_add_into(Polynomial* destination, const Polynomial* source) {
+  polynomial_axpy(destination, 1, source);
 }
 
 
-Polynomial* polynomial_copy(const Polynomial* polynomial) {
-  assert(polynomial != NULL);
-
-  Polynomial *copy = polynomial_create_empty();
+void polynomial_axpy(Polynomial* destination, double factor, const Polynomial* source) {
+  assert(destination != NULL);
+  assert(source != NULL);
 
-  Monomial *current = polynomial->first, *copy_current = NULL;
+  polynomial_make_unique(destination);
 
-  while(current != NULL) {
-    if(copy_current == NULL) {
-      copy->first = monomial_copy(current);
-      copy_current = copy->first;
-    } else {
-      Monomial *previous = copy_current;
-      copy_current = monomial_copy(current);
-      monomial_set_next(previous, copy_current);
-    }
+  if(destination == source) {
+    polynomial_scale(destination, 1 + factor);
+    return;
+  }
 
-    current = monomial_get_next(current);
+  if(factor == 0) {
+    return;
   }
 
-  polynomial_recalculate_degree(copy);
+  // both polynomials are sorted in ascending order: merge source into destination
+  Monomial *previous = NULL, *current = destination->first;
+  Monomial *source_monomial = source->first;
 
-  return copy;
-}
+  while(source_monomial != NULL) {
+    long degree = monomial_get_degree(source_monomial);
+    double coefficient = factor * monomial_get_coefficient(source_monomial);
 
+    while(current != NULL && monomial_get_degree(current) < degree) {
+      previous = current;
+      current = monomial_get_next(current);
+    }
 
-Polynomial* polynomial_create(const double *coefficients, unsigned int degree) {
-  assert(coefficients != NULL);
+    if(current != NULL && monomial_get_degree(current) == degree) {
+      double sum = monomial_get_coefficient(current) + coefficient;
 
-  Polynomial *new_polynomial = malloc(sizeof(Polynomial));
-  if(!new_polynomial) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(Polynomial));
-    exit(EXIT_FAILURE);
-  }
+      if(is_coefficient_null(sum)) {
+        Monomial *next = monomial_get_next(current);
+        if(previous == NULL) {
+          destination->first = next;
+        } else {
+          monomial_set_next(previous, next);
+        }
 
-  // polynomial_create({2., -4., 0, 3.}, 3) will create 2 -4x + 3x^3
-  unsigned int index = 1;
-  Monomial *current = monomial_create(coefficients[0], 0), *previous = NULL;
-  new_polynomial->first = current;
-  previous = current;
+        polynomial_give_back_monomial(destination, current);
+        current = next;
+      } else {
+        monomial_set_coefficient(current, sum);
+      }
+    } else if(!is_coefficient_null(coefficient)) {
+      Monomial *new_monomial = polynomial_take_monomial(destination, coefficient, degree);
+      monomial_set_next(new_monomial, current);
 
-  for(; index < degree + 1; index++) {
-    current = monomial_create(coefficients[index], index);
-    if(index == 0) {
-      new_polynomial->first = current;
-    } else {
-      monomial_set_next(previous, current);
+      if(previous == NULL) {
+        destination->first = new_monomial;
+      } else {
+        monomial_set_next(previous, new_monomial);
+      }
+      previous = new_monomial;
     }
 
-    previous = current;
+    source_monomial = monomial_get_next(source_monomial);
   }
 
-  new_polynomial->degree = (long) degree;
-
-  return new_polynomial;
+  // the monomials after current were not touched
+  if(current == NULL) {
+    polynomial_set_last(destination, previous);
+  } else if(monomial_get_next(current) == NULL) {
+    polynomial_set_last(destination, current);
+  }
 }
 
 
-/*
- * @function polynomial_remove_null_monomials
- *
- * Remove all monomials from polynomial where coefficient is 0
- */
-static void polynomial_remove_null_monomials(Polynomial *polynomial) {
+void polynomial_derivative_in_place(Polynomial* polynomial) {
   assert(polynomial != NULL);
 
-  Monomial *current = polynomial->first, *previous = NULL;
+  polynomial_make_unique(polynomial);
+
+  Monomial *previous = NULL, *current = polynomial->first;
   while(current != NULL) {
-    double coefficient = monomial_get_coefficient(current);
+    Monomial *next = monomial_get_next(current);
+    long degree = monomial_get_degree(current);
 
-    if(is_coefficient_null(coefficient)) {
-      // remove this monomial
-      if(current == polynomial->first) {
-        polynomial->first = monomial_get_next(current);
-        monomial_free(&current);
-        current = polynomial->first;
+    if(degree == 0) {
+      // constants vanish
+      if(previous == NULL) {
+        polynomial->first = next;
       } else {
-        Monomial *next = monomial_get_next(current);
-        monomial_free(&current);
-        current = next;
-        monomial_set_next(previous, current);
+        monomial_set_next(previous, next);
       }
 
-      continue;
+      polynomial_give_back_monomial(polynomial, current);
+    } else {
+      monomial_set_coefficient(current, monomial_get_coefficient(current) * degree);
+      monomial_set_degree(current, degree - 1);
+      previous = current;
     }
 
-    previous = current;
-    current = monomial_get_next(current);
+    current = next;
   }
 
-  polynomial_recalculate_degree(polynomial);
+  if(polynomial->first == NULL) {
+    polynomial_set_last(polynomial, NULL);
+  } else {
+    polynomial->leading_coefficient *= polynomial->degree;
+    polynomial->degree--;
+  }
 }
 
 
-Polynomial** polynomial_create_from_file(const char* filename, int* length) {
-  assert(filename != NULL);
-  assert(length != NULL);
+void polynomial_mul_into(Polynomial* destination, const Polynomial* leftp, const Polynomial* rightp) {
+  assert(destination != NULL);
+  assert(leftp != NULL);
+  assert(rightp != NULL);
 
-  errno = 0;
-  FILE *file = fopen(filename, "r");
-  if(!file) {
-    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
-    return 0;
-  }
+  polynomial_make_unique(destination);
 
-  // read number of lines
-  *length = 0;
-  int character = ' ';
-  while((character = fgetc(file)) != EOF) {
-    if(character == '\n') {
-      (*length)++;
+  long result_degree = leftp->degree + rightp->degree;
+
+  if(polynomial_product_is_sparse(polynomial_count_monomials(leftp), polynomial_count_monomials(rightp), result_degree)) {
+    // swap in the monomials of the sparse product
+    Polynomial *product = polynomial_product_sparse(leftp, rightp);
+
+    Monomial *old_first = destination->first;
+    destination->first = product->first;
+    destination->degree = product->degree;
+    destination->leading_coefficient = product->leading_coefficient;
+    product->first = old_first;
+
+    while(product->first != NULL) {
+      Monomial *monomial = product->first;
+      product->first = monomial_get_next(monomial);
+      polynomial_give_back_monomial(destination, monomial);
     }
-  }
 
-  Polynomial **polynomials = malloc(sizeof(Polynomial) * *length);
-  if(!polynomials) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(Polynomial) * (*length));
-    exit(EXIT_FAILURE);
+    polynomial_free(&product);
+    return;
   }
 
-  rewind(file);
-
-  char line[MAX_STDIN_BUFFER_SIZE];
+  double *result_coefficients = polynomial_product_dense(leftp, rightp);
 
-  int line_index = 0;
-  for(; line_index < *length; line_index++) {
-    if(fgets(line, MAX_STDIN_BUFFER_SIZE, file) != line) {
-      fprintf(stderr, "Fatal error: file input is longer than maximum buffer size(%u)!\nExiting\n", MAX_STDIN_BUFFER_SIZE);
-      exit(EXIT_FAILURE);
-    }
+  polynomial_assign_coefficients(destination, result_coefficients, result_degree);
 
-    char *end_of_line = strrchr(line, '\n');
-    if(end_of_line != NULL) {
-      *end_of_line = '\0';
-    }
+  free(result_coefficients);
+}
 
-    Polynomial *readp = polynomial_create_from_string(line);
-    if(!readp) {
-      continue;
-    }
 
-    polynomials[line_index] = readp;
+/*
+ * @function monomial_list_sort
+ *
+ * Merge sort of a list of monomials by ascending degree.
+ *
+ * @return Monomial*
+ * The new head of the list.
+ */
+static Monomial* monomial_list_sort(Monomial *head) {
+  if(head == NULL || monomial_get_next(head) == NULL) {
+    return head;
   }
 
-  fclose(file);
+  // split the list in two halves
+  Monomial *slow = head, *fast = monomial_get_next(head);
+  while(fast != NULL && monomial_get_next(fast) != NULL) {
+    slow = monomial_get_next(slow);
+    fast = monomial_get_next(monomial_get_next(fast));
+  }
 
-  return polynomials;
-}
+  Monomial *second = monomial_get_next(slow);
+  monomial_set_next(slow, NULL);
 
+  Monomial *left = monomial_list_sort(head);
+  Monomial *right = monomial_list_sort(second);
 
-Polynomial* polynomial_create_from_stdin(void) {
-  char input[MAX_STDIN_BUFFER_SIZE];
+  // merge them
+  Monomial *merged = NULL, *last = NULL;
+  while(left != NULL || right != NULL) {
+    Monomial *taken;
+    if(right == NULL || (left != NULL && monomial_get_degree(left) <= monomial_get_degree(right))) {
+      taken = left;
+      left = monomial_get_next(left);
+    } else {
+      taken = right;
+      right = monomial_get_next(right);
+    }
 
-  read_string_from_stdin(input);
+    if(last == NULL) {
+      merged = taken;
+    } else {
+      monomial_set_next(last, taken);
+    }
+    last = taken;
+  }
 
-  return polynomial_create_from_string(input);
+  return merged;
 }
 
 
-Polynomial* polynomial_create_from_string(char *string) {
-  assert(string != NULL);
+void polynomial_reduct_in_place(Polynomial* polynomial) {
+  assert(polynomial != NULL);
 
-  // read a random number of numbers
-  // example string: 7x^3 + x^2 -9x + 30
-  // allowed characters: digits, +, -, x, ^
+  polynomial_make_unique(polynomial);
 
-  Polynomial* new_polynomial = polynomial_create_empty();
-  Monomial* previous_monomial = NULL;
+  polynomial->first = monomial_list_sort(polynomial->first);
 
-  char *cursor = string;
-  long max_monomial_degree = 0;
-  int first_monomial = 1;
+  // merge neighbours of same degree
+  Monomial *current = polynomial->first;
+  while(current != NULL) {
+    Monomial *next = monomial_get_next(current);
+    while(next != NULL && monomial_get_degree(next) == monomial_get_degree(current)) {
+      monomial_set_coefficient(current, monomial_get_coefficient(current) + monomial_get_coefficient(next));
+      monomial_set_next(current, monomial_get_next(next));
+      polynomial_give_back_monomial(polynomial, next);
+      next = monomial_get_next(current);
+    }
 
-  while(*cursor != '\0') {
-    monomials_errno = MONOMIAL_SUCCESS;
+    current = next;
+  }
 
-    char *tmp_cursor = cursor;
-    Monomial *new_monomial = monomial_create_from_string(cursor, &tmp_cursor);
-    switch(monomials_errno) {
-      case MONOMIAL_INPUT_ERROR:
-        fprintf(stderr, "Fatal error: malformatted input!\nExiting\n");
-        exit(EXIT_FAILURE);
+  // remove null monomials
+  Monomial *previous = NULL;
+  current = polynomial->first;
+  while(current != NULL) {
+    Monomial *next = monomial_get_next(current);
 
-      default: break;
+    if(is_coefficient_null(monomial_get_coefficient(current))) {
+      if(previous == NULL) {
+        polynomial->first = next;
+      } else {
+        monomial_set_next(previous, next);
+      }
+
+      polynomial_give_back_monomial(polynomial, current);
+    } else {
+      previous = current;
+    }
+
+    current = next;
+  }
+
+  polynomial_set_last(polynomial, previous);
+}
+
+
+void polynomial_scale(Polynomial* polynomial, double factor) {
+  assert(polynomial != NULL);
+
+  polynomial_make_unique(polynomial);
+
+  Monomial *previous = NULL, *current = polynomial->first;
+  while(current != NULL) {
+    Monomial *next = monomial_get_next(current);
+    double coefficient = monomial_get_coefficient(current) * factor;
+
+    if(is_coefficient_null(coefficient)) {
+      if(previous == NULL) {
+        polynomial->first = next;
+      } else {
+        monomial_set_next(previous, next);
+      }
+
+      polynomial_give_back_monomial(polynomial, current);
+    } else {
+      monomial_set_coefficient(current, coefficient);
+      previous = current;
+    }
+
+    current = next;
+  }
+
+  polynomial_set_last(polynomial, previous);
+}
+
+
+Polynomial* polynomial_compose(const Polynomial* p, const Polynomial* q) {
+  assert(p != NULL);
+  assert(q != NULL);
+
+  double *p_coefficients = polynomial_to_coefficients(p);
+  double *q_coefficients = polynomial_to_coefficients(q);
+
+  long result_degree = p->degree * q->degree;
+  double *result_coefficients = malloc(sizeof(double) * (result_degree + 1));
+  if(!result_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (result_degree + 1));
+    exit(EXIT_FAILURE);
+  }
+
+  coefficients_compose(p_coefficients, p->degree, q_coefficients, q->degree, result_coefficients);
+
+  Polynomial *composed = polynomial_create(result_coefficients, result_degree);
+
+  free(p_coefficients);
+  free(q_coefficients);
+  free(result_coefficients);
+
+  return composed;
+}
+
+
+Polynomial* polynomial_compose_modulo(const Polynomial* p, const Polynomial* q, const Polynomial* r) {
+  assert(p != NULL);
+  assert(q != NULL);
+  assert(r != NULL);
+
+  if(r->first == NULL) {
+    // division by zero
+    polynomials_errno = POLYNOMIAL_MATH_ERROR;
+    return NULL;
+  }
+
+  double *p_coefficients = polynomial_to_coefficients(p);
+  double *q_coefficients = polynomial_to_coefficients(q);
+  double *r_coefficients = polynomial_to_coefficients(r);
+
+  // the remainder has r->degree coefficients, but polynomial_create needs at least one
+  long result_length = (r->degree > 0) ? r->degree : 1;
+  double *result_coefficients = calloc(result_length, sizeof(double));
+  if(!result_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * result_length);
+    exit(EXIT_FAILURE);
+  }
+
+  coefficients_compose_modulo(p_coefficients, p->degree, q_coefficients, q->degree, r_coefficients, r->degree, result_coefficients);
+
+  Polynomial *composed = polynomial_create(result_coefficients, result_length - 1);
+
+  free(p_coefficients);
+  free(q_coefficients);
+  free(r_coefficients);
+  free(result_coefficients);
+
+  return composed;
+}
+
+
+long double polynomial_compute(const Polynomial* polynomial, int x) {
+  assert(polynomial != NULL);
+
+  if(polynomial->first == NULL) {
+    // the null polynomial
+    return 0;
+  }
+
+  if(polynomial_compute_method == POLYNOMIAL_COMPUTE_LONG_DOUBLE) {
+    return polynomial_compute_method_horner(polynomial, x);
+  }
+
+  return polynomial_compute_with_method(polynomial, x, polynomial_compute_method, NULL);
+}
+
+
+/*
+ * The rounding errors of Horner's method are bounded by γ_2n times the value of the polynomial
+ * with the absolute values of its terms, where γ_k = ku / (1 - ku) and u is the unit roundoff
+ * (Higham, Accuracy and Stability of Numerical Algorithms, 5.1).
+ */
+static inline double horner_error_bound(long degree, double unit_roundoff, double absolute) {
+  double rounding = 2 * degree * unit_roundoff;
+  return rounding / (1 - rounding) * absolute;
+}
+
+
+static double compute_coefficients_with_method(const double *coefficients, long degree, double x, POLYNOMIAL_COMPUTE_METHOD method, double *error_bound) {
+  long index;
+
+  switch(method) {
+    case POLYNOMIAL_COMPUTE_COMPENSATED:
+      return coefficients_horner_compensated(coefficients, degree, x, error_bound);
+
+    case POLYNOMIAL_COMPUTE_LONG_DOUBLE: {
+      long double result = coefficients[degree], absolute = fabs(coefficients[degree]);
+      for(index = degree - 1; index >= 0; index--) {
+        result = result * x + coefficients[index];
+        absolute = absolute * fabsl(x) + fabs(coefficients[index]);
+      }
+
+      if(error_bound != NULL) {
+        // and the final rounding to a double
+        *error_bound = horner_error_bound(degree, LDBL_EPSILON / 2, absolute) + DBL_EPSILON / 2 * fabsl(result);
+      }
+      return result;
+    }
+
+    default: {
+      double result = coefficients[degree], absolute = fabs(coefficients[degree]);
+      for(index = degree - 1; index >= 0; index--) {
+        result = result * x + coefficients[index];
+        absolute = absolute * fabs(x) + fabs(coefficients[index]);
+      }
+
+      if(error_bound != NULL) {
+        *error_bound = horner_error_bound(degree, DBL_EPSILON / 2, absolute);
+      }
+      return result;
+    }
+  }
+}
+
+
+double polynomial_compute_with_method(const Polynomial* polynomial, double x, POLYNOMIAL_COMPUTE_METHOD method, double *error_bound) {
+  assert(polynomial != NULL);
+
+  if(method == POLYNOMIAL_COMPUTE_DEFAULT) {
+    method = polynomial_compute_method;
+  }
+
+  double *coefficients = polynomial_to_coefficients(polynomial);
+  double result = compute_coefficients_with_method(coefficients, polynomial->degree, x, method, error_bound);
+  free(coefficients);
+
+  return result;
+}
+
+
+void polynomial_compute_points(const Polynomial* polynomial, const double *points, unsigned long number_of_points, double *values, POLYNOMIAL_COMPUTE_METHOD method, double *error_bounds) {
+  assert(polynomial != NULL);
+  assert(points != NULL);
+  assert(values != NULL);
+
+  if(method == POLYNOMIAL_COMPUTE_DEFAULT) {
+    method = polynomial_compute_method;
+  }
+
+  long degree = polynomial->degree;
+  double *coefficients = polynomial_to_coefficients(polynomial);
+
+  unsigned long point = 0;
+  if(method == POLYNOMIAL_COMPUTE_COMPENSATED) {
+    coefficients_horner_compensated_points(coefficients, degree, points, number_of_points, values, error_bounds);
+    point = number_of_points;
+
+  } else if(method == POLYNOMIAL_COMPUTE_DOUBLE) {
+    for(; point + DERIVATIVES_BATCH_WIDTH <= number_of_points; point += DERIVATIVES_BATCH_WIDTH) {
+      PointsVector x, absolute_x;
+      memcpy(&x, points + point, sizeof(x));
+
+      unsigned long lane;
+      for(lane = 0; lane < DERIVATIVES_BATCH_WIDTH; lane++) {
+        absolute_x[lane] = fabs(x[lane]);
+      }
+
+      PointsVector result = (PointsVector) {0} + coefficients[degree];
+      PointsVector absolute = (PointsVector) {0} + fabs(coefficients[degree]);
+
+      long index;
+      for(index = degree - 1; index >= 0; index--) {
+        result = result * x + coefficients[index];
+        absolute = absolute * absolute_x + fabs(coefficients[index]);
+      }
+
+      memcpy(values + point, &result, sizeof(result));
+      if(error_bounds != NULL) {
+        for(lane = 0; lane < DERIVATIVES_BATCH_WIDTH; lane++) {
+          error_bounds[point + lane] = horner_error_bound(degree, DBL_EPSILON / 2, absolute[lane]);
+        }
+      }
+    }
+  }
+
+  // the remaining points, and every point in long double
+  for(; point < number_of_points; point++) {
+    values[point] = compute_coefficients_with_method(coefficients, degree, points[point], method, (error_bounds != NULL) ? &error_bounds[point] : NULL);
+  }
+
+  free(coefficients);
+}
+
+
+/*
+ * The derivatives are computed in ascending order of degrees, as monomials are stored:
+ * d^k(x^i) / dx^k = i! / (i - k)! * x^(i - k)
+ * For each monomial, x^(i - k) is computed once for the highest k by binary exponentiation,
+ * then each lower derivative only costs a multiplication by x.
+ * The same scheme is written for real numbers, complex numbers and vectors of points.
+ */
+#define DEFINE_POWER_FUNCTION(name, type) \
+  static inline type name(type x, long exponent) { \
+    type result = {0}; \
+    result += 1; \
+    while(exponent > 0) { \
+      if(exponent & 1) { \
+        result *= x; \
+      } \
+      exponent >>= 1; \
+      x *= x; \
+    } \
+    return result; \
+  }
+
+DEFINE_POWER_FUNCTION(power_real, double)
+DEFINE_POWER_FUNCTION(power_complex, double complex)
+DEFINE_POWER_FUNCTION(power_vector, PointsVector)
+
+#define DEFINE_DERIVATIVES_FUNCTION(name, type, power) \
+  static void name(const Polynomial* polynomial, type x, type *values, unsigned int count) { \
+    if(count == 0) { \
+      return; \
+    } \
+    \
+    type zero = {0}; \
+    unsigned int k; \
+    for(k = 0; k < count; k++) { \
+      values[k] = zero; \
+    } \
+    \
+    Monomial *current = polynomial->first; \
+    while(current != NULL) { \
+      long degree = monomial_get_degree(current); \
+      long highest = (degree < (long) count - 1) ? degree : (long) count - 1; \
+      \
+      double factor = monomial_get_coefficient(current); \
+      for(k = 0; k < (unsigned int) highest; k++) { \
+        factor *= degree - k; \
+      } \
+      \
+      type term = power(x, degree - highest) * factor; \
+      long derivative; \
+      for(derivative = highest; derivative >= 0; derivative--) { \
+        values[derivative] += term; \
+        if(derivative > 0) { \
+          term = term * x / (double) (degree - derivative + 1); \
+        } \
+      } \
+      \
+      current = monomial_get_next(current); \
+    } \
+  }
+
+DEFINE_DERIVATIVES_FUNCTION(polynomial_compute_derivatives_real, double, power_real)
+DEFINE_DERIVATIVES_FUNCTION(polynomial_compute_derivatives_complex_values, double complex, power_complex)
+DEFINE_DERIVATIVES_FUNCTION(polynomial_compute_derivatives_vector, PointsVector, power_vector)
+
+
+void polynomial_compute_derivatives(const Polynomial* polynomial, double x, double *values, unsigned int count) {
+  assert(polynomial != NULL);
+  assert(values != NULL);
+
+  polynomial_compute_derivatives_real(polynomial, x, values, count);
+}
+
+
+void polynomial_compute_derivatives_batch(const Polynomial* polynomial, const double *points, unsigned long number_of_points, double *values, unsigned int count) {
+  assert(polynomial != NULL);
+  assert(points != NULL);
+  assert(values != NULL);
+
+  if(count == 0) {
+    return;
+  }
+
+  PointsVector vector_values[count];
+
+  unsigned long index_point;
+  for(index_point = 0; index_point < number_of_points; index_point += DERIVATIVES_BATCH_WIDTH) {
+    PointsVector x = {0};
+
+    unsigned long lane;
+    for(lane = 0; lane < DERIVATIVES_BATCH_WIDTH && index_point + lane < number_of_points; lane++) {
+      x[lane] = points[index_point + lane];
+    }
+
+    polynomial_compute_derivatives_vector(polynomial, x, vector_values, count);
+
+    for(lane = 0; lane < DERIVATIVES_BATCH_WIDTH && index_point + lane < number_of_points; lane++) {
+      unsigned int k;
+      for(k = 0; k < count; k++) {
+        values[(index_point + lane) * count + k] = vector_values[k][lane];
+      }
+    }
+  }
+}
+
+
+void polynomial_compute_derivatives_complex(const Polynomial* polynomial, double complex x, double complex *values, unsigned int count) {
+  assert(polynomial != NULL);
+  assert(values != NULL);
+
+  polynomial_compute_derivatives_complex_values(polynomial, x, values, count);
+}
+
+
+/*
+ * @function exact_value_reserve
+ *
+ * Makes room for length limbs in value->limbs.
+ */
+static void exact_value_reserve(PolynomialExactValue *value, unsigned long length) {
+  if(length <= value->length) {
+    return;
+  }
+
+  unsigned long long *limbs = realloc(value->limbs, sizeof(unsigned long long) * length);
+  if(!limbs) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long long) * length);
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned long index;
+  for(index = value->length; index < length; index++) {
+    limbs[index] = 0;
+  }
+
+  value->limbs = limbs;
+  value->length = length;
+}
+
+
+static void exact_value_trim(PolynomialExactValue *value) {
+  while(value->length > 0 && value->limbs[value->length - 1] == 0) {
+    value->length--;
+  }
+
+  if(value->length == 0) {
+    value->negative = 0;
+  }
+}
+
+
+static void exact_value_set_int128(PolynomialExactValue *value, __int128 number) {
+  unsigned __int128 magnitude = (number < 0) ? -(unsigned __int128) number : (unsigned __int128) number;
+
+  value->negative = (number < 0);
+  value->length = 0;
+  exact_value_reserve(value, 2);
+  value->limbs[0] = (unsigned long long) magnitude;
+  value->limbs[1] = (unsigned long long) (magnitude >> 64);
+  exact_value_trim(value);
+}
+
+
+// value = value * factor
+static void exact_value_multiply(PolynomialExactValue *value, long long factor) {
+  unsigned long long magnitude = (factor < 0) ? -(unsigned long long) factor : (unsigned long long) factor;
+
+  unsigned __int128 carry = 0;
+  unsigned long index;
+  for(index = 0; index < value->length; index++) {
+    unsigned __int128 product = (unsigned __int128) value->limbs[index] * magnitude + carry;
+    value->limbs[index] = (unsigned long long) product;
+    carry = product >> 64;
+  }
+
+  if(carry != 0) {
+    unsigned long length = value->length;
+    exact_value_reserve(value, length + 1);
+    value->limbs[length] = (unsigned long long) carry;
+  }
+
+  if(factor < 0) {
+    value->negative = !value->negative;
+  }
+
+  exact_value_trim(value);
+}
+
+
+// value = value + term
+static void exact_value_add(PolynomialExactValue *value, long long term) {
+  if(term == 0) {
+    return;
+  }
+
+  unsigned long long magnitude = (term < 0) ? -(unsigned long long) term : (unsigned long long) term;
+  int term_negative = (term < 0);
+
+  if(value->length == 0) {
+    exact_value_reserve(value, 1);
+    value->limbs[0] = magnitude;
+    value->negative = term_negative;
+    return;
+  }
+
+  unsigned long index;
+  if(value->negative == term_negative) {
+    // same signs: add the magnitudes
+    unsigned long long carry = magnitude;
+    for(index = 0; carry != 0 && index < value->length; index++) {
+      value->limbs[index] += carry;
+      carry = (value->limbs[index] < carry);
+    }
+
+    if(carry != 0) {
+      unsigned long length = value->length;
+      exact_value_reserve(value, length + 1);
+      value->limbs[length] = carry;
+    }
+  } else if(value->length == 1 && value->limbs[0] < magnitude) {
+    // the sign changes
+    value->limbs[0] = magnitude - value->limbs[0];
+    value->negative = term_negative;
+  } else {
+    // subtract the magnitudes
+    unsigned long long borrow = magnitude;
+    for(index = 0; borrow != 0 && index < value->length; index++) {
+      unsigned long long limb = value->limbs[index];
+      value->limbs[index] = limb - borrow;
+      borrow = (limb < borrow);
+    }
+  }
+
+  exact_value_trim(value);
+}
+
+
+/*
+ * @function polynomial_gather_monomials
+ *
+ * Stores pointers to the monomials of polynomial in an array, sorted in ascending order.
+ *
+ * @param Monomial **buffer
+ * Used if polynomial has no more than buffer_length monomials, else an array is allocated.
+ *
+ * @return Monomial**
+ * Must be freed with free after use if it is not buffer.
+ */
+static Monomial** polynomial_gather_monomials(const Polynomial* polynomial, Monomial **buffer, long buffer_length, long *length) {
+  *length = polynomial_count_monomials(polynomial);
+
+  Monomial **monomials = buffer;
+  if(*length > buffer_length) {
+    monomials = malloc(sizeof(Monomial*) * *length);
+    if(!monomials) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(Monomial*) * *length);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  long index = 0;
+  Monomial *current = polynomial->first;
+  while(current != NULL) {
+    monomials[index++] = current;
+    current = monomial_get_next(current);
+  }
+
+  return monomials;
+}
+
+
+POLYNOMIAL_EXACT_STATUS polynomial_compute_exact(const Polynomial* polynomial, long long x, PolynomialExactValue *result) {
+  assert(polynomial != NULL);
+  assert(result != NULL);
+
+  result->status = POLYNOMIAL_EXACT_INT64;
+  result->value = 0;
+  result->negative = 0;
+  result->length = 0;
+  result->limbs = NULL;
+
+  Monomial *buffer[EXACT_MONOMIALS_BUFFER];
+  long length;
+  Monomial **monomials = polynomial_gather_monomials(polynomial, buffer, EXACT_MONOMIALS_BUFFER, &length);
+
+  long index;
+  for(index = 0; index < length; index++) {
+    double coefficient = monomial_get_coefficient(monomials[index]);
+    if(coefficient != floor(coefficient) || coefficient < -9223372036854775808.0 || coefficient >= 9223372036854775808.0) {
+      result->status = POLYNOMIAL_EXACT_NOT_INTEGRAL;
+      break;
+    }
+  }
+
+  if(result->status == POLYNOMIAL_EXACT_NOT_INTEGRAL || length == 0) {
+    if(monomials != buffer) {
+      free(monomials);
+    }
+
+    return result->status;
+  }
+
+  /*
+   * Horner's scheme from the highest degree, multiplying by x once per degree skipped.
+   * When a step overflows, it is redone by the next stage, with more precision.
+   */
+  long degree = monomial_get_degree(monomials[length - 1]);
+  long next = length - 1;
+  int overflow = 0;
+
+  // 64 bits
+  long long value64 = 0;
+  for(; degree >= 0; degree--) {
+    int has_term = (next >= 0 && monomial_get_degree(monomials[next]) == degree);
+    long long term = has_term ? (long long) monomial_get_coefficient(monomials[next]) : 0;
+
+    long long product, sum;
+    if(__builtin_mul_overflow(value64, x, &product) || __builtin_add_overflow(product, term, &sum)) {
+      overflow = 1;
+      break;
+    }
+
+    value64 = sum;
+    if(has_term) {
+      next--;
+    }
+  }
+
+  if(!overflow) {
+    // no limb is needed, see exact_value_get_limbs
+    result->value = value64;
+    result->negative = (value64 < 0);
+  } else {
+    // 128 bits
+    result->status = POLYNOMIAL_EXACT_INT128;
+
+    const __int128 max128 = (__int128) (~(unsigned __int128) 0 >> 1);
+    const __int128 x_magnitude = (x < 0) ? -(__int128) x : (__int128) x;
+    __int128 value128 = value64;
+
+    overflow = 0;
+    for(; degree >= 0; degree--) {
+      int has_term = (next >= 0 && monomial_get_degree(monomials[next]) == degree);
+      long long term = has_term ? (long long) monomial_get_coefficient(monomials[next]) : 0;
+
+      __int128 magnitude = (value128 < 0) ? -value128 : value128;
+      if(x_magnitude != 0 && magnitude > max128 / x_magnitude) {
+        overflow = 1;
+        break;
+      }
+
+      __int128 product = value128 * x;
+      if((term > 0 && product > max128 - term) || (term < 0 && product < -max128 - term)) {
+        overflow = 1;
+        break;
+      }
+
+      value128 = product + term;
+      if(has_term) {
+        next--;
+      }
+    }
+
+    exact_value_set_int128(result, value128);
+
+    if(overflow) {
+      // multiple limbs
+      result->status = POLYNOMIAL_EXACT_MULTILIMB;
+
+      for(; degree >= 0; degree--) {
+        int has_term = (next >= 0 && monomial_get_degree(monomials[next]) == degree);
+        long long term = has_term ? (long long) monomial_get_coefficient(monomials[next]) : 0;
+
+        exact_value_multiply(result, x);
+        exact_value_add(result, term);
+
+        if(has_term) {
+          next--;
+        }
+      }
+    }
+  }
+
+  if(monomials != buffer) {
+    free(monomials);
+  }
+
+  return result->status;
+}
+
+
+/*
+ * @function exact_value_get_limbs
+ *
+ * Values which fit in 64 bits are not stored in limbs, this function gives a limb view of any value.
+ *
+ * @param unsigned long long *storage
+ * Used to store the limb of a 64-bit value.
+ */
+static const unsigned long long* exact_value_get_limbs(const PolynomialExactValue *value, unsigned long long *storage, unsigned long *length) {
+  if(value->status != POLYNOMIAL_EXACT_INT64) {
+    *length = value->length;
+    return value->limbs;
+  }
+
+  *storage = (value->value < 0) ? -(unsigned long long) value->value : (unsigned long long) value->value;
+  *length = (value->value != 0);
+
+  return storage;
+}
+
+
+int polynomial_exact_value_compare(const PolynomialExactValue *left, const PolynomialExactValue *right) {
+  assert(left != NULL);
+  assert(right != NULL);
+
+  if(left->status == POLYNOMIAL_EXACT_INT64 && right->status == POLYNOMIAL_EXACT_INT64) {
+    return (left->value > right->value) - (left->value < right->value);
+  }
+
+  unsigned long long left_storage, right_storage;
+  unsigned long left_length, right_length;
+  const unsigned long long *left_limbs = exact_value_get_limbs(left, &left_storage, &left_length);
+  const unsigned long long *right_limbs = exact_value_get_limbs(right, &right_storage, &right_length);
+
+  if(left->negative != right->negative) {
+    return left->negative ? -1 : 1;
+  }
+
+  int sign = left->negative ? -1 : 1;
+
+  if(left_length != right_length) {
+    return (left_length < right_length) ? -sign : sign;
+  }
+
+  unsigned long index = left_length;
+  while(index > 0) {
+    index--;
+    if(left_limbs[index] != right_limbs[index]) {
+      return (left_limbs[index] < right_limbs[index]) ? -sign : sign;
+    }
+  }
+
+  return 0;
+}
+
+
+void polynomial_exact_value_free(PolynomialExactValue *value) {
+  assert(value != NULL);
+
+  free(value->limbs);
+  value->limbs = NULL;
+  value->length = 0;
+}
+
+
+void polynomial_exact_value_print(const PolynomialExactValue *value, int newline) {
+  assert(value != NULL);
+
+  unsigned long long storage;
+  unsigned long length;
+  const unsigned long long *limbs = exact_value_get_limbs(value, &storage, &length);
+
+  if(length == 0) {
+    printf("0");
+  } else {
+    // split the magnitude in base 10^19 digits, by repeated divisions
+    const unsigned long long base = 10000000000000000000ULL;
+
+    unsigned long long *quotient = malloc(sizeof(unsigned long long) * length);
+    unsigned long long *digits = malloc(sizeof(unsigned long long) * (2 * length + 1));
+    if(!quotient || !digits) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long long) * (3 * length + 1));
+      exit(EXIT_FAILURE);
+    }
+
+    memcpy(quotient, limbs, sizeof(unsigned long long) * length);
+
+    unsigned long number_of_digits = 0;
+    while(length > 0) {
+      unsigned __int128 remainder = 0;
+      unsigned long index = length;
+      while(index > 0) {
+        index--;
+        unsigned __int128 current = (remainder << 64) | quotient[index];
+        quotient[index] = (unsigned long long) (current / base);
+        remainder = current % base;
+      }
+
+      digits[number_of_digits++] = (unsigned long long) remainder;
+
+      while(length > 0 && quotient[length - 1] == 0) {
+        length--;
+      }
+    }
+
+    if(value->negative) {
+      printf("-");
+    }
+
+    printf("%llu", digits[number_of_digits - 1]);
+    while(number_of_digits > 1) {
+      number_of_digits--;
+      printf("%019llu", digits[number_of_digits - 1]);
+    }
+
+    free(quotient);
+    free(digits);
+  }
+
+  if(newline) {
+    printf("\n");
+  }
+}
+
+
+Polynomial* polynomial_copy(const Polynomial* polynomial) {
+  assert(polynomial != NULL);
+
+  Polynomial *copy = polynomial_create_empty();
+
+  copy->degree = polynomial->degree;
+  copy->leading_coefficient = polynomial->leading_coefficient;
+
+  if(polynomial->first == NULL) {
+    return copy;
+  }
+
+  // share the monomials instead of duplicating them
+  long *references = __atomic_load_n(&polynomial->references, __ATOMIC_ACQUIRE);
+  if(references == NULL) {
+    long *new_references = malloc(sizeof(long));
+    if(!new_references) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(long));
+      exit(EXIT_FAILURE);
+    }
+    *new_references = 1;
+
+    // the counter is metadata: it may be installed in a const polynomial, by one thread only
+    if(__atomic_compare_exchange_n(&((Polynomial*) polynomial)->references, &references, new_references, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      references = new_references;
+    } else {
+      free(new_references);
+    }
+  }
+
+  __atomic_add_fetch(references, 1, __ATOMIC_RELAXED);
+
+  copy->first = polynomial->first;
+  copy->references = references;
+
+  return copy;
+}
+
+
+Polynomial* polynomial_create(const double *coefficients, unsigned int degree) {
+  assert(coefficients != NULL);
+
+  Polynomial *new_polynomial = polynomial_create_empty();
+
+  // polynomial_create({2., -4., 0, 3.}, 3) will create 2 -4x + 3x^3, null coefficients are skipped
+  polynomial_assign_coefficients(new_polynomial, coefficients, degree);
+
+  return new_polynomial;
+}
+
+
+Polynomial* polynomial_create_float(const float *coefficients, unsigned int degree) {
+  assert(coefficients != NULL);
+
+  Polynomial *new_polynomial = polynomial_create_empty();
+  Monomial *last = NULL;
+
+  unsigned int index;
+  for(index = 0; index < degree + 1; index++) {
+    if(is_coefficient_null(coefficients[index])) {
+      continue;
     }
 
-    cursor = tmp_cursor;
+    last = polynomial_append_monomial(new_polynomial, last, coefficients[index], index);
+  }
+
+  polynomial_set_last(new_polynomial, last);
+
+  return new_polynomial;
+}
+
+
+Polynomial** polynomial_create_from_file(const char* filename, int* length) {
+  assert(filename != NULL);
+  assert(length != NULL);
+
+  errno = 0;
+  FILE *file = fopen(filename, "r");
+  if(!file) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return 0;
+  }
+
+  // read number of lines
+  *length = 0;
+  int character = ' ';
+  while((character = fgetc(file)) != EOF) {
+    if(character == '\n') {
+      (*length)++;
+    }
+  }
+
+  Polynomial **polynomials = malloc(sizeof(Polynomial) * *length);
+  if(!polynomials) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(Polynomial) * (*length));
+    exit(EXIT_FAILURE);
+  }
+
+  rewind(file);
+
+  char line[MAX_STDIN_BUFFER_SIZE];
+
+  int line_index = 0;
+  for(; line_index < *length; line_index++) {
+    if(fgets(line, MAX_STDIN_BUFFER_SIZE, file) != line) {
+      fprintf(stderr, "Fatal error: file input is longer than maximum buffer size(%u)!\nExiting\n", MAX_STDIN_BUFFER_SIZE);
+      exit(EXIT_FAILURE);
+    }
+
+    char *end_of_line = strrchr(line, '\n');
+    if(end_of_line != NULL) {
+      *end_of_line = '\0';
+    }
+
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+    Polynomial *readp = polynomial_create_from_string(line);
+    if(!readp) {
+      if(polynomials_errno == POLYNOMIAL_INPUT_ERROR) {
+        fprintf(stderr, "Fatal error: malformatted input!\nExiting\n");
+        exit(EXIT_FAILURE);
+      }
+
+      continue;
+    }
+
+    polynomials[line_index] = readp;
+  }
+
+  fclose(file);
+
+  return polynomials;
+}
+
+
+Polynomial* polynomial_create_from_stdin(void) {
+  char input[MAX_STDIN_BUFFER_SIZE];
+
+  read_string_from_stdin(input);
+
+  return polynomial_create_from_string(input);
+}
+
+
+Polynomial* polynomial_create_from_string(char *string) {
+  assert(string != NULL);
+
+  // read a random number of numbers
+  // example string: 7x^3 + x^2 -9x + 30
+  // allowed characters: digits, +, -, x, ^
+
+  Polynomial* new_polynomial = polynomial_create_empty();
+  Monomial* previous_monomial = NULL;
+
+  char *cursor = string;
+  int first_monomial = 1;
 
-    long new_degree = monomial_get_degree(new_monomial);
-    if(max_monomial_degree < new_degree) {
-      max_monomial_degree = new_degree;
+  while(*cursor != '\0') {
+    monomials_errno = MONOMIAL_SUCCESS;
+
+    char *tmp_cursor = cursor;
+    Monomial *new_monomial = monomial_create_from_string(cursor, &tmp_cursor);
+    if(monomials_errno == MONOMIAL_INPUT_ERROR) {
+      polynomial_free(&new_polynomial);
+      polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+      return NULL;
     }
 
+    cursor = tmp_cursor;
+
     if(first_monomial) {
       new_polynomial->first = new_monomial;
       first_monomial = 0;
@@ -348,115 +1586,349 @@ Polynomial* polynomial_create_from_string(char *string) {
 
     previous_monomial = new_monomial;
 
-    // skip spaces
-    while(*cursor == ' ') {
-      cursor++;
-    }
-  }
+    // skip spaces
+    while(*cursor == ' ') {
+      cursor++;
+    }
+  }
+
+  /*
+   * bring the polynomial to its canonical form, in place:
+   * sort it, merge monomials of same degree (e.g. 2x - 6x) and remove null ones (e.g. 0x^12)
+   */
+  polynomial_reduct_in_place(new_polynomial);
+
+  if(!new_polynomial->first) {
+    // empty polynomial
+    polynomial_free(&new_polynomial);
+    return NULL;
+  }
+
+  return new_polynomial;
+}
+
+
+Polynomial* polynomial_derivative(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  Polynomial* new_polynomial = polynomial_create_empty();
+
+  Monomial *cursor_oldp = polynomial->first, *cursor_newp = NULL;
+  while(cursor_oldp != NULL) {
+    // constants vanish, the order of the others is unchanged
+    if(monomial_get_degree(cursor_oldp) > 0) {
+      Monomial *new_monomial = monomial_derivative(cursor_oldp);
+
+      if(cursor_newp == NULL) {
+        new_polynomial->first = new_monomial;
+      } else {
+        monomial_set_next(cursor_newp, new_monomial);
+      }
+      cursor_newp = new_monomial;
+    }
+
+    cursor_oldp = monomial_get_next(cursor_oldp);
+  }
+
+  polynomial_set_last(new_polynomial, cursor_newp);
+
+  return new_polynomial;
+}
+
+
+int polynomial_equals(const Polynomial* leftp, const Polynomial* rightp) {
+  assert(leftp != NULL);
+  assert(rightp != NULL);
+
+  if(leftp->degree != rightp->degree || leftp->leading_coefficient != rightp->leading_coefficient) {
+    return 0;
+  }
+
+  Monomial *left = leftp->first, *right = rightp->first;
+  // copies share their monomials
+  while(left != right) {
+    if(left == NULL || right == NULL
+      || monomial_get_degree(left) != monomial_get_degree(right)
+      || monomial_get_coefficient(left) != monomial_get_coefficient(right)) {
+      return 0;
+    }
+
+    left = monomial_get_next(left);
+    right = monomial_get_next(right);
+  }
+
+  return 1;
+}
+
+
+int polynomial_fingerprint(const Polynomial *polynomial, unsigned long long point, unsigned long long *fingerprint) {
+  assert(polynomial != NULL);
+  assert(fingerprint != NULL);
+
+  unsigned long long value = 0;
+
+  Monomial *monomial = polynomial->first;
+  while(monomial != NULL) {
+    unsigned long long term;
+    if(!coefficients_fingerprint_term(monomial_get_degree(monomial), monomial_get_coefficient(monomial), point, &term)) {
+      return 0;
+    }
+
+    value += term;
+    if(value >= COEFFICIENTS_FINGERPRINT_PRIME) {
+      value -= COEFFICIENTS_FINGERPRINT_PRIME;
+    }
+
+    monomial = monomial_get_next(monomial);
+  }
+
+  *fingerprint = value;
+  return 1;
+}
+
+
+unsigned long long polynomial_fingerprint_random_point(void) {
+  unsigned long long point = 0;
+
+  FILE *random = fopen("/dev/urandom", "rb");
+  if(random != NULL) {
+    if(fread(&point, sizeof(point), 1, random) != 1) {
+      point = 0;
+    }
+    fclose(random);
+  }
+
+  if(point == 0) {
+    // no /dev/urandom: good enough against accidental collisions, not against chosen polynomials
+    point = (unsigned long long) time(NULL) * 0x9e3779b97f4a7c15ULL ^ (unsigned long long) clock();
+  }
+
+  // 0 and 1 would only see the constant term, and the sum of coefficients
+  return 2 + point % (COEFFICIENTS_FINGERPRINT_PRIME - 2);
+}
+
+
+void polynomial_free(Polynomial** polynomial) {
+  assert(polynomial != NULL);
+  assert(*polynomial != NULL);
+
+  polynomial_release_monomials(*polynomial);
+
+  Monomial* current = (*polynomial)->spare, *next = NULL;
+  while(current != NULL) {
+    next = monomial_get_next(current);
+    monomial_free(&current);
+    current = next;
+  }
+
+  free(*polynomial);
+  *polynomial = NULL;
+}
+
+
+void polynomial_get_coefficients(const Polynomial *polynomial, double *coefficients) {
+  assert(polynomial != NULL);
+  assert(coefficients != NULL);
+
+  memset(coefficients, 0, sizeof(double) * (polynomial->degree + 1));
+
+  if(polynomial->first != NULL) {
+    polynomial_convert_to_array(polynomial, coefficients);
+  }
+}
+
+
+void polynomial_get_coefficients_float(const Polynomial *polynomial, float *coefficients) {
+  assert(polynomial != NULL);
+  assert(coefficients != NULL);
+
+  memset(coefficients, 0, sizeof(float) * (polynomial->degree + 1));
+
+  Monomial *current = polynomial->first;
+  while(current != NULL) {
+    coefficients[monomial_get_degree(current)] = (float) monomial_get_coefficient(current);
+    current = monomial_get_next(current);
+  }
+}
+
+
+Polynomial* polynomial_create_from_terms(const double *coefficients, const long *degrees, unsigned long number_of_terms) {
+  assert(number_of_terms == 0 || (coefficients != NULL && degrees != NULL));
+
+  Polynomial *new_polynomial = polynomial_create_empty();
+  Monomial *last = NULL;
+
+  unsigned long index;
+  for(index = 0; index < number_of_terms; index++) {
+    assert(index == 0 || degrees[index - 1] < degrees[index]);
+
+    if(is_coefficient_null(coefficients[index])) {
+      continue;
+    }
+
+    last = polynomial_append_monomial(new_polynomial, last, coefficients[index], degrees[index]);
+  }
+
+  polynomial_set_last(new_polynomial, last);
+
+  return new_polynomial;
+}
+
+
+POLYNOMIAL_COMPUTE_METHOD polynomial_get_compute_method(void) {
+  return polynomial_compute_method;
+}
+
+
+long polynomial_get_degree(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  return polynomial->degree;
+}
+
+
+Monomial* polynomial_get_first_monomial(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  return polynomial->first;
+}
+
+
+double polynomial_get_leading_coefficient(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  return polynomial->leading_coefficient;
+}
+
+
+long polynomial_get_number_of_monomials(const Polynomial *polynomial) {
+  return polynomial_count_monomials(polynomial);
+}
+
 
-  new_polynomial->degree = max_monomial_degree;
+unsigned long long polynomial_hash(const Polynomial *polynomial) {
+  return polynomial_hash_with_tolerance(polynomial, 0);
+}
 
-  // remove null monomials which may be there (e.g. 0x^12)
-  polynomial_remove_null_monomials(new_polynomial);
 
-  if(!new_polynomial->first) {
-    // empty polynomial
-    polynomial_free(&new_polynomial);
-    return NULL;
-  }
+unsigned long long polynomial_hash_with_tolerance(const Polynomial *polynomial, double tolerance) {
+  assert(polynomial != NULL);
+  assert(tolerance >= 0);
 
-  // reduct the polynomial (e.g. in case the user has input 2x - 6x)
-  Polynomial *reducted = polynomial_reduct(new_polynomial);
-  polynomial_free(&new_polynomial);
+  unsigned long long hash = 0;
 
-  if(!reducted->first) {
-    // empty polynomial
-    polynomial_free(&reducted);
-    return NULL;
+  Monomial *monomial = polynomial->first;
+  while(monomial != NULL) {
+    hash += coefficients_hash_term(monomial_get_degree(monomial), monomial_get_coefficient(monomial), tolerance);
+    monomial = monomial_get_next(monomial);
   }
 
-  return reducted;
+  return hash;
 }
 
 
-Polynomial* polynomial_derivative(const Polynomial *polynomial) {
+Polynomial* polynomial_power(const Polynomial *polynomial, int power) {
   assert(polynomial != NULL);
-  assert(polynomial->first != NULL);
-
-  Polynomial* new_polynomial = polynomial_create_empty();
-  new_polynomial->degree = polynomial->degree - 1;
-
-  if(new_polynomial->degree < 0) {
-    // a polynomial of degree < 0 is 0
-    new_polynomial->degree = 0;
-    new_polynomial->first = monomial_create(0, 0);
+  assert(power > 0);
 
-    return new_polynomial;
-  }
+  /*
+   * Binary exponentiation: the base is squared at each step and multiplied into the result when the bit of power is set.
+   * Each product goes through polynomial_product, which keeps sparse polynomials sparse.
+   */
+  Polynomial *result = NULL;
+  Polynomial *base = polynomial_copy(polynomial);
 
-  Monomial *cursor_oldp = polynomial->first, *cursor_newp = NULL;
-  int first = 1;
-  while(cursor_oldp != NULL) {
-    // compute its derivative
-    if(first) {
-      Monomial *new_monomial = monomial_derivative(cursor_oldp);
-      if(new_monomial != NULL) {
-        // degree >= 0, because 2 derivated gives 0, no need to add it to the polynomial
-        new_polynomial->first = new_monomial;
-        cursor_newp = new_monomial;
-        first = 0;
-      }
-    } else {
-      Monomial *new_monomial = monomial_derivative(cursor_oldp);
-      if(new_monomial != NULL) {
-        // degree >= 0, because 2 derivated gives 0, no need to add it to the polynomial
-        monomial_set_next(cursor_newp, new_monomial);
-        cursor_newp = new_monomial;
+  while(1) {
+    if(power & 1) {
+      if(result == NULL) {
+        result = polynomial_copy(base);
+      } else {
+        Polynomial *tmp = polynomial_product(result, base);
+        polynomial_free(&result);
+        result = tmp;
       }
     }
 
-    cursor_oldp = monomial_get_next(cursor_oldp);
+    power >>= 1;
+    if(power == 0) {
+      break;
+    }
+
+    Polynomial *square = polynomial_product(base, base);
+    polynomial_free(&base);
+    base = square;
   }
 
-  polynomial_remove_null_monomials(new_polynomial);
+  polynomial_free(&base);
 
-  return new_polynomial;
+  return result;
 }
 
 
-void polynomial_free(Polynomial** polynomial) {
+Polynomial* polynomial_power_truncated(const Polynomial *polynomial, int power, long order) {
   assert(polynomial != NULL);
-  assert(*polynomial != NULL);
+  assert(power > 0);
+  assert(order >= 0);
 
-  Monomial* current = (*polynomial)->first, *next = NULL;
-  while(current != NULL) {
-    next = monomial_get_next(current);
-    monomial_free(&current);
-    current = next;
+  if(order == 0) {
+    return polynomial_power(polynomial, power);
   }
 
-  free(*polynomial);
-  *polynomial = NULL;
-}
+  /*
+   * Binary exponentiation on dense coefficients, truncated to order:
+   * the base is squared at each step and multiplied into the result when the bit of power is set.
+   */
+  long max_degree = polynomial->degree * (long) power;
+  if(max_degree > order - 1) {
+    max_degree = order - 1;
+  }
+
+  double *base = polynomial_to_coefficients(polynomial);
+  double *result = malloc(sizeof(double) * (max_degree + 1));
+  double *tmp = malloc(sizeof(double) * (2 * max_degree + 1));
+  if(!result || !tmp) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (3 * max_degree + 2));
+    exit(EXIT_FAILURE);
+  }
 
+  long base_degree = (polynomial->degree < max_degree) ? polynomial->degree : max_degree;
+  long result_degree = 0;
+  result[0] = 1;
 
-Polynomial* polynomial_power(const Polynomial *polynomial, int power) {
-  assert(polynomial != NULL);
-  assert(power > 0);
+  while(power > 0) {
+    if(power & 1) {
+      long product_degree = (result_degree + base_degree < max_degree) ? result_degree + base_degree : max_degree;
+      coefficients_product_low(result, result_degree, base, base_degree, tmp, product_degree + 1);
+      result_degree = product_degree;
 
-  Polynomial *result = polynomial_copy(polynomial);
+      memcpy(result, tmp, sizeof(double) * (result_degree + 1));
+    }
+
+    power >>= 1;
+
+    if(power > 0) {
+      long square_degree = (2 * base_degree < max_degree) ? 2 * base_degree : max_degree;
+      double *square = malloc(sizeof(double) * (2 * base_degree + 1));
+      if(!square) {
+        fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (2 * base_degree + 1));
+        exit(EXIT_FAILURE);
+      }
 
-  while(power > 1) {
-    Polynomial *tmp = result;
-    result = polynomial_product(result, polynomial);
+      coefficients_product_low(base, base_degree, base, base_degree, square, square_degree + 1);
 
-    if(tmp != polynomial) {
-      polynomial_free(&tmp);
+      free(base);
+      base = square;
+      base_degree = square_degree;
     }
-    power--;
   }
 
-  return result;
+  Polynomial *powered = polynomial_create(result, result_degree);
+
+  free(base);
+  free(result);
+  free(tmp);
+
+  return powered;
 }
 
 
@@ -485,158 +1957,380 @@ Polynomial* polynomial_product(const Polynomial* leftp, const Polynomial* rightp
   assert(leftp != NULL);
   assert(rightp != NULL);
 
-  /*
-   * Steps for the product of two polynomials:
-   * - compute the degree of the product
-   * - create an array to store the product
-   * - compute the product by adding the product of each monomial in leftp with each monomial in rightp to the array
-   * - convert the array back to a polynomial
-   */
-
-  // compute the degree of the product
   long result_degree = leftp->degree + rightp->degree;
 
-  // create an array to store the product
-  double *result_coefficients = malloc(sizeof(double) * (result_degree + 1));
-  if(!result_coefficients) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (result_degree + 1));
-    exit(EXIT_FAILURE);
+  if(polynomial_product_is_sparse(polynomial_count_monomials(leftp), polynomial_count_monomials(rightp), result_degree)) {
+    return polynomial_product_sparse(leftp, rightp);
   }
 
-  int index_coefficient = 0;
-  for(; index_coefficient < result_degree + 1; index_coefficient++) {
-    result_coefficients[index_coefficient] = 0;
+  double *result_coefficients = polynomial_product_dense(leftp, rightp);
+
+  Polynomial *product = polynomial_create(result_coefficients, result_degree);
+
+  free(result_coefficients);
+
+  return product;
+}
+
+
+/*
+ * A prepared polynomial keeps a copy of itself, sharing its monomials, for sparse products,
+ * and its prepared coefficients for dense ones.
+ */
+struct PolynomialPrepared {
+  Polynomial *polynomial;
+  long number_of_monomials;
+  CoefficientsPrepared *coefficients;
+};
+
+
+PolynomialPrepared* polynomial_prepare(const Polynomial *polynomial) {
+  assert(polynomial != NULL);
+
+  PolynomialPrepared *prepared = malloc(sizeof(PolynomialPrepared));
+  if(!prepared) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(PolynomialPrepared));
+    exit(EXIT_FAILURE);
   }
 
-  // compute the product by adding the product of each monomial in leftp with each monomial in rightp to the array
-  Monomial *current = leftp->first;
-  while(current != NULL) {
-    Monomial *rightm = rightp->first;
+  prepared->polynomial = polynomial_copy(polynomial);
+  prepared->number_of_monomials = polynomial_count_monomials(polynomial);
+
+  double *coefficients = polynomial_to_coefficients(polynomial);
+  prepared->coefficients = coefficients_prepare(coefficients, polynomial->degree);
+  free(coefficients);
 
-    while(rightm != NULL) {
-      Monomial *productm = monomial_product(current, rightm);
+  return prepared;
+}
 
-      long productm_degree = monomial_get_degree(productm);
-      double productm_coefficient = monomial_get_coefficient(productm);
 
-      result_coefficients[productm_degree] += productm_coefficient;
+void polynomial_prepared_free(PolynomialPrepared **prepared) {
+  assert(prepared != NULL);
+  assert(*prepared != NULL);
 
-      monomial_free(&productm);
+  polynomial_free(&(*prepared)->polynomial);
+  coefficients_prepared_free(&(*prepared)->coefficients);
+  free(*prepared);
 
-      rightm = monomial_get_next(rightm);
-    }
+  *prepared = NULL;
+}
 
-    current = monomial_get_next(current);
+
+Polynomial* polynomial_product_prepared(PolynomialPrepared *prepared, const Polynomial *other) {
+  assert(prepared != NULL);
+  assert(other != NULL);
+
+  long result_degree = prepared->polynomial->degree + other->degree;
+
+  if(polynomial_product_is_sparse(prepared->number_of_monomials, polynomial_count_monomials(other), result_degree)) {
+    return polynomial_product_sparse(prepared->polynomial, other);
+  }
+
+  double *other_coefficients = polynomial_to_coefficients(other);
+  double *result_coefficients = malloc(sizeof(double) * (result_degree + 1));
+  if(!result_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (result_degree + 1));
+    exit(EXIT_FAILURE);
   }
 
+  coefficients_product_prepared(prepared->coefficients, other_coefficients, other->degree, result_coefficients);
+
   Polynomial *product = polynomial_create(result_coefficients, result_degree);
-  polynomial_remove_null_monomials(product);
 
+  free(other_coefficients);
   free(result_coefficients);
 
   return product;
 }
 
 
-Polynomial* polynomial_sum(const Polynomial* leftp, const Polynomial* rightp) {
-  assert(leftp != NULL);
-  assert(rightp != NULL);
+void polynomial_scale_variable(Polynomial* polynomial, double scale) {
+  assert(polynomial != NULL);
 
-  Polynomial *sum = polynomial_create_empty();
+  polynomial_make_unique(polynomial);
 
-  sum->degree = (leftp->degree > rightp->degree) ? leftp->degree : rightp->degree;
+  double *coefficients = polynomial_to_coefficients(polynomial);
 
-  // store the coefficients of rightp and leftp in a bidimensional array for better convenience
-  size_t size_coeff_array = sizeof(double) * (sum->degree + 1);
+  // a single pass with a running power of scale, instead of a pow per monomial
+  coefficients_scale_variable(coefficients, polynomial->degree, scale);
 
-  double **coeff_array = malloc(sizeof(double*) * 2);
-  if(!coeff_array) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double*));
-    exit(EXIT_FAILURE);
+  polynomial_assign_coefficients(polynomial, coefficients, polynomial->degree);
+
+  free(coefficients);
+}
+
+
+/*
+ * A pair of monomials waiting in the heap of polynomial_product_sparse.
+ */
+typedef struct {
+  long degree;
+  long index_left;
+  Monomial *right;
+} ProductHeapEntry;
+
+
+static void product_heap_push(ProductHeapEntry *heap, long *size, ProductHeapEntry entry) {
+  long index = (*size)++;
+
+  while(index > 0) {
+    long parent = (index - 1) / 2;
+    if(heap[parent].degree <= entry.degree) {
+      break;
+    }
+
+    heap[index] = heap[parent];
+    index = parent;
   }
 
-  coeff_array[0] = malloc(size_coeff_array);
-  if(!coeff_array[0]) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size_coeff_array);
-    exit(EXIT_FAILURE);
+  heap[index] = entry;
+}
+
+
+static ProductHeapEntry product_heap_pop(ProductHeapEntry *heap, long *size) {
+  ProductHeapEntry top = heap[0];
+  ProductHeapEntry last = heap[--(*size)];
+
+  long index = 0;
+  while(2 * index + 1 < *size) {
+    long child = 2 * index + 1;
+    if(child + 1 < *size && heap[child + 1].degree < heap[child].degree) {
+      child++;
+    }
+
+    if(last.degree <= heap[child].degree) {
+      break;
+    }
+
+    heap[index] = heap[child];
+    index = child;
   }
 
-  coeff_array[1] = malloc(size_coeff_array);
-  if(!coeff_array[1]) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size_coeff_array);
-    exit(EXIT_FAILURE);
+  heap[index] = last;
+
+  return top;
+}
+
+
+Polynomial* polynomial_product_sparse(const Polynomial* leftp, const Polynomial* rightp) {
+  assert(leftp != NULL);
+  assert(rightp != NULL);
+
+  Polynomial *product = polynomial_create_empty();
+
+  long number_of_left = polynomial_count_monomials(leftp);
+  if(number_of_left == 0 || rightp->first == NULL) {
+    return product;
   }
 
-  // initialize coefficients
-  int index_coeff = 0;
-  for(index_coeff = 0; index_coeff < sum->degree + 1; index_coeff++) {
-    coeff_array[0][index_coeff] = 0;
+  /*
+   * Both polynomials are sorted in ascending order, so left[i] * right[j] <= left[i] * right[j + 1]:
+   * the heap only needs to hold one pair per monomial of leftp,
+   * and pair (i + 1, first of rightp) is only pushed once (i, first of rightp) has been popped.
+   */
+  size_t size_arrays = (sizeof(Monomial*) + sizeof(ProductHeapEntry)) * number_of_left;
+  Monomial **left = malloc(sizeof(Monomial*) * number_of_left);
+  ProductHeapEntry *heap = malloc(sizeof(ProductHeapEntry) * number_of_left);
+  if(!left || !heap) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size_arrays);
+    exit(EXIT_FAILURE);
   }
 
-  for(index_coeff = 0; index_coeff < sum->degree + 1; index_coeff++) {
-    coeff_array[1][index_coeff] = 0;
+  long index = 0;
+  Monomial *current = leftp->first;
+  while(current != NULL) {
+    left[index++] = current;
+    current = monomial_get_next(current);
   }
 
-  polynomial_convert_to_array(leftp, coeff_array[0]);
-  polynomial_convert_to_array(rightp, coeff_array[1]);
+  long heap_size = 0;
+  ProductHeapEntry entry = {monomial_get_degree(left[0]) + monomial_get_degree(rightp->first), 0, rightp->first};
+  product_heap_push(heap, &heap_size, entry);
+
+  Monomial *last = NULL;
+  long degree = entry.degree;
+  double coefficient = 0;
+
+  while(heap_size > 0) {
+    entry = product_heap_pop(heap, &heap_size);
+
+    if(entry.degree != degree) {
+      // all the products of the previous degree have been merged
+      if(!is_coefficient_null(coefficient)) {
+        Monomial *new_monomial = monomial_create(coefficient, degree);
+        if(last == NULL) {
+          product->first = new_monomial;
+        } else {
+          monomial_set_next(last, new_monomial);
+        }
+        last = new_monomial;
+      }
 
-  Monomial *current = NULL;
-  for(index_coeff = 0; index_coeff < sum->degree + 1; index_coeff++) {
-    Monomial *new_monomial = monomial_create(
-      coeff_array[0][index_coeff] + coeff_array[1][index_coeff],
-      index_coeff
-    );
+      degree = entry.degree;
+      coefficient = 0;
+    }
 
-    if(index_coeff == 0) {
-      sum->first = new_monomial;
-    } else {
-      monomial_set_next(current, new_monomial);
+    coefficient += monomial_get_coefficient(left[entry.index_left]) * monomial_get_coefficient(entry.right);
+
+    if(entry.right == rightp->first && entry.index_left + 1 < number_of_left) {
+      ProductHeapEntry below = {
+        monomial_get_degree(left[entry.index_left + 1]) + monomial_get_degree(rightp->first),
+        entry.index_left + 1,
+        rightp->first
+      };
+      product_heap_push(heap, &heap_size, below);
+    }
+
+    Monomial *next = monomial_get_next(entry.right);
+    if(next != NULL) {
+      ProductHeapEntry right = {
+        monomial_get_degree(left[entry.index_left]) + monomial_get_degree(next),
+        entry.index_left,
+        next
+      };
+      product_heap_push(heap, &heap_size, right);
     }
+  }
 
-    current = new_monomial;
+  if(!is_coefficient_null(coefficient)) {
+    Monomial *new_monomial = monomial_create(coefficient, degree);
+    if(last == NULL) {
+      product->first = new_monomial;
+    } else {
+      monomial_set_next(last, new_monomial);
+    }
+    last = new_monomial;
   }
 
-  polynomial_remove_null_monomials(sum);
+  polynomial_set_last(product, last);
 
-  free(coeff_array[0]);
-  free(coeff_array[1]);
-  free(coeff_array);
+  free(left);
+  free(heap);
 
-  return sum;
+  return product;
 }
 
 
-Polynomial* polynomial_reduct(Polynomial* polynomial) {
+/*
+ * @function polynomial_series_apply
+ *
+ * Applies a coefficients_series_* kernel to polynomial, truncated to order.
+ */
+static Polynomial* polynomial_series_apply(const Polynomial *polynomial, long order, int (*kernel)(const double*, long, double*, long)) {
   assert(polynomial != NULL);
+  assert(order > 0);
 
-  // create an array to store the coefficients
-  double *coefficients = malloc(sizeof(double) * (polynomial->degree + 1));
-  if(!coefficients) {
-    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (polynomial->degree + 1));
+  double *coefficients = polynomial_to_coefficients(polynomial);
+  double *result = malloc(sizeof(double) * order);
+  if(!result) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * order);
     exit(EXIT_FAILURE);
   }
 
-  int index_coefficient = 0;
-  for(; index_coefficient < polynomial->degree + 1; index_coefficient++) {
-    coefficients[index_coefficient] = 0;
+  long degree = (polynomial->degree < order) ? polynomial->degree : order - 1;
+
+  Polynomial *series = NULL;
+  if(kernel(coefficients, degree, result, order)) {
+    series = polynomial_create(result, order - 1);
+  } else {
+    polynomials_errno = POLYNOMIAL_MATH_ERROR;
   }
 
-  // compute the product by adding the product of each monomial in leftp with each monomial in rightp to the array
-  Monomial *current = polynomial->first;
-  while(current != NULL) {
-    long degree = monomial_get_degree(current);
-    double coefficient = monomial_get_coefficient(current);
-    coefficients[degree] += coefficient;
-    
-    current = monomial_get_next(current);
+  free(coefficients);
+  free(result);
+
+  return series;
+}
+
+
+Polynomial* polynomial_series_exp(const Polynomial *polynomial, long order) {
+  return polynomial_series_apply(polynomial, order, coefficients_series_exp);
+}
+
+
+Polynomial* polynomial_series_inverse(const Polynomial *polynomial, long order) {
+  return polynomial_series_apply(polynomial, order, coefficients_series_inverse);
+}
+
+
+Polynomial* polynomial_series_log(const Polynomial *polynomial, long order) {
+  return polynomial_series_apply(polynomial, order, coefficients_series_log);
+}
+
+
+Polynomial* polynomial_series_product(const Polynomial* leftp, const Polynomial* rightp, long order) {
+  assert(leftp != NULL);
+  assert(rightp != NULL);
+  assert(order > 0);
+
+  double *left_coefficients = polynomial_to_coefficients(leftp);
+  double *right_coefficients = polynomial_to_coefficients(rightp);
+
+  long result_degree = leftp->degree + rightp->degree;
+  if(result_degree > order - 1) {
+    result_degree = order - 1;
+  }
+
+  double *result = malloc(sizeof(double) * (result_degree + 1));
+  if(!result) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (result_degree + 1));
+    exit(EXIT_FAILURE);
   }
 
-  Polynomial *reducted = polynomial_create(coefficients, polynomial->degree);
-  polynomial_remove_null_monomials(reducted);
+  coefficients_product_low(left_coefficients, leftp->degree, right_coefficients, rightp->degree, result, result_degree + 1);
+
+  Polynomial *product = polynomial_create(result, result_degree);
+
+  free(left_coefficients);
+  free(right_coefficients);
+  free(result);
+
+  return product;
+}
+
+
+Polynomial* polynomial_series_sqrt(const Polynomial *polynomial, long order) {
+  return polynomial_series_apply(polynomial, order, coefficients_series_sqrt);
+}
+
+
+void polynomial_set_compute_method(POLYNOMIAL_COMPUTE_METHOD method) {
+  polynomial_compute_method = (method == POLYNOMIAL_COMPUTE_DEFAULT) ? POLYNOMIAL_COMPUTE_LONG_DOUBLE : method;
+}
+
+
+Polynomial* polynomial_sum(const Polynomial* leftp, const Polynomial* rightp) {
+  assert(leftp != NULL);
+  assert(rightp != NULL);
+
+  // both are sorted: merging rightp into a copy of leftp gives the canonical sum
+  Polynomial *sum = polynomial_copy(leftp);
+  polynomial_add_into(sum, rightp);
+
+  return sum;
+}
+
+
+Polynomial* polynomial_reduct(Polynomial* polynomial) {
+  assert(polynomial != NULL);
+
+  // polynomials are always kept reducted
+  return polynomial_copy(polynomial);
+}
+
+
+Polynomial* polynomial_taylor_shift(const Polynomial* polynomial, double shift) {
+  assert(polynomial != NULL);
+
+  double *coefficients = polynomial_to_coefficients(polynomial);
+
+  coefficients_taylor_shift(coefficients, polynomial->degree, shift);
+
+  Polynomial *shifted = polynomial_create(coefficients, polynomial->degree);
 
   free(coefficients);
-  
-  return reducted;
+
+  return shifted;
 }
 
 
@@ -654,34 +2348,44 @@ int polynomial_write_to_file(const Polynomial** polynomials, unsigned int length
 
   unsigned int index;
   for(index = 0; index < length; index++) {
-    const Polynomial *currentp = polynomials[index];
-    if(!currentp) {
+    if(!polynomials[index]) {
       continue;
     }
 
-    Monomial *monomial = currentp->first;
-    while(monomial != NULL) {
-      if(monomial != currentp->first) {
-        if(monomial_get_coefficient(monomial) >= 0) {
-          fprintf(file, "+ ");
-        }
-      }
+    polynomial_write_to_stream(polynomials[index], file);
+  }
+
+  if(fclose(file) != 0) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    return 0;
+  }
+
+  return 1;
+}
+
 
-      fprintf(file,
-        "%.2lfx^%ld ",
-        monomial_get_coefficient(monomial),
-        monomial_get_degree(monomial)
-      );
+void polynomial_write_to_stream(const Polynomial* polynomial, FILE* stream) {
+  assert(polynomial != NULL);
+  assert(stream != NULL);
 
-      monomial = monomial_get_next(monomial);
+  Monomial *monomial = polynomial->first;
+  while(monomial != NULL) {
+    if(monomial != polynomial->first) {
+      if(monomial_get_coefficient(monomial) >= 0) {
+        fprintf(stream, "+ ");
+      }
     }
 
-    fprintf(file, "\n");
-  }
+    fprintf(stream,
+      "%.2lfx^%ld ",
+      monomial_get_coefficient(monomial),
+      monomial_get_degree(monomial)
+    );
 
-  fclose(file);
+    monomial = monomial_get_next(monomial);
+  }
 
-  return 1;
+  fprintf(stream, "\n");
 }
 
 
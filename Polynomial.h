@@ -2,9 +2,67 @@
 #ifndef H_POLYNOMIAL
 #define H_POLYNOMIAL
 
+#include <stdio.h>
+
+#include "Monomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// coefficients closer to 0 are null, and dropped
+#define POLYNOMIAL_NULL_TOLERANCE 0.0001
+
+/*
+ * Polynomials are always kept in canonical form:
+ * monomials sorted by ascending degree, merged when they have the same degree, and null ones removed.
+ * The null polynomial has no monomial, and its degree is 0.
+ */
 typedef struct Polynomial Polynomial;
 
 
+/*
+ * A polynomial prepared to be multiplied by many others, see polynomial_prepare.
+ */
+typedef struct PolynomialPrepared PolynomialPrepared;
+
+
+/*
+ * Precision needed by polynomial_compute_exact to hold the result.
+ */
+typedef enum {
+  POLYNOMIAL_EXACT_INT64,
+  POLYNOMIAL_EXACT_INT128,
+  POLYNOMIAL_EXACT_MULTILIMB,
+  POLYNOMIAL_EXACT_NOT_INTEGRAL // a coefficient is not an integer or doesn't fit in 64 bits: nothing was computed
+} POLYNOMIAL_EXACT_STATUS;
+
+
+/*
+ * Floating-point methods of evaluation, from the fastest to the most accurate for a double point.
+ */
+typedef enum {
+  POLYNOMIAL_COMPUTE_DEFAULT, // the method set by polynomial_set_compute_method
+  POLYNOMIAL_COMPUTE_DOUBLE, // Horner's method in double
+  POLYNOMIAL_COMPUTE_COMPENSATED, // Horner's method in double, with its rounding errors compensated: about twice as precise
+  POLYNOMIAL_COMPUTE_LONG_DOUBLE // Horner's method in long double, which isn't vectorized: the default
+} POLYNOMIAL_COMPUTE_METHOD;
+
+
+/*
+ * An exact integer, as computed by polynomial_compute_exact.
+ * Its magnitude is stored in 64-bit limbs, least significant first.
+ * If status is POLYNOMIAL_EXACT_INT64, value also holds the result.
+ */
+typedef struct {
+  POLYNOMIAL_EXACT_STATUS status;
+  long long value;
+  int negative;
+  unsigned long length;
+  unsigned long long *limbs;
+} PolynomialExactValue;
+
+
 typedef enum {
   POLYNOMIAL_SUCCESS,
   POLYNOMIAL_MATH_ERROR, // check errno for further information
@@ -15,19 +73,202 @@ typedef enum {
 /*
  * This variable must be set to SUCCESS before calling a polynomial_* function.
  * polynomial_* functions may change its value to indicate an error.
+ * Like errno, each thread has its own copy.
+ */
+extern __thread POLYNOMIALS_ERRNO polynomials_errno;
+
+
+/*
+ * In-place and accumulate-into functions.
+ * They modify an existing polynomial instead of returning a new one.
+ * Monomials which become useless are kept aside by the polynomial, and reused before allocating any new one.
+ */
+
+/*
+ * @function polynomial_add_into
+ *
+ * destination = destination + source
+ */
+extern void polynomial_add_into(Polynomial* destination, const Polynomial* source);
+
+
+/*
+ * @function polynomial_axpy
+ *
+ * destination = destination + factor * source
  */
-extern POLYNOMIALS_ERRNO polynomials_errno;
+extern void polynomial_axpy(Polynomial* destination, double factor, const Polynomial* source);
+
+
+/*
+ * @function polynomial_derivative_in_place
+ *
+ * polynomial = polynomial'
+ */
+extern void polynomial_derivative_in_place(Polynomial* polynomial);
+
+
+/*
+ * @function polynomial_mul_into
+ *
+ * destination = leftp * rightp
+ * destination may be leftp or rightp.
+ */
+extern void polynomial_mul_into(Polynomial* destination, const Polynomial* leftp, const Polynomial* rightp);
+
+
+/*
+ * @function polynomial_reduct_in_place
+ *
+ * Sorts the monomials of polynomial, merges those of same degree and removes null ones.
+ * E.g. 2x + 4x -> 6x
+ */
+extern void polynomial_reduct_in_place(Polynomial* polynomial);
+
+
+/*
+ * @function polynomial_scale
+ *
+ * polynomial = factor * polynomial
+ */
+extern void polynomial_scale(Polynomial* polynomial, double factor);
+
+
+/*
+ * @function polynomial_compose
+ *
+ * @return Polynomial*
+ * The composition p(q(x)). Must be freed with polynomial_free after use.
+ *
+ * @example
+ * p = 1 + x^2 and q = 1 + x give 2 + 2x + x^2
+ */
+extern Polynomial* polynomial_compose(const Polynomial* p, const Polynomial* q);
+
+
+/*
+ * @function polynomial_compose_modulo
+ *
+ * @return Polynomial*
+ * The remainder of p(q(x)) divided by r(x). Must be freed with polynomial_free after use.
+ * If r is null, polynomials_errno is set to POLYNOMIAL_MATH_ERROR and NULL is returned.
+ */
+extern Polynomial* polynomial_compose_modulo(const Polynomial* p, const Polynomial* q, const Polynomial* r);
 
 
 /*
  * @function polynomial_compute
  *
+ * Uses the method set by polynomial_set_compute_method, Horner's method in long double by default.
+ *
  * @return long double
  * The result of the computation of polynomial, with x given.
  */
 extern long double polynomial_compute(const Polynomial* polynomial, int x);
 
 
+/*
+ * @function polynomial_compute_derivatives
+ *
+ * Computes p(x), p'(x), ..., p^(count - 1)(x) in a single pass over the monomials, without any allocation.
+ * With count 0, nothing is computed and values isn't written.
+ *
+ * @param double *values
+ * Its length must be at least count. values[k] will be set to p^(k)(x).
+ *
+ * @example
+ * For 1 + x^3 at x = 2 with count = 3, values will contain {9, 12, 12}
+ */
+extern void polynomial_compute_derivatives(const Polynomial* polynomial, double x, double *values, unsigned int count);
+
+
+/*
+ * @function polynomial_compute_derivatives_batch
+ *
+ * Same as polynomial_compute_derivatives, at number_of_points points at once.
+ * Points are processed by vectors of 2, the width of a SSE2 register.
+ *
+ * @param double *values
+ * Its length must be at least number_of_points * count.
+ * values[i * count + k] will be set to p^(k)(points[i]).
+ */
+extern void polynomial_compute_derivatives_batch(const Polynomial* polynomial, const double *points, unsigned long number_of_points, double *values, unsigned int count);
+
+
+/*
+ * @function polynomial_compute_derivatives_complex
+ *
+ * Same as polynomial_compute_derivatives, at a complex x.
+ */
+extern void polynomial_compute_derivatives_complex(const Polynomial* polynomial, double _Complex x, double _Complex *values, unsigned int count);
+
+
+/*
+ * @function polynomial_compute_exact
+ *
+ * Computes polynomial at x exactly, for polynomials with integer coefficients.
+ * Horner's scheme runs in 64-bit integers, and is promoted to 128 bits and then to multiple limbs
+ * only when an overflow is detected.
+ *
+ * @param PolynomialExactValue *result
+ * Will hold the result. Must be released with polynomial_exact_value_free after use.
+ *
+ * @return POLYNOMIAL_EXACT_STATUS
+ * The precision that was needed, also stored in result->status.
+ */
+extern POLYNOMIAL_EXACT_STATUS polynomial_compute_exact(const Polynomial* polynomial, long long x, PolynomialExactValue *result);
+
+
+/*
+ * @function polynomial_compute_points
+ *
+ * Computes polynomial with every point, with method, several points at a time
+ * unless method is POLYNOMIAL_COMPUTE_LONG_DOUBLE.
+ *
+ * @param double *error_bounds
+ * NULL, or an array of at least number_of_points bounds, as in polynomial_compute_with_method.
+ */
+extern void polynomial_compute_points(const Polynomial* polynomial, const double *points, unsigned long number_of_points, double *values, POLYNOMIAL_COMPUTE_METHOD method, double *error_bounds);
+
+
+/*
+ * @function polynomial_compute_with_method
+ *
+ * @param double *error_bound
+ * If not NULL, set to a bound of the rounding error of the result, |result - p(x)|,
+ * computed along the evaluation from the magnitudes of the terms (or of the errors, with the compensated method).
+ *
+ * @return double
+ * The result of the computation of polynomial at x, with method.
+ */
+extern double polynomial_compute_with_method(const Polynomial* polynomial, double x, POLYNOMIAL_COMPUTE_METHOD method, double *error_bound);
+
+
+/*
+ * @function polynomial_exact_value_compare
+ *
+ * @return int
+ * < 0, 0 or > 0 whether left is lower than, equal to or greater than right.
+ */
+extern int polynomial_exact_value_compare(const PolynomialExactValue *left, const PolynomialExactValue *right);
+
+
+/*
+ * @function polynomial_exact_value_free
+ *
+ * Frees the limbs of value.
+ */
+extern void polynomial_exact_value_free(PolynomialExactValue *value);
+
+
+/*
+ * @function polynomial_exact_value_print
+ *
+ * Prints value in base 10 to stdout.
+ */
+extern void polynomial_exact_value_print(const PolynomialExactValue *value, int newline);
+
+
 /*
  * @function polynomial_copy
  */
@@ -45,6 +286,7 @@ extern Polynomial* polynomial_copy(const Polynomial* polynomial);
  *
  * @return Polynomial*
  * Must be freed with polynomial_free after use.
+ * Null coefficients are skipped.
  *
  * @example
  * polynomial_create({2., -4., 0, 3.}, 3) will create 2 -4x + 3x^2
@@ -52,6 +294,14 @@ extern Polynomial* polynomial_copy(const Polynomial* polynomial);
 extern Polynomial* polynomial_create(const double *coefficients, unsigned int degree);
 
 
+/*
+ * @function polynomial_create_float
+ *
+ * Same as polynomial_create, with coefficients stored as floats, such as those of polynomial_get_coefficients_float.
+ */
+extern Polynomial* polynomial_create_float(const float *coefficients, unsigned int degree);
+
+
 /*
  * @function polynomial_create_from_file
  *
@@ -71,6 +321,7 @@ extern Polynomial** polynomial_create_from_file(const char* filename, int* lengt
  * @return Polynomial*
  * A polynomial read from stdin.
  * Must be freed with polynomial_free after use.
+ * NULL in the same cases as polynomial_create_from_string.
  *
  * @example
  * If stdin contains "7x^3 + x^2 -9x + 30", it will create polynomial 7x^3 + x^2 -9x + 30
@@ -84,6 +335,8 @@ extern Polynomial* polynomial_create_from_stdin(void);
  * @return Polynomial*
  * A polynomial read from the string.
  * Must be freed with polynomial_free after use.
+ * NULL if the string holds the null polynomial,
+ * or if it is malformed: polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
  *
  * @example
  * If string contains "7x^3 + x^2 -9x + 30", it will create polynomial 7x^3 + x^2 -9x + 30
@@ -91,6 +344,22 @@ extern Polynomial* polynomial_create_from_stdin(void);
 extern Polynomial* polynomial_create_from_string(char *string);
 
 
+/*
+ * @function polynomial_create_from_terms
+ *
+ * Creates a polynomial from its terms, without the dense array of polynomial_create:
+ * the memory used only depends on number_of_terms, whatever the degrees.
+ *
+ * @param const long *degrees
+ * Sorted in strictly ascending order, degrees[i] being the degree of coefficients[i].
+ *
+ * @return Polynomial*
+ * Must be freed with polynomial_free after use.
+ * Null coefficients are skipped.
+ */
+extern Polynomial* polynomial_create_from_terms(const double *coefficients, const long *degrees, unsigned long number_of_terms);
+
+
 /*
  * @function polynomial_derivative
  *
@@ -100,6 +369,44 @@ extern Polynomial* polynomial_create_from_string(char *string);
 extern Polynomial* polynomial_derivative(const Polynomial *polynomial);
 
 
+/*
+ * @function polynomial_equals
+ *
+ * Compares the monomials of leftp and rightp exactly, without any tolerance.
+ * Runs in constant time when one is a copy of the other.
+ *
+ * @return int
+ * 1 if leftp and rightp are the same polynomial, 0 otherwise.
+ */
+extern int polynomial_equals(const Polynomial* leftp, const Polynomial* rightp);
+
+
+/*
+ * @function polynomial_fingerprint
+ *
+ * Computes polynomial(point) modulo the prime 2^61 - 1, exactly, in O(n log(degree)).
+ * Fingerprints at a random point are an equality test for polynomials with integer coefficients:
+ * two different polynomials of degree <= n have the same one with probability at most n / (2^61 - 1).
+ * Unlike polynomial_equals, it works on the results of different computations: they are never compared term by term.
+ *
+ * @param unsigned long long point
+ * Should be drawn with polynomial_fingerprint_random_point, and be the same for the polynomials compared.
+ *
+ * @return int
+ * 1 on success, 0 if a coefficient of polynomial is not an integer or doesn't fit in 63 bits.
+ */
+extern int polynomial_fingerprint(const Polynomial *polynomial, unsigned long long point, unsigned long long *fingerprint);
+
+
+/*
+ * @function polynomial_fingerprint_random_point
+ *
+ * @return unsigned long long
+ * A random point for polynomial_fingerprint, read from /dev/urandom when it exists.
+ */
+extern unsigned long long polynomial_fingerprint_random_point(void);
+
+
 /*
  * @function polynomial_free
  *
@@ -108,6 +415,97 @@ extern Polynomial* polynomial_derivative(const Polynomial *polynomial);
 extern void polynomial_free(Polynomial** polynomial);
 
 
+/*
+ * @function polynomial_get_coefficients
+ *
+ * Copies the coefficients of polynomial into a dense array, sorted in ascending order.
+ *
+ * @param double *coefficients
+ * Its length must be at least polynomial_get_degree(polynomial) + 1.
+ * Degrees without monomial are set to 0.
+ */
+extern void polynomial_get_coefficients(const Polynomial *polynomial, double *coefficients);
+
+
+/*
+ * @function polynomial_get_coefficients_float
+ *
+ * Same as polynomial_get_coefficients, each coefficient rounded to the nearest float:
+ * half the memory, for a relative error of at most 2^-24 (about 6e-8) per coefficient.
+ * Coefficients beyond 3.4e38 in absolute value become infinite.
+ */
+extern void polynomial_get_coefficients_float(const Polynomial *polynomial, float *coefficients);
+
+
+/*
+ * @function polynomial_get_compute_method
+ *
+ * @return POLYNOMIAL_COMPUTE_METHOD
+ * The method set by polynomial_set_compute_method, POLYNOMIAL_COMPUTE_LONG_DOUBLE if it was never called.
+ */
+extern POLYNOMIAL_COMPUTE_METHOD polynomial_get_compute_method(void);
+
+
+/*
+ * @function polynomial_get_degree
+ *
+ * Runs in constant time.
+ */
+extern long polynomial_get_degree(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_get_first_monomial
+ *
+ * @return Monomial*
+ * The monomial of lowest degree of polynomial, NULL for the null polynomial.
+ * The others follow by ascending degree, with monomial_get_next.
+ * They are read-only: they may be shared with copies of polynomial.
+ */
+extern Monomial* polynomial_get_first_monomial(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_get_leading_coefficient
+ *
+ * Runs in constant time.
+ *
+ * @return double
+ * The coefficient of the monomial of highest degree, 0 for the null polynomial.
+ */
+extern double polynomial_get_leading_coefficient(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_get_number_of_monomials
+ *
+ * @return long
+ * The number of non-null monomials of polynomial, 0 for the null polynomial.
+ */
+extern long polynomial_get_number_of_monomials(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_hash
+ *
+ * Hashes the monomials of polynomial in a single pass, see coefficients_hash.
+ *
+ * @return unsigned long long
+ * A hash of polynomial. Polynomials for which polynomial_equals returns 1 have the same hash,
+ * and a polynomial has the same hash in a PolynomialBatch.
+ */
+extern unsigned long long polynomial_hash(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_hash_with_tolerance
+ *
+ * Same as polynomial_hash, with coefficients first rounded to the nearest multiple of tolerance.
+ * Coefficients rounded to 0 are ignored. tolerance 0 is polynomial_hash.
+ */
+extern unsigned long long polynomial_hash_with_tolerance(const Polynomial *polynomial, double tolerance);
+
+
 /*
  * @function polynomial_power
  *
@@ -117,6 +515,40 @@ extern void polynomial_free(Polynomial** polynomial);
 extern Polynomial* polynomial_power(const Polynomial *polynomial, int power);
 
 
+/*
+ * @function polynomial_power_truncated
+ *
+ * @param long order
+ * Only the terms of degree < order are computed. 0 means no truncation.
+ *
+ * @return Polynomial*
+ * The result of polynomial ^ power mod x^order. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_power_truncated(const Polynomial *polynomial, int power, long order);
+
+
+/*
+ * @function polynomial_prepare
+ *
+ * Prepares polynomial for repeated products by polynomial_product_prepared:
+ * the FFT of its coefficients is computed once for each size of product, on first use, and kept,
+ * with the roots of unity of that size. A product then costs two FFTs instead of three.
+ * polynomial may be modified or freed afterwards.
+ *
+ * @return PolynomialPrepared*
+ * Must be freed with polynomial_prepared_free after use.
+ */
+extern PolynomialPrepared* polynomial_prepare(const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_prepared_free
+ *
+ * Frees associated resources, transforms included, and sets *prepared to NULL to prevent further use.
+ */
+extern void polynomial_prepared_free(PolynomialPrepared **prepared);
+
+
 /*
  * @function polynomial_print
  *
@@ -128,22 +560,127 @@ extern void polynomial_print(const Polynomial* polynomial, int newline);
 /*
  * @function polynomial_product
  *
+ * Sparse operands are multiplied by polynomial_product_sparse, dense ones by coefficients_product,
+ * through a FFT from degree 32 up. The product of integral polynomials is exact.
+ * polynomial_mul_into and polynomial_product_prepared give the same result.
+ *
  * @return Polynomial*
  * The result of the product of leftp and rightp. Must be freed with polynomial_free after use.
  */
 extern Polynomial* polynomial_product(const Polynomial* leftp, const Polynomial* rightp);
 
 
+/*
+ * @function polynomial_product_prepared
+ *
+ * Multiplies the prepared polynomial by other, with the same result as polynomial_product.
+ * Sparse operands go through polynomial_product_sparse, as they do there.
+ * Several threads may use the same prepared polynomial at once.
+ *
+ * @return Polynomial*
+ * The product. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_product_prepared(PolynomialPrepared *prepared, const Polynomial *other);
+
+
+/*
+ * @function polynomial_product_sparse
+ *
+ * Computes the product of leftp and rightp without any dense array,
+ * generating the products of terms in ascending degree order with a binary heap (Johnson's algorithm).
+ * Like terms are merged on the fly, so memory is proportional to the number of terms.
+ * polynomial_product switches to it automatically when its operands are sparse.
+ *
+ * @return Polynomial*
+ * The result of the product of leftp and rightp. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_product_sparse(const Polynomial* leftp, const Polynomial* rightp);
+
+
 /*
  * @function polynomial_reduct
  *
  * @return Polynomial*
  * The reducted version of the polynomial. Must be freed with polynomial_free after use.
  * E.g. 2x + 4x -> 6x
+ * As polynomials are always kept reducted, this is a copy.
  */
 extern Polynomial* polynomial_reduct(Polynomial* polynomial);
 
 
+/*
+ * @function polynomial_scale_variable
+ *
+ * Replaces polynomial p(x) with p(scale * x), in place.
+ *
+ * @example
+ * 1 + 2x + 3x^2 scaled by 2 becomes 1 + 4x + 12x^2
+ */
+extern void polynomial_scale_variable(Polynomial* polynomial, double scale);
+
+
+/*
+ * Power series functions.
+ * They consider polynomial as a power series and compute their result mod x^order, with order > 0.
+ * The results must be freed with polynomial_free after use.
+ * If the constant term of polynomial is not in the function's domain,
+ * polynomials_errno is set to POLYNOMIAL_MATH_ERROR and NULL is returned.
+ */
+
+/*
+ * @function polynomial_series_exp
+ *
+ * @example
+ * polynomial_series_exp(x, 4) gives 1 + x + 0.5x^2 + 0.17x^3
+ */
+extern Polynomial* polynomial_series_exp(const Polynomial *polynomial, long order);
+
+
+/*
+ * @function polynomial_series_inverse
+ *
+ * The constant term must not be 0.
+ *
+ * @example
+ * polynomial_series_inverse(1 - x, 4) gives 1 + x + x^2 + x^3
+ */
+extern Polynomial* polynomial_series_inverse(const Polynomial *polynomial, long order);
+
+
+/*
+ * @function polynomial_series_log
+ *
+ * The constant term must be > 0.
+ */
+extern Polynomial* polynomial_series_log(const Polynomial *polynomial, long order);
+
+
+/*
+ * @function polynomial_series_product
+ *
+ * The product of leftp and rightp, of which only the terms of degree < order are computed.
+ */
+extern Polynomial* polynomial_series_product(const Polynomial* leftp, const Polynomial* rightp, long order);
+
+
+/*
+ * @function polynomial_series_sqrt
+ *
+ * The constant term must be > 0.
+ */
+extern Polynomial* polynomial_series_sqrt(const Polynomial *polynomial, long order);
+
+
+/*
+ * @function polynomial_set_compute_method
+ *
+ * Sets the method used by polynomial_compute, and by the other functions given POLYNOMIAL_COMPUTE_DEFAULT,
+ * for the whole program. It should be set before threads start computing.
+ * POLYNOMIAL_COMPUTE_DEFAULT sets it back to POLYNOMIAL_COMPUTE_LONG_DOUBLE.
+ */
+extern void polynomial_set_compute_method(POLYNOMIAL_COMPUTE_METHOD method);
+
+
 /*
  * @function polynomial_sum
  *
@@ -153,6 +690,18 @@ extern Polynomial* polynomial_reduct(Polynomial* polynomial);
 extern Polynomial* polynomial_sum(const Polynomial* leftp, const Polynomial* rightp);
 
 
+/*
+ * @function polynomial_taylor_shift
+ *
+ * @return Polynomial*
+ * The polynomial p(x + shift). Must be freed with polynomial_free after use.
+ *
+ * @example
+ * x^2 shifted by 1 gives 1 + 2x + x^2
+ */
+extern Polynomial* polynomial_taylor_shift(const Polynomial* polynomial, double shift);
+
+
 /*
  * @function polynomial_write_to_file
  *
@@ -164,5 +713,17 @@ extern Polynomial* polynomial_sum(const Polynomial* leftp, const Polynomial* rig
 extern int polynomial_write_to_file(const Polynomial** polynomials, unsigned int length, const char* filename);
 
 
+/*
+ * @function polynomial_write_to_stream
+ *
+ * Writes polynomial to stream on a single line, in the format used by polynomial_write_to_file.
+ */
+extern void polynomial_write_to_stream(const Polynomial* polynomial, FILE* stream);
+
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
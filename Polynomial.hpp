@@ -0,0 +1,403 @@
+#ifndef HPP_POLYNOMIAL
+#define HPP_POLYNOMIAL
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Polynomial.h"
+
+/*
+ * C++17 layer over the C API, in namespace polynomials.
+ * The C type keeps the name ::Polynomial, so this one can't be brought in with a using declaration.
+ *
+ * polynomials::Polynomial owns a C Polynomial and frees it when it goes out of scope.
+ * It can be moved, which only transfers the pointer, but not copied: clone() makes an explicit copy,
+ * sharing its monomials with the original (see polynomial_copy).
+ *
+ * Arithmetic operators don't compute anything: they build an expression,
+ * which is evaluated when it is converted to a Polynomial.
+ * Sums, differences, scalings and derivatives are then fused into a single merge of the monomials of their operands,
+ * by ascending degree, without any intermediate polynomial: a * 2. + derivative(b) - c reads each monomial of a, b and c once.
+ * The cost only depends on the number of monomials, not on the degrees: x^1000000 is a single term.
+ * Products are computed by polynomial_product when the expression is evaluated.
+ *
+ * An expression refers to its operands: it must be evaluated before they are destroyed, so don't keep it in an auto variable.
+ */
+
+namespace polynomials {
+
+class Polynomial;
+
+
+/*
+ * Every node of an expression is a cursor over the terms of its result, by strictly ascending degree:
+ * - void prepare(), called once before evaluation, which computes its products and moves to the first term,
+ * - long current() const, the degree of the current term, end once they are all read,
+ * - double coefficient() const, the coefficient of the current term, which may be null after a cancellation,
+ * - void advance(), which moves to the next term.
+ */
+struct Expression {
+  static constexpr long end = std::numeric_limits<long>::max();
+};
+
+template<class Type>
+constexpr bool is_expression = std::is_base_of_v<Expression, Type>;
+
+template<class Type>
+constexpr bool is_operand = is_expression<Type> || std::is_same_v<Type, Polynomial>;
+
+
+/*
+ * A leaf of an expression: a Polynomial, whose monomials are read in place.
+ */
+class TerminalExpression : public Expression {
+ public:
+  explicit TerminalExpression(const ::Polynomial *polynomial) : polynomial_(polynomial) {}
+
+  void prepare() { monomial_ = polynomial_get_first_monomial(polynomial_); }
+  long current() const { return (monomial_ != nullptr) ? monomial_get_degree(monomial_) : end; }
+  double coefficient() const { return monomial_get_coefficient(monomial_); }
+  void advance() { monomial_ = monomial_get_next(monomial_); }
+
+  const ::Polynomial* get() const { return polynomial_; }
+
+ private:
+  const ::Polynomial *polynomial_;
+  Monomial *monomial_ = nullptr;
+};
+
+
+/*
+ * @function evaluate_terms
+ *
+ * Reads the terms of a prepared expression into a new polynomial, which must be freed with polynomial_free.
+ * Only its terms are stored, never a dense array of coefficients.
+ */
+template<class Type>
+::Polynomial* evaluate_terms(Type &expression) {
+  std::vector<double> coefficients;
+  std::vector<long> degrees;
+  for(; expression.current() != Expression::end; expression.advance()) {
+    coefficients.push_back(expression.coefficient());
+    degrees.push_back(expression.current());
+  }
+
+  return polynomial_create_from_terms(coefficients.data(), degrees.data(), coefficients.size());
+}
+
+
+template<class Left, class Right>
+class SumExpression : public Expression {
+ public:
+  SumExpression(Left left, Right right) : left_(std::move(left)), right_(std::move(right)) {}
+
+  void prepare() { left_.prepare(); right_.prepare(); }
+  long current() const { return std::min(left_.current(), right_.current()); }
+
+  double coefficient() const {
+    long degree = current();
+    return ((left_.current() == degree) ? left_.coefficient() : 0) + ((right_.current() == degree) ? right_.coefficient() : 0);
+  }
+
+  void advance() {
+    long degree = current();
+    if(left_.current() == degree) left_.advance();
+    if(right_.current() == degree) right_.advance();
+  }
+
+ private:
+  Left left_;
+  Right right_;
+};
+
+
+template<class Left, class Right>
+class DifferenceExpression : public Expression {
+ public:
+  DifferenceExpression(Left left, Right right) : left_(std::move(left)), right_(std::move(right)) {}
+
+  void prepare() { left_.prepare(); right_.prepare(); }
+  long current() const { return std::min(left_.current(), right_.current()); }
+
+  double coefficient() const {
+    long degree = current();
+    return ((left_.current() == degree) ? left_.coefficient() : 0) - ((right_.current() == degree) ? right_.coefficient() : 0);
+  }
+
+  void advance() {
+    long degree = current();
+    if(left_.current() == degree) left_.advance();
+    if(right_.current() == degree) right_.advance();
+  }
+
+ private:
+  Left left_;
+  Right right_;
+};
+
+
+template<class Operand>
+class ScaleExpression : public Expression {
+ public:
+  ScaleExpression(Operand operand, double factor) : operand_(std::move(operand)), factor_(factor) {}
+
+  void prepare() { operand_.prepare(); }
+  long current() const { return operand_.current(); }
+  double coefficient() const { return factor_ * operand_.coefficient(); }
+  void advance() { operand_.advance(); }
+
+ private:
+  Operand operand_;
+  double factor_;
+};
+
+
+template<class Operand>
+class DerivativeExpression : public Expression {
+ public:
+  explicit DerivativeExpression(Operand operand) : operand_(std::move(operand)) {}
+
+  void prepare() {
+    operand_.prepare();
+    // the constant term vanishes
+    if(operand_.current() == 0) {
+      operand_.advance();
+    }
+  }
+
+  long current() const { return (operand_.current() != end) ? operand_.current() - 1 : end; }
+  double coefficient() const { return operand_.current() * operand_.coefficient(); }
+  void advance() { operand_.advance(); }
+
+ private:
+  Operand operand_;
+};
+
+
+/*
+ * A product is the only node which needs memory for its result:
+ * its operands which aren't leaves are evaluated into polynomials, then multiplied by polynomial_product,
+ * which keeps sparse operands sparse and switches to a FFT for big dense ones.
+ * The result is then read like a leaf.
+ */
+template<class Left, class Right>
+class ProductExpression : public Expression {
+ public:
+  ProductExpression(Left left, Right right) : left_(std::move(left)), right_(std::move(right)) {}
+
+  void prepare() {
+    std::shared_ptr<::Polynomial> left, right;
+    result_ = share(polynomial_product(operand_polynomial(left_, left), operand_polynomial(right_, right)));
+    terms_ = TerminalExpression(result_.get());
+    terms_.prepare();
+  }
+
+  long current() const { return terms_.current(); }
+  double coefficient() const { return terms_.coefficient(); }
+  void advance() { terms_.advance(); }
+
+  const Left& left() const { return left_; }
+  const Right& right() const { return right_; }
+
+ private:
+  static std::shared_ptr<::Polynomial> share(::Polynomial *polynomial) {
+    return std::shared_ptr<::Polynomial>(polynomial, [](::Polynomial *shared) { polynomial_free(&shared); });
+  }
+
+  // the polynomial of operand, evaluated into storage unless it is a leaf
+  template<class Operand>
+  static const ::Polynomial* operand_polynomial(Operand &operand, std::shared_ptr<::Polynomial> &storage) {
+    if constexpr(std::is_same_v<Operand, TerminalExpression>) {
+      return operand.get();
+    } else {
+      operand.prepare();
+      storage = share(evaluate_terms(operand));
+      return storage.get();
+    }
+  }
+
+  Left left_;
+  Right right_;
+  std::shared_ptr<::Polynomial> result_; // shared, so that an expression can be copied into a bigger one
+  TerminalExpression terms_ = TerminalExpression(nullptr);
+};
+
+
+class Polynomial {
+ public:
+  // the null polynomial
+  Polynomial() : Polynomial({ 0. }) {}
+
+  // coefficients sorted in ascending order: { 1, 0, 3 } is 1 + 3x^2
+  Polynomial(std::initializer_list<double> coefficients)
+    : polynomial_((assert(coefficients.size() > 0), polynomial_create(coefficients.begin(), (unsigned int) coefficients.size() - 1))) {}
+
+  // takes ownership of polynomial, which must not be freed by the caller
+  explicit Polynomial(::Polynomial *polynomial) noexcept : polynomial_(polynomial) {}
+
+  // evaluates expression in a single pass over its monomials
+  template<class Type, std::enable_if_t<is_expression<Type>, int> = 0>
+  Polynomial(const Type &expression) : polynomial_(evaluate(expression)) {}
+
+  Polynomial(Polynomial &&other) noexcept : polynomial_(std::exchange(other.polynomial_, nullptr)) {}
+
+  Polynomial& operator=(Polynomial &&other) noexcept {
+    std::swap(polynomial_, other.polynomial_);
+    return *this;
+  }
+
+  Polynomial(const Polynomial&) = delete;
+  Polynomial& operator=(const Polynomial&) = delete;
+
+  ~Polynomial() {
+    if(polynomial_ != nullptr) {
+      polynomial_free(&polynomial_);
+    }
+  }
+
+  /*
+   * Parses string, in the format of polynomial_create_from_string.
+   * Throws std::invalid_argument if it is malformed.
+   */
+  static Polynomial from_string(const std::string &string) {
+    std::vector<char> buffer(string.begin(), string.end());
+    buffer.push_back('\0');
+
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+    ::Polynomial *polynomial = polynomial_create_from_string(buffer.data());
+    if(polynomial == nullptr) {
+      if(polynomials_errno == POLYNOMIAL_INPUT_ERROR) {
+        throw std::invalid_argument("malformed polynomial: " + string);
+      }
+      return Polynomial();
+    }
+
+    return Polynomial(polynomial);
+  }
+
+  // a copy sharing its monomials with this one, in constant time
+  Polynomial clone() const { return Polynomial(polynomial_copy(get())); }
+
+  const ::Polynomial* get() const noexcept { return polynomial_; }
+  ::Polynomial* get() noexcept { return polynomial_; }
+
+  // gives up ownership: the result must be freed with polynomial_free
+  ::Polynomial* release() noexcept { return std::exchange(polynomial_, nullptr); }
+
+  long degree() const { return polynomial_get_degree(get()); }
+  double leading_coefficient() const { return polynomial_get_leading_coefficient(get()); }
+  unsigned long long hash() const { return polynomial_hash(get()); }
+
+  std::vector<double> coefficients() const {
+    std::vector<double> coefficients(degree() + 1);
+    polynomial_get_coefficients(get(), coefficients.data());
+    return coefficients;
+  }
+
+  double operator()(double x) const {
+    double value;
+    polynomial_compute_derivatives(get(), x, &value, 1);
+    return value;
+  }
+
+  Polynomial power(int power) const { return Polynomial(polynomial_power(get(), power)); }
+
+  Polynomial& operator+=(const Polynomial &other) {
+    polynomial_add_into(get(), other.get());
+    return *this;
+  }
+
+  Polynomial& operator-=(const Polynomial &other) {
+    polynomial_axpy(get(), -1, other.get());
+    return *this;
+  }
+
+  Polynomial& operator*=(double factor) {
+    polynomial_scale(get(), factor);
+    return *this;
+  }
+
+  bool operator==(const Polynomial &other) const { return polynomial_equals(get(), other.get()); }
+  bool operator!=(const Polynomial &other) const { return !(*this == other); }
+
+ private:
+  template<class Type>
+  static ::Polynomial* evaluate(Type expression) {
+    expression.prepare();
+    return evaluate_terms(expression);
+  }
+
+  // a product of two polynomials alone goes straight to polynomial_product, which also handles sparse operands
+  static ::Polynomial* evaluate(const ProductExpression<TerminalExpression, TerminalExpression> &expression) {
+    return polynomial_product(expression.left().get(), expression.right().get());
+  }
+
+  ::Polynomial *polynomial_;
+};
+
+
+template<class Type>
+auto as_expression(const Type &operand) {
+  if constexpr(std::is_same_v<Type, Polynomial>) {
+    assert(operand.get() != nullptr);
+    return TerminalExpression(operand.get());
+  } else {
+    return operand;
+  }
+}
+
+template<class Type>
+using expression_t = decltype(as_expression(std::declval<const Type&>()));
+
+
+template<class Left, class Right, std::enable_if_t<is_operand<Left> && is_operand<Right>, int> = 0>
+auto operator+(const Left &left, const Right &right) {
+  return SumExpression<expression_t<Left>, expression_t<Right>>(as_expression(left), as_expression(right));
+}
+
+template<class Left, class Right, std::enable_if_t<is_operand<Left> && is_operand<Right>, int> = 0>
+auto operator-(const Left &left, const Right &right) {
+  return DifferenceExpression<expression_t<Left>, expression_t<Right>>(as_expression(left), as_expression(right));
+}
+
+template<class Left, class Right, std::enable_if_t<is_operand<Left> && is_operand<Right>, int> = 0>
+auto operator*(const Left &left, const Right &right) {
+  return ProductExpression<expression_t<Left>, expression_t<Right>>(as_expression(left), as_expression(right));
+}
+
+template<class Operand, std::enable_if_t<is_operand<Operand>, int> = 0>
+auto operator*(const Operand &operand, double factor) {
+  return ScaleExpression<expression_t<Operand>>(as_expression(operand), factor);
+}
+
+template<class Operand, std::enable_if_t<is_operand<Operand>, int> = 0>
+auto operator*(double factor, const Operand &operand) {
+  return ScaleExpression<expression_t<Operand>>(as_expression(operand), factor);
+}
+
+template<class Operand, std::enable_if_t<is_operand<Operand>, int> = 0>
+auto operator/(const Operand &operand, double divisor) {
+  return ScaleExpression<expression_t<Operand>>(as_expression(operand), 1 / divisor);
+}
+
+template<class Operand, std::enable_if_t<is_operand<Operand>, int> = 0>
+auto operator-(const Operand &operand) {
+  return ScaleExpression<expression_t<Operand>>(as_expression(operand), -1);
+}
+
+template<class Operand, std::enable_if_t<is_operand<Operand>, int> = 0>
+auto derivative(const Operand &operand) {
+  return DerivativeExpression<expression_t<Operand>>(as_expression(operand));
+}
+
+}
+
+#endif
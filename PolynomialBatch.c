@@ -0,0 +1,1154 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "Coefficients.h"
+#include "Polynomial.h"
+#include "PolynomialBatch.h"
+
+// below this many coefficients (times points for polynomial_batch_compute_points), a batch is processed by the calling thread alone
+#define BATCH_PARALLEL_THRESHOLD 65536
+
+// number of points computed together by polynomial_batch_compute_points, while the polynomial stays in cache
+#define BATCH_POINTS_BLOCK 32
+
+#define BATCH_INITIAL_CAPACITY 16
+
+// binary format: this magic, the number of polynomials and of coefficients,
+// then offsets[1..length] and the coefficients, all in the host's byte order
+#define BATCH_BINARY_MAGIC "PLYBATC1"
+// the same, with float coefficients
+#define BATCH_BINARY_FLOAT_MAGIC "PLYBATF1"
+
+// binary batches are read this many offsets or coefficients at a time, growing the batch as they come
+#define BATCH_BINARY_READ_BLOCK 65536
+
+// number of points computed together by polynomial_batch_compute_points_float, the width of a SSE2 register
+#define BATCH_FLOAT_WIDTH 4
+
+typedef float BatchFloatVector __attribute__((vector_size(BATCH_FLOAT_WIDTH * sizeof(float))));
+
+struct PolynomialBatch {
+  unsigned long length;
+  unsigned long *offsets; // length + 1 offsets, offsets[length] is the total number of coefficients
+  POLYNOMIAL_BATCH_PRECISION precision;
+  double *coefficients; // NULL for a float batch
+  float *coefficients_float; // NULL for a double batch
+  unsigned long offsets_capacity;
+  unsigned long coefficients_capacity;
+};
+
+static unsigned int batch_threads = 0;
+
+
+static inline int is_coefficient_null(double coefficient) {
+  // comparing a double to 0 may fail because of its internal representation
+  return (coefficient > -POLYNOMIAL_NULL_TOLERANCE && coefficient < POLYNOMIAL_NULL_TOLERANCE);
+}
+
+
+static void* batch_allocate(void *pointer, size_t size) {
+  void *allocated = realloc(pointer, size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+/*
+ * @function batch_reserve
+ *
+ * Makes room for polynomials more polynomials and coefficients more coefficients.
+ */
+static void batch_reserve(PolynomialBatch *batch, unsigned long polynomials, unsigned long coefficients) {
+  unsigned long needed_offsets = batch->length + polynomials + 1;
+  if(needed_offsets > batch->offsets_capacity) {
+    unsigned long capacity = batch->offsets_capacity * 2;
+    if(capacity < needed_offsets) {
+      capacity = needed_offsets;
+    }
+
+    batch->offsets = batch_allocate(batch->offsets, sizeof(unsigned long) * capacity);
+    batch->offsets_capacity = capacity;
+  }
+
+  unsigned long needed_coefficients = batch->offsets[batch->length] + coefficients;
+  if(needed_coefficients > batch->coefficients_capacity) {
+    unsigned long capacity = batch->coefficients_capacity * 2;
+    if(capacity < needed_coefficients) {
+      capacity = needed_coefficients;
+    }
+
+    if(batch->precision == POLYNOMIAL_BATCH_FLOAT) {
+      batch->coefficients_float = batch_allocate(batch->coefficients_float, sizeof(float) * capacity);
+    } else {
+      batch->coefficients = batch_allocate(batch->coefficients, sizeof(double) * capacity);
+    }
+    batch->coefficients_capacity = capacity;
+  }
+}
+
+
+static PolynomialBatch* batch_create_with_precision(unsigned long polynomials, unsigned long coefficients, POLYNOMIAL_BATCH_PRECISION precision) {
+  PolynomialBatch *batch = batch_allocate(NULL, sizeof(PolynomialBatch));
+
+  batch->length = 0;
+  batch->precision = precision;
+  batch->offsets_capacity = polynomials + 1;
+  batch->coefficients_capacity = coefficients > 0 ? coefficients : 1;
+  batch->offsets = batch_allocate(NULL, sizeof(unsigned long) * batch->offsets_capacity);
+  batch->coefficients = NULL;
+  batch->coefficients_float = NULL;
+  if(precision == POLYNOMIAL_BATCH_FLOAT) {
+    batch->coefficients_float = batch_allocate(NULL, sizeof(float) * batch->coefficients_capacity);
+  } else {
+    batch->coefficients = batch_allocate(NULL, sizeof(double) * batch->coefficients_capacity);
+  }
+  batch->offsets[0] = 0;
+
+  return batch;
+}
+
+
+static PolynomialBatch* batch_create_with_capacity(unsigned long polynomials, unsigned long coefficients) {
+  return batch_create_with_precision(polynomials, coefficients, POLYNOMIAL_BATCH_DOUBLE);
+}
+
+
+static inline double batch_coefficient(const PolynomialBatch *batch, unsigned long offset) {
+  return (batch->precision == POLYNOMIAL_BATCH_FLOAT) ? batch->coefficients_float[offset] : batch->coefficients[offset];
+}
+
+
+/*
+ * @function batch_as_double
+ *
+ * Functions which only work on double coefficients call them on a double copy of a float batch.
+ *
+ * @return const PolynomialBatch*
+ * batch itself if it is a double batch, otherwise a copy, also stored in *copy, which must be freed after use.
+ */
+static const PolynomialBatch* batch_as_double(const PolynomialBatch *batch, PolynomialBatch **copy) {
+  *copy = NULL;
+  if(batch->precision == POLYNOMIAL_BATCH_DOUBLE) {
+    return batch;
+  }
+
+  *copy = polynomial_batch_convert(batch, POLYNOMIAL_BATCH_DOUBLE);
+  return *copy;
+}
+
+
+// converts result, computed on the double copy of a batch, back to the precision of that batch
+static PolynomialBatch* batch_restore_precision(PolynomialBatch *result, PolynomialBatch **copy) {
+  if(*copy == NULL) {
+    return result;
+  }
+
+  PolynomialBatch *converted = polynomial_batch_convert(result, POLYNOMIAL_BATCH_FLOAT);
+  polynomial_batch_free(&result);
+  polynomial_batch_free(copy);
+
+  return converted;
+}
+
+
+/*
+ * Parallel loop over the polynomials of a batch.
+ * The polynomials are split in contiguous ranges holding about the same number of coefficients,
+ * each range being processed by one worker. The calling thread processes the first range.
+ */
+
+typedef void (*BatchTask)(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context);
+
+typedef struct {
+  const PolynomialBatch *batch;
+  unsigned long begin;
+  unsigned long end;
+  unsigned int worker;
+  BatchTask task;
+  void *context;
+} BatchWorker;
+
+
+static void* batch_worker_run(void *argument) {
+  BatchWorker *worker = argument;
+  worker->task(worker->batch, worker->begin, worker->end, worker->worker, worker->context);
+
+  return NULL;
+}
+
+
+/*
+ * @function batch_count_workers
+ *
+ * @param unsigned long cost_per_coefficient
+ * The work done for each coefficient, used to decide whether threads are worth starting.
+ *
+ * @return unsigned int
+ * The number of workers batch_parallel_run will use, at least 1.
+ */
+static unsigned int batch_count_workers(const PolynomialBatch *batch, unsigned long cost_per_coefficient) {
+  unsigned long cost = batch->offsets[batch->length] * cost_per_coefficient;
+  if(cost < BATCH_PARALLEL_THRESHOLD || batch->length < 2) {
+    return 1;
+  }
+
+  unsigned long workers = batch_threads;
+  if(workers == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = online > 0 ? (unsigned long) online : 1;
+  }
+
+  if(workers > batch->length) {
+    workers = batch->length;
+  }
+
+  return (unsigned int) workers;
+}
+
+
+/*
+ * @function batch_split
+ *
+ * @return unsigned long
+ * The index of the first polynomial of range worker out of workers.
+ */
+static unsigned long batch_split(const PolynomialBatch *batch, unsigned int worker, unsigned int workers) {
+  if(worker == workers) {
+    return batch->length;
+  }
+
+  unsigned long target = (unsigned long) ((double) batch->offsets[batch->length] * worker / workers);
+
+  // first polynomial starting at or after target
+  unsigned long low = 0, high = batch->length;
+  while(low < high) {
+    unsigned long middle = low + (high - low) / 2;
+    if(batch->offsets[middle] < target) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+
+static void batch_parallel_run(const PolynomialBatch *batch, unsigned int workers, BatchTask task, void *context) {
+  if(workers <= 1) {
+    task(batch, 0, batch->length, 0, context);
+    return;
+  }
+
+  BatchWorker *pool = batch_allocate(NULL, sizeof(BatchWorker) * workers);
+  pthread_t *threads = batch_allocate(NULL, sizeof(pthread_t) * workers);
+  int *started = calloc(workers, sizeof(int));
+  if(!started) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(int) * workers);
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned int index;
+  for(index = 0; index < workers; index++) {
+    pool[index].batch = batch;
+    pool[index].begin = batch_split(batch, index, workers);
+    pool[index].end = batch_split(batch, index + 1, workers);
+    pool[index].worker = index;
+    pool[index].task = task;
+    pool[index].context = context;
+  }
+
+  for(index = 1; index < workers; index++) {
+    started[index] = (pthread_create(&threads[index], NULL, batch_worker_run, &pool[index]) == 0);
+  }
+
+  batch_worker_run(&pool[0]);
+
+  // ranges whose thread couldn't be started are processed here
+  for(index = 1; index < workers; index++) {
+    if(started[index]) {
+      pthread_join(threads[index], NULL);
+    } else {
+      batch_worker_run(&pool[index]);
+    }
+  }
+
+  free(started);
+  free(threads);
+  free(pool);
+}
+
+
+typedef struct {
+  double x;
+  double *results;
+} BatchComputeContext;
+
+
+static void batch_task_compute(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  const double x = ((BatchComputeContext*) context)->x;
+  double *results = ((BatchComputeContext*) context)->results;
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    long degree = batch->offsets[index + 1] - batch->offsets[index] - 1;
+    long current;
+
+    if(batch->precision == POLYNOMIAL_BATCH_FLOAT) {
+      const float *coefficients = batch->coefficients_float + batch->offsets[index];
+      double value = coefficients[degree];
+      for(current = degree - 1; current >= 0; current--) {
+        value = value * x + coefficients[current];
+      }
+
+      results[index] = value;
+      continue;
+    }
+
+    const double *coefficients = batch->coefficients + batch->offsets[index];
+    double value = coefficients[degree];
+    for(current = degree - 1; current >= 0; current--) {
+      value = value * x + coefficients[current];
+    }
+
+    results[index] = value;
+  }
+}
+
+
+typedef struct {
+  const double *points;
+  unsigned long number_of_points;
+  double *results;
+} BatchPointsContext;
+
+
+static void batch_task_compute_points(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  const BatchPointsContext *points_context = context;
+  const double *points = points_context->points;
+  unsigned long number_of_points = points_context->number_of_points;
+
+  double values[BATCH_POINTS_BLOCK];
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    unsigned long offset = batch->offsets[index];
+    long degree = batch->offsets[index + 1] - offset - 1;
+    double *results = points_context->results + index * number_of_points;
+
+    unsigned long first;
+    for(first = 0; first < number_of_points; first += BATCH_POINTS_BLOCK) {
+      unsigned long count = number_of_points - first;
+      if(count > BATCH_POINTS_BLOCK) {
+        count = BATCH_POINTS_BLOCK;
+      }
+
+      unsigned long point;
+      double leading = batch_coefficient(batch, offset + degree);
+      for(point = 0; point < count; point++) {
+        values[point] = leading;
+      }
+
+      long current;
+      for(current = degree - 1; current >= 0; current--) {
+        double coefficient = batch_coefficient(batch, offset + current);
+        for(point = 0; point < count; point++) {
+          values[point] = values[point] * points[first + point] + coefficient;
+        }
+      }
+
+      memcpy(results + first, values, sizeof(double) * count);
+    }
+  }
+}
+
+
+typedef struct {
+  const float *points;
+  unsigned long number_of_points;
+  float *results;
+} BatchFloatPointsContext;
+
+
+static void batch_task_compute_points_float(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  const BatchFloatPointsContext *points_context = context;
+  unsigned long number_of_points = points_context->number_of_points;
+
+  BatchFloatVector points[BATCH_POINTS_BLOCK / BATCH_FLOAT_WIDTH];
+  BatchFloatVector values[BATCH_POINTS_BLOCK / BATCH_FLOAT_WIDTH];
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    unsigned long offset = batch->offsets[index];
+    long degree = batch->offsets[index + 1] - offset - 1;
+    float *results = points_context->results + index * number_of_points;
+
+    unsigned long first;
+    for(first = 0; first < number_of_points; first += BATCH_POINTS_BLOCK) {
+      unsigned long count = number_of_points - first;
+      if(count > BATCH_POINTS_BLOCK) {
+        count = BATCH_POINTS_BLOCK;
+      }
+
+      // the last block is padded with zeros
+      unsigned long vectors = (count + BATCH_FLOAT_WIDTH - 1) / BATCH_FLOAT_WIDTH;
+      memset(points, 0, sizeof(points));
+      memcpy(points, points_context->points + first, sizeof(float) * count);
+
+      unsigned long vector;
+      float leading = (float) batch_coefficient(batch, offset + degree);
+      for(vector = 0; vector < vectors; vector++) {
+        values[vector] = (BatchFloatVector) { 0 } + leading;
+      }
+
+      long current;
+      for(current = degree - 1; current >= 0; current--) {
+        float coefficient = (float) batch_coefficient(batch, offset + current);
+        for(vector = 0; vector < vectors; vector++) {
+          values[vector] = values[vector] * points[vector] + coefficient;
+        }
+      }
+
+      memcpy(results + first, values, sizeof(float) * count);
+    }
+  }
+}
+
+
+typedef struct {
+  double **partial_sums; // one array of max_degree + 1 coefficients per worker
+} BatchSumContext;
+
+
+static void batch_task_sum(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  double *sum = ((BatchSumContext*) context)->partial_sums[worker];
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    long degree = batch->offsets[index + 1] - batch->offsets[index] - 1;
+    coefficients_add(sum, batch->coefficients + batch->offsets[index], degree);
+  }
+}
+
+
+static void batch_task_derivative(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  PolynomialBatch *derivatives = context;
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    const double *coefficients = batch->coefficients + batch->offsets[index];
+    unsigned long length = batch->offsets[index + 1] - batch->offsets[index];
+    double *derivative = derivatives->coefficients + derivatives->offsets[index];
+
+    if(length == 1) {
+      derivative[0] = 0;
+      continue;
+    }
+
+    coefficients_derivative(coefficients, length - 1, derivative);
+  }
+}
+
+
+typedef struct {
+  double tolerance;
+  unsigned long long *hashes;
+} BatchHashContext;
+
+
+static void batch_task_hash(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  const BatchHashContext *hash_context = context;
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    long degree = batch->offsets[index + 1] - batch->offsets[index] - 1;
+    hash_context->hashes[index] = coefficients_hash(batch->coefficients + batch->offsets[index], degree, hash_context->tolerance);
+  }
+}
+
+
+typedef struct {
+  unsigned long long point;
+  unsigned long long *fingerprints;
+  int integral; // cleared by any worker meeting a coefficient which is not an integer
+} BatchFingerprintContext;
+
+
+static void batch_task_fingerprint(const PolynomialBatch *batch, unsigned long begin, unsigned long end, unsigned int worker, void *context) {
+  (void) worker;
+  BatchFingerprintContext *fingerprint_context = context;
+
+  unsigned long index;
+  for(index = begin; index < end; index++) {
+    long degree = batch->offsets[index + 1] - batch->offsets[index] - 1;
+    if(!coefficients_fingerprint(batch->coefficients + batch->offsets[index], degree, fingerprint_context->point, fingerprint_context->fingerprints + index)) {
+      __atomic_store_n(&fingerprint_context->integral, 0, __ATOMIC_RELAXED);
+      return;
+    }
+  }
+}
+
+
+/*
+ * @function batch_equals
+ *
+ * @return int
+ * 1 if polynomials left and right of batch have the same coefficients, once rounded like coefficients_hash does.
+ */
+static int batch_equals(const PolynomialBatch *batch, unsigned long left, unsigned long right, double tolerance) {
+  const double *left_coefficients = batch->coefficients + batch->offsets[left];
+  const double *right_coefficients = batch->coefficients + batch->offsets[right];
+  unsigned long left_length = batch->offsets[left + 1] - batch->offsets[left];
+  unsigned long right_length = batch->offsets[right + 1] - batch->offsets[right];
+
+  if(tolerance == 0) {
+    return left_length == right_length && memcmp(left_coefficients, right_coefficients, sizeof(double) * left_length) == 0;
+  }
+
+  // rounding may make the leading coefficients null, so the lengths may differ
+  unsigned long length = left_length > right_length ? left_length : right_length;
+  unsigned long index;
+  for(index = 0; index < length; index++) {
+    double left_quotient = (index < left_length) ? left_coefficients[index] / tolerance : 0;
+    double right_quotient = (index < right_length) ? right_coefficients[index] / tolerance : 0;
+    if((long long) (left_quotient + copysign(0.5, left_quotient)) != (long long) (right_quotient + copysign(0.5, right_quotient))) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+
+void polynomial_batch_append(PolynomialBatch *batch, const Polynomial *polynomial) {
+  assert(batch != NULL);
+  assert(polynomial != NULL);
+
+  unsigned long length = polynomial_get_degree(polynomial) + 1;
+  batch_reserve(batch, 1, length);
+
+  unsigned long offset = batch->offsets[batch->length];
+  if(batch->precision == POLYNOMIAL_BATCH_FLOAT) {
+    polynomial_get_coefficients_float(polynomial, batch->coefficients_float + offset);
+  } else {
+    polynomial_get_coefficients(polynomial, batch->coefficients + offset);
+  }
+
+  batch->length++;
+  batch->offsets[batch->length] = offset + length;
+}
+
+
+void polynomial_batch_compute(const PolynomialBatch *batch, double x, double *results) {
+  assert(batch != NULL);
+  assert(results != NULL);
+
+  BatchComputeContext context = { x, results };
+  batch_parallel_run(batch, batch_count_workers(batch, 1), batch_task_compute, &context);
+}
+
+
+void polynomial_batch_compute_points(const PolynomialBatch *batch, const double *points, unsigned long number_of_points, double *results) {
+  assert(batch != NULL);
+  assert(points != NULL || number_of_points == 0);
+  assert(results != NULL || number_of_points == 0);
+
+  if(number_of_points == 0) {
+    return;
+  }
+
+  BatchPointsContext context = { points, number_of_points, results };
+  batch_parallel_run(batch, batch_count_workers(batch, number_of_points), batch_task_compute_points, &context);
+}
+
+
+void polynomial_batch_compute_points_float(const PolynomialBatch *batch, const float *points, unsigned long number_of_points, float *results) {
+  assert(batch != NULL);
+  assert(points != NULL || number_of_points == 0);
+  assert(results != NULL || number_of_points == 0);
+
+  if(number_of_points == 0) {
+    return;
+  }
+
+  BatchFloatPointsContext context = { points, number_of_points, results };
+  batch_parallel_run(batch, batch_count_workers(batch, number_of_points), batch_task_compute_points_float, &context);
+}
+
+
+PolynomialBatch* polynomial_batch_convert(const PolynomialBatch *batch, POLYNOMIAL_BATCH_PRECISION precision) {
+  assert(batch != NULL);
+
+  unsigned long coefficients = batch->offsets[batch->length];
+  PolynomialBatch *converted = batch_create_with_precision(batch->length, coefficients, precision);
+
+  memcpy(converted->offsets, batch->offsets, sizeof(unsigned long) * (batch->length + 1));
+  converted->length = batch->length;
+
+  unsigned long index;
+  if(precision == POLYNOMIAL_BATCH_FLOAT) {
+    for(index = 0; index < coefficients; index++) {
+      converted->coefficients_float[index] = (float) batch_coefficient(batch, index);
+    }
+  } else {
+    for(index = 0; index < coefficients; index++) {
+      converted->coefficients[index] = batch_coefficient(batch, index);
+    }
+  }
+
+  return converted;
+}
+
+
+PolynomialBatch* polynomial_batch_create(void) {
+  return batch_create_with_capacity(BATCH_INITIAL_CAPACITY, BATCH_INITIAL_CAPACITY);
+}
+
+
+PolynomialBatch* polynomial_batch_create_from_file(const char *filename) {
+  assert(filename != NULL);
+
+  errno = 0;
+  FILE *file = fopen(filename, "r");
+  if(!file) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  PolynomialBatch *batch = polynomial_batch_create_from_stream(file);
+
+  fclose(file);
+
+  return batch;
+}
+
+
+/*
+ * @function batch_binary_header_valid
+ *
+ * Checks the counts of a binary header before anything is allocated for them:
+ * every polynomial has at least one coefficient, sizes must not overflow,
+ * and when the size of stream is known, offsets and coefficients must fit in what remains of it.
+ * A pipe can't tell its size: its batch only grows as offsets and coefficients are actually read.
+ */
+static int batch_binary_header_valid(FILE *stream, unsigned long long polynomials, unsigned long long coefficients, size_t coefficient_size) {
+  if(polynomials > coefficients || (polynomials == 0) != (coefficients == 0)) {
+    return 0;
+  }
+
+  if(coefficients >= ULONG_MAX || coefficients > SIZE_MAX / coefficient_size / 2) {
+    return 0;
+  }
+
+  // polynomials <= coefficients, whose size is less than SIZE_MAX / 2
+  unsigned long long size = polynomials * sizeof(unsigned long long) + coefficients * coefficient_size;
+
+  int saved_errno = errno;
+  int valid = 1;
+  off_t position = ftello(stream);
+  if(position >= 0 && fseeko(stream, 0, SEEK_END) == 0) {
+    off_t end = ftello(stream);
+    valid = fseeko(stream, position, SEEK_SET) == 0 && end >= position && (unsigned long long) (end - position) >= size;
+  }
+  errno = saved_errno;
+
+  return valid;
+}
+
+
+PolynomialBatch* polynomial_batch_create_from_binary_stream(FILE *stream) {
+  assert(stream != NULL);
+
+  char magic[sizeof(BATCH_BINARY_MAGIC) - 1];
+  unsigned long long header[2]; // number of polynomials, number of coefficients
+  if(fread(magic, 1, sizeof(magic), stream) != sizeof(magic)
+    || (memcmp(magic, BATCH_BINARY_MAGIC, sizeof(magic)) != 0 && memcmp(magic, BATCH_BINARY_FLOAT_MAGIC, sizeof(magic)) != 0)
+    || fread(header, sizeof(unsigned long long), 2, stream) != 2) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  POLYNOMIAL_BATCH_PRECISION precision = (memcmp(magic, BATCH_BINARY_FLOAT_MAGIC, sizeof(magic)) == 0)
+    ? POLYNOMIAL_BATCH_FLOAT : POLYNOMIAL_BATCH_DOUBLE;
+  size_t coefficient_size = (precision == POLYNOMIAL_BATCH_FLOAT) ? sizeof(float) : sizeof(double);
+  if(!batch_binary_header_valid(stream, header[0], header[1], coefficient_size)) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  PolynomialBatch *batch = batch_create_with_precision(
+    (header[0] < BATCH_BINARY_READ_BLOCK) ? header[0] : BATCH_BINARY_READ_BLOCK,
+    (header[1] < BATCH_BINARY_READ_BLOCK) ? header[1] : BATCH_BINARY_READ_BLOCK,
+    precision);
+
+  // offsets are stored as 64-bit integers whatever the size of a long
+  // the batch stays empty until the end, so that batch_reserve only grows it to what was read
+  unsigned long long offset = 0;
+  unsigned long index;
+  for(index = 1; index <= header[0]; index++) {
+    unsigned long long next;
+    if(fread(&next, sizeof(unsigned long long), 1, stream) != 1 || next <= offset || next > header[1]) {
+      polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+      polynomial_batch_free(&batch);
+      return NULL;
+    }
+
+    batch_reserve(batch, index, 0);
+    batch->offsets[index] = next;
+    offset = next;
+  }
+
+  unsigned long long read = 0;
+  while(read < header[1]) {
+    unsigned long long count = (header[1] - read < BATCH_BINARY_READ_BLOCK) ? header[1] - read : BATCH_BINARY_READ_BLOCK;
+    batch_reserve(batch, 0, read + count);
+
+    size_t block_read = (precision == POLYNOMIAL_BATCH_FLOAT)
+      ? fread(batch->coefficients_float + read, sizeof(float), count, stream)
+      : fread(batch->coefficients + read, sizeof(double), count, stream);
+    read += block_read;
+
+    if(block_read != count) {
+      break;
+    }
+  }
+
+  if(offset != header[1] || read != header[1]) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    polynomial_batch_free(&batch);
+    return NULL;
+  }
+
+  batch->length = header[0];
+
+  return batch;
+}
+
+
+PolynomialBatch* polynomial_batch_create_from_stream(FILE *stream) {
+  assert(stream != NULL);
+
+  PolynomialBatch *batch = polynomial_batch_create();
+
+  size_t line_size = 256;
+  char *line = batch_allocate(NULL, line_size);
+
+  while(fgets(line, line_size, stream) == line) {
+    // lines are not limited in length: grow the buffer until the whole line is read
+    size_t line_length = strlen(line);
+    while(line_length > 0 && line[line_length - 1] != '\n' && !feof(stream)) {
+      line_size *= 2;
+      line = batch_allocate(line, line_size);
+
+      if(fgets(line + line_length, line_size - line_length, stream) != line + line_length) {
+        break;
+      }
+
+      line_length += strlen(line + line_length);
+    }
+
+    if(line_length > 0 && line[line_length - 1] == '\n') {
+      line[line_length - 1] = '\0';
+    }
+
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+    Polynomial *readp = polynomial_create_from_string(line);
+    if(!readp && polynomials_errno == POLYNOMIAL_INPUT_ERROR) {
+      free(line);
+      polynomial_batch_free(&batch);
+      return NULL;
+    }
+
+    if(!readp) {
+      // keep one polynomial per line, so that indices match line numbers
+      batch_reserve(batch, 1, 1);
+      batch->coefficients[batch->offsets[batch->length]] = 0;
+      batch->offsets[batch->length + 1] = batch->offsets[batch->length] + 1;
+      batch->length++;
+      continue;
+    }
+
+    polynomial_batch_append(batch, readp);
+    polynomial_free(&readp);
+  }
+
+  free(line);
+
+  if(ferror(stream)) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    polynomial_batch_free(&batch);
+    return NULL;
+  }
+
+  return batch;
+}
+
+
+PolynomialBatch* polynomial_batch_create_from_polynomials(const Polynomial **polynomials, unsigned long length) {
+  assert(polynomials != NULL || length == 0);
+
+  unsigned long coefficients = 0;
+  unsigned long index;
+  for(index = 0; index < length; index++) {
+    assert(polynomials[index] != NULL);
+    coefficients += polynomial_get_degree(polynomials[index]) + 1;
+  }
+
+  PolynomialBatch *batch = batch_create_with_capacity(length, coefficients);
+
+  for(index = 0; index < length; index++) {
+    polynomial_batch_append(batch, polynomials[index]);
+  }
+
+  return batch;
+}
+
+
+PolynomialBatch* polynomial_batch_derivative(const PolynomialBatch *batch) {
+  assert(batch != NULL);
+
+  PolynomialBatch *copy;
+  batch = batch_as_double(batch, &copy);
+
+  // a polynomial of n coefficients has a derivative of n - 1, the null polynomial keeps its single 0
+  PolynomialBatch *derivatives = batch_create_with_capacity(batch->length, batch->offsets[batch->length]);
+
+  unsigned long index;
+  for(index = 0; index < batch->length; index++) {
+    unsigned long length = batch->offsets[index + 1] - batch->offsets[index];
+    derivatives->offsets[index + 1] = derivatives->offsets[index] + (length > 1 ? length - 1 : 1);
+  }
+  derivatives->length = batch->length;
+
+  batch_parallel_run(batch, batch_count_workers(batch, 1), batch_task_derivative, derivatives);
+
+  return batch_restore_precision(derivatives, &copy);
+}
+
+
+int polynomial_batch_fingerprint(const PolynomialBatch *batch, unsigned long long point, unsigned long long *fingerprints) {
+  assert(batch != NULL);
+  assert(fingerprints != NULL);
+
+  PolynomialBatch *copy;
+  batch = batch_as_double(batch, &copy);
+
+  BatchFingerprintContext context = { point, fingerprints, 1 };
+  batch_parallel_run(batch, batch_count_workers(batch, 4), batch_task_fingerprint, &context);
+
+  if(copy != NULL) {
+    polynomial_batch_free(&copy);
+  }
+
+  return context.integral;
+}
+
+
+void polynomial_batch_free(PolynomialBatch **batch) {
+  assert(batch != NULL);
+  assert(*batch != NULL);
+
+  free((*batch)->offsets);
+  free((*batch)->coefficients);
+  free((*batch)->coefficients_float);
+  free(*batch);
+
+  *batch = NULL;
+}
+
+
+Polynomial* polynomial_batch_get(const PolynomialBatch *batch, unsigned long index) {
+  assert(batch != NULL);
+  assert(index < batch->length);
+
+  if(batch->precision == POLYNOMIAL_BATCH_FLOAT) {
+    return polynomial_create_float(
+      batch->coefficients_float + batch->offsets[index],
+      batch->offsets[index + 1] - batch->offsets[index] - 1
+    );
+  }
+
+  return polynomial_create(
+    batch->coefficients + batch->offsets[index],
+    batch->offsets[index + 1] - batch->offsets[index] - 1
+  );
+}
+
+
+const double* polynomial_batch_get_coefficients(const PolynomialBatch *batch, unsigned long index) {
+  assert(batch != NULL);
+  assert(batch->precision == POLYNOMIAL_BATCH_DOUBLE);
+  assert(index < batch->length);
+
+  return batch->coefficients + batch->offsets[index];
+}
+
+
+const float* polynomial_batch_get_coefficients_float(const PolynomialBatch *batch, unsigned long index) {
+  assert(batch != NULL);
+  assert(batch->precision == POLYNOMIAL_BATCH_FLOAT);
+  assert(index < batch->length);
+
+  return batch->coefficients_float + batch->offsets[index];
+}
+
+
+long polynomial_batch_get_degree(const PolynomialBatch *batch, unsigned long index) {
+  assert(batch != NULL);
+  assert(index < batch->length);
+
+  return batch->offsets[index + 1] - batch->offsets[index] - 1;
+}
+
+
+unsigned long polynomial_batch_get_length(const PolynomialBatch *batch) {
+  assert(batch != NULL);
+
+  return batch->length;
+}
+
+
+POLYNOMIAL_BATCH_PRECISION polynomial_batch_get_precision(const PolynomialBatch *batch) {
+  assert(batch != NULL);
+
+  return batch->precision;
+}
+
+
+void polynomial_batch_hash(const PolynomialBatch *batch, double tolerance, unsigned long long *hashes) {
+  assert(batch != NULL);
+  assert(tolerance >= 0);
+  assert(hashes != NULL);
+
+  PolynomialBatch *copy;
+  batch = batch_as_double(batch, &copy);
+
+  BatchHashContext context = { tolerance, hashes };
+  batch_parallel_run(batch, batch_count_workers(batch, 4), batch_task_hash, &context);
+
+  if(copy != NULL) {
+    polynomial_batch_free(&copy);
+  }
+}
+
+
+void polynomial_batch_set_threads(unsigned int threads) {
+  batch_threads = threads;
+}
+
+
+Polynomial* polynomial_batch_sum(const PolynomialBatch *batch) {
+  assert(batch != NULL);
+
+  PolynomialBatch *copy;
+  batch = batch_as_double(batch, &copy);
+
+  long max_degree = 0;
+  unsigned long index;
+  for(index = 0; index < batch->length; index++) {
+    long degree = batch->offsets[index + 1] - batch->offsets[index] - 1;
+    if(degree > max_degree) {
+      max_degree = degree;
+    }
+  }
+
+  unsigned int workers = batch_count_workers(batch, 1);
+
+  BatchSumContext context;
+  context.partial_sums = batch_allocate(NULL, sizeof(double*) * workers);
+
+  unsigned int worker;
+  for(worker = 0; worker < workers; worker++) {
+    context.partial_sums[worker] = calloc(max_degree + 1, sizeof(double));
+    if(!context.partial_sums[worker]) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (max_degree + 1));
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  batch_parallel_run(batch, workers, batch_task_sum, &context);
+
+  double *sum = context.partial_sums[0];
+  for(worker = 1; worker < workers; worker++) {
+    long degree;
+    for(degree = 0; degree <= max_degree; degree++) {
+      sum[degree] += context.partial_sums[worker][degree];
+    }
+
+    free(context.partial_sums[worker]);
+  }
+
+  Polynomial *result = polynomial_create(sum, max_degree);
+
+  free(sum);
+  free(context.partial_sums);
+  if(copy != NULL) {
+    polynomial_batch_free(&copy);
+  }
+
+  return result;
+}
+
+
+PolynomialBatch* polynomial_batch_unique(const PolynomialBatch *batch, double tolerance) {
+  assert(batch != NULL);
+  assert(tolerance >= 0);
+
+  PolynomialBatch *copy;
+  batch = batch_as_double(batch, &copy);
+
+  unsigned long long *hashes = batch_allocate(NULL, sizeof(unsigned long long) * (batch->length + 1));
+  polynomial_batch_hash(batch, tolerance, hashes);
+
+  /*
+   * Open addressing table of the polynomials kept so far, at most half full.
+   * A slot holds the index of a polynomial + 1, 0 if it is empty.
+   * Polynomials of same hash are only kept if their coefficients differ.
+   */
+  unsigned long number_of_slots = 2;
+  while(number_of_slots < 2 * batch->length) {
+    number_of_slots *= 2;
+  }
+  unsigned long *slots = calloc(number_of_slots, sizeof(unsigned long));
+  if(!slots) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long) * number_of_slots);
+    exit(EXIT_FAILURE);
+  }
+
+  PolynomialBatch *unique = batch_create_with_capacity(BATCH_INITIAL_CAPACITY, BATCH_INITIAL_CAPACITY);
+
+  unsigned long index;
+  for(index = 0; index < batch->length; index++) {
+    unsigned long slot = hashes[index] & (number_of_slots - 1);
+    while(slots[slot] != 0
+      && (hashes[slots[slot] - 1] != hashes[index] || !batch_equals(batch, slots[slot] - 1, index, tolerance))) {
+      slot = (slot + 1) & (number_of_slots - 1);
+    }
+
+    if(slots[slot] != 0) {
+      continue; // a duplicate
+    }
+    slots[slot] = index + 1;
+
+    unsigned long length = batch->offsets[index + 1] - batch->offsets[index];
+    batch_reserve(unique, 1, length);
+    unsigned long offset = unique->offsets[unique->length];
+    memcpy(unique->coefficients + offset, batch->coefficients + batch->offsets[index], sizeof(double) * length);
+    unique->length++;
+    unique->offsets[unique->length] = offset + length;
+  }
+
+  free(slots);
+  free(hashes);
+
+  return batch_restore_precision(unique, &copy);
+}
+
+
+int polynomial_batch_write_to_binary_stream(const PolynomialBatch *batch, FILE *stream) {
+  assert(batch != NULL);
+  assert(stream != NULL);
+
+  const char *magic = (batch->precision == POLYNOMIAL_BATCH_FLOAT) ? BATCH_BINARY_FLOAT_MAGIC : BATCH_BINARY_MAGIC;
+  unsigned long long header[2] = { batch->length, batch->offsets[batch->length] };
+  if(fwrite(magic, 1, sizeof(BATCH_BINARY_MAGIC) - 1, stream) != sizeof(BATCH_BINARY_MAGIC) - 1
+    || fwrite(header, sizeof(unsigned long long), 2, stream) != 2) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    return 0;
+  }
+
+  unsigned long index;
+  for(index = 1; index <= batch->length; index++) {
+    unsigned long long offset = batch->offsets[index];
+    if(fwrite(&offset, sizeof(unsigned long long), 1, stream) != 1) {
+      polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+      return 0;
+    }
+  }
+
+  size_t written = (batch->precision == POLYNOMIAL_BATCH_FLOAT)
+    ? fwrite(batch->coefficients_float, sizeof(float), header[1], stream)
+    : fwrite(batch->coefficients, sizeof(double), header[1], stream);
+  if(written != header[1]) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    return 0;
+  }
+
+  return 1;
+}
+
+
+int polynomial_batch_write_to_file(const PolynomialBatch *batch, const char *filename) {
+  assert(batch != NULL);
+  assert(filename != NULL);
+
+  errno = 0;
+  FILE *file = fopen(filename, "w");
+  if(!file) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    return 0;
+  }
+
+  int success = polynomial_batch_write_to_stream(batch, file);
+  if(fclose(file) != 0) {
+    success = 0;
+  }
+
+  if(!success) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+  }
+
+  return success;
+}
+
+
+int polynomial_batch_write_to_stream(const PolynomialBatch *batch, FILE *stream) {
+  assert(batch != NULL);
+  assert(stream != NULL);
+
+  unsigned long index;
+  for(index = 0; index < batch->length; index++) {
+    unsigned long offset = batch->offsets[index];
+    unsigned long length = batch->offsets[index + 1] - offset;
+
+    int first = 1;
+    unsigned long degree;
+    for(degree = 0; degree < length; degree++) {
+      double coefficient = batch_coefficient(batch, offset + degree);
+      if(is_coefficient_null(coefficient)) {
+        continue;
+      }
+
+      if(!first && coefficient >= 0) {
+        fprintf(stream, "+ ");
+      }
+
+      fprintf(stream, "%.2lfx^%lu ", coefficient, degree);
+      first = 0;
+    }
+
+    fprintf(stream, "\n");
+  }
+
+  return !ferror(stream);
+}
@@ -0,0 +1,320 @@
+#ifndef H_POLYNOMIAL_BATCH
+#define H_POLYNOMIAL_BATCH
+
+#include <stdio.h>
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A batch stores many polynomials contiguously, in a compressed sparse row layout:
+ * a single buffer holds the dense coefficients of every polynomial, one after the other,
+ * and an array of offsets tells where each polynomial starts.
+ *
+ * The coefficients of polynomial i, sorted in ascending order, are
+ * coefficients[offsets[i]] to coefficients[offsets[i + 1] - 1].
+ * Every polynomial holds at least one coefficient: the null polynomial is stored as a single 0.
+ *
+ * Batch-wide functions stream through the buffer linearly,
+ * and share the polynomials between several threads (see polynomial_batch_set_threads).
+ *
+ * Coefficients are stored as doubles, or as floats to halve the memory read by evaluations,
+ * which are then bound by memory bandwidth rather than by arithmetic (see polynomial_batch_convert).
+ * A float coefficient is the double one rounded to 24 bits:
+ * - its relative error is at most 2^-24, about 6e-8,
+ *   so the value of a polynomial at x moves by at most 6e-8 * sum(|a_i x^i|),
+ * - beyond 3.4e38 in absolute value it becomes infinite,
+ *   below 1.2e-38 it loses precision, and below 1.4e-45 it becomes 0.
+ * polynomial_batch_compute and polynomial_batch_compute_points accumulate in double whatever the storage,
+ * adding no error of their own beyond that of a double Horner method.
+ * polynomial_batch_compute_points_float accumulates in float, computing twice as many points per instruction,
+ * which adds up to about 2n * 6e-8 * sum(|a_i x^i|) for a polynomial of degree n.
+ * Other functions work on a double copy of a float batch, and return float batches.
+ */
+typedef struct PolynomialBatch PolynomialBatch;
+
+typedef enum {
+  POLYNOMIAL_BATCH_DOUBLE,
+  POLYNOMIAL_BATCH_FLOAT
+} POLYNOMIAL_BATCH_PRECISION;
+
+
+/*
+ * @function polynomial_batch_append
+ *
+ * Appends a copy of polynomial at the end of batch.
+ */
+extern void polynomial_batch_append(PolynomialBatch *batch, const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_batch_compute
+ *
+ * Computes every polynomial of the batch with x, by the Horner method.
+ *
+ * @param double *results
+ * Its length must be at least polynomial_batch_get_length(batch).
+ * results[i] is set to the value of polynomial i.
+ */
+extern void polynomial_batch_compute(const PolynomialBatch *batch, double x, double *results);
+
+
+/*
+ * @function polynomial_batch_compute_points
+ *
+ * Computes every polynomial of the batch with every point.
+ * Each polynomial is read once, for a block of points at a time.
+ *
+ * @param double *results
+ * Its length must be at least polynomial_batch_get_length(batch) * number_of_points.
+ * results[i * number_of_points + j] is set to the value of polynomial i at points[j].
+ */
+extern void polynomial_batch_compute_points(const PolynomialBatch *batch, const double *points, unsigned long number_of_points, double *results);
+
+
+/*
+ * @function polynomial_batch_compute_points_float
+ *
+ * Same as polynomial_batch_compute_points, in float: coefficients of a double batch are rounded as they are read.
+ */
+extern void polynomial_batch_compute_points_float(const PolynomialBatch *batch, const float *points, unsigned long number_of_points, float *results);
+
+
+/*
+ * @function polynomial_batch_convert
+ *
+ * @return PolynomialBatch*
+ * A copy of batch, with its coefficients stored in precision.
+ * Must be freed with polynomial_batch_free after use.
+ */
+extern PolynomialBatch* polynomial_batch_convert(const PolynomialBatch *batch, POLYNOMIAL_BATCH_PRECISION precision);
+
+
+/*
+ * @function polynomial_batch_create
+ *
+ * @return PolynomialBatch*
+ * An empty batch. Must be freed with polynomial_batch_free after use.
+ */
+extern PolynomialBatch* polynomial_batch_create(void);
+
+
+/*
+ * @function polynomial_batch_create_from_binary_stream
+ *
+ * Reads a batch written by polynomial_batch_write_to_binary_stream, in the precision it was written in.
+ * The counts of its header are checked before anything is allocated, against the size of stream when it is known,
+ * and memory only grows with what is actually read, so that a malformed header can't exhaust memory.
+ *
+ * @return PolynomialBatch*
+ * Must be freed with polynomial_batch_free after use.
+ * NULL if the stream is not a binary batch or is truncated, polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern PolynomialBatch* polynomial_batch_create_from_binary_stream(FILE *stream);
+
+
+/*
+ * @function polynomial_batch_create_from_file
+ *
+ * Reads a file written by polynomial_write_to_file or polynomial_batch_write_to_file,
+ * one polynomial per line. Lines are not limited in length.
+ *
+ * @return PolynomialBatch*
+ * Must be freed with polynomial_batch_free after use.
+ * NULL if the file couldn't be opened or holds a malformed polynomial,
+ * polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern PolynomialBatch* polynomial_batch_create_from_file(const char *filename);
+
+
+/*
+ * @function polynomial_batch_create_from_polynomials
+ *
+ * @return PolynomialBatch*
+ * A batch holding a copy of the length polynomials, in the same order.
+ * Must be freed with polynomial_batch_free after use.
+ */
+extern PolynomialBatch* polynomial_batch_create_from_polynomials(const Polynomial **polynomials, unsigned long length);
+
+
+/*
+ * @function polynomial_batch_create_from_stream
+ *
+ * Same as polynomial_batch_create_from_file, reading stream until its end.
+ * NULL is also returned if reading fails.
+ */
+extern PolynomialBatch* polynomial_batch_create_from_stream(FILE *stream);
+
+
+/*
+ * @function polynomial_batch_derivative
+ *
+ * @return PolynomialBatch*
+ * A batch holding the derivative of every polynomial of batch, in the same order.
+ * Must be freed with polynomial_batch_free after use.
+ */
+extern PolynomialBatch* polynomial_batch_derivative(const PolynomialBatch *batch);
+
+
+/*
+ * @function polynomial_batch_free
+ *
+ * Frees associated resources and sets *batch to NULL to prevent further use.
+ */
+extern void polynomial_batch_free(PolynomialBatch **batch);
+
+
+/*
+ * @function polynomial_batch_fingerprint
+ *
+ * Computes the fingerprint of every polynomial of the batch at point, see polynomial_fingerprint.
+ *
+ * @param unsigned long long *fingerprints
+ * Its length must be at least polynomial_batch_get_length(batch).
+ *
+ * @return int
+ * 1 on success, 0 if a coefficient is not an integer or doesn't fit in 63 bits: fingerprints are then incomplete.
+ */
+extern int polynomial_batch_fingerprint(const PolynomialBatch *batch, unsigned long long point, unsigned long long *fingerprints);
+
+
+/*
+ * @function polynomial_batch_get
+ *
+ * @return Polynomial*
+ * A copy of polynomial index. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_batch_get(const PolynomialBatch *batch, unsigned long index);
+
+
+/*
+ * @function polynomial_batch_get_coefficients
+ *
+ * Runs in constant time. batch must be a double batch.
+ *
+ * @return const double*
+ * The coefficients of polynomial index, sorted in ascending order, stored inside the batch.
+ * They are polynomial_batch_get_degree(batch, index) + 1.
+ */
+extern const double* polynomial_batch_get_coefficients(const PolynomialBatch *batch, unsigned long index);
+
+
+/*
+ * @function polynomial_batch_get_coefficients_float
+ *
+ * Same as polynomial_batch_get_coefficients, for a float batch.
+ */
+extern const float* polynomial_batch_get_coefficients_float(const PolynomialBatch *batch, unsigned long index);
+
+
+/*
+ * @function polynomial_batch_get_degree
+ *
+ * Runs in constant time.
+ */
+extern long polynomial_batch_get_degree(const PolynomialBatch *batch, unsigned long index);
+
+
+/*
+ * @function polynomial_batch_get_length
+ *
+ * @return unsigned long
+ * The number of polynomials in the batch.
+ */
+extern unsigned long polynomial_batch_get_length(const PolynomialBatch *batch);
+
+
+/*
+ * @function polynomial_batch_get_precision
+ *
+ * @return POLYNOMIAL_BATCH_PRECISION
+ * How the coefficients of batch are stored. Batches are created in POLYNOMIAL_BATCH_DOUBLE.
+ */
+extern POLYNOMIAL_BATCH_PRECISION polynomial_batch_get_precision(const PolynomialBatch *batch);
+
+
+/*
+ * @function polynomial_batch_hash
+ *
+ * Hashes every polynomial of the batch, several coefficients at a time, see polynomial_hash_with_tolerance.
+ * A polynomial has the same hash in a batch and out of it.
+ *
+ * @param unsigned long long *hashes
+ * Its length must be at least polynomial_batch_get_length(batch).
+ */
+extern void polynomial_batch_hash(const PolynomialBatch *batch, double tolerance, unsigned long long *hashes);
+
+
+/*
+ * @function polynomial_batch_set_threads
+ *
+ * Sets the number of threads used by batch-wide functions.
+ * 0, the default, uses one thread per online processor.
+ * Small batches are always processed by the calling thread alone.
+ */
+extern void polynomial_batch_set_threads(unsigned int threads);
+
+
+/*
+ * @function polynomial_batch_sum
+ *
+ * @return Polynomial*
+ * The sum of every polynomial of the batch. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_batch_sum(const PolynomialBatch *batch);
+
+
+/*
+ * @function polynomial_batch_unique
+ *
+ * Removes the duplicates from a batch, by hashing its polynomials.
+ * With a tolerance, polynomials are duplicates when their coefficients round to the same multiples of it.
+ *
+ * @return PolynomialBatch*
+ * The first occurrence of each polynomial, in the order of batch, with its coefficients unchanged.
+ * Must be freed with polynomial_batch_free after use.
+ */
+extern PolynomialBatch* polynomial_batch_unique(const PolynomialBatch *batch, double tolerance);
+
+
+/*
+ * @function polynomial_batch_write_to_binary_stream
+ *
+ * Writes the batch as it is stored in memory, in its precision: coefficients are kept exactly.
+ * The format uses the host's byte order, it is meant to be read back on the same kind of machine.
+ *
+ * @return int
+ * 1 on success, 0 on failure, polynomials_errno is then set to POLYNOMIAL_OUTPUT_ERROR.
+ */
+extern int polynomial_batch_write_to_binary_stream(const PolynomialBatch *batch, FILE *stream);
+
+
+/*
+ * @function polynomial_batch_write_to_file
+ *
+ * Writes the polynomials of the batch to filename, one per line,
+ * in the same format as polynomial_write_to_file.
+ *
+ * @return int
+ * 1 on success, 0 on failure.
+ */
+extern int polynomial_batch_write_to_file(const PolynomialBatch *batch, const char *filename);
+
+
+/*
+ * @function polynomial_batch_write_to_stream
+ *
+ * Same as polynomial_batch_write_to_file, on a stream which is not closed.
+ */
+extern int polynomial_batch_write_to_stream(const PolynomialBatch *batch, FILE *stream);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
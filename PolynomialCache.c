@@ -0,0 +1,551 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Polynomial.h"
+#include "PolynomialCache.h"
+
+#define CACHE_INITIAL_BUCKETS 64
+
+// estimated size of a monomial: its coefficient, its degree and the link to the next one
+#define CACHE_MONOMIAL_SIZE (sizeof(double) + sizeof(long) + sizeof(void*))
+
+// estimated size of a Polynomial structure, which is opaque here
+#define CACHE_POLYNOMIAL_SIZE 64
+
+typedef enum {
+  CACHE_PRODUCT,
+  CACHE_POWER,
+  CACHE_DERIVATIVE
+} CACHE_OPERATION;
+
+typedef struct CacheEntry CacheEntry;
+
+struct CacheEntry {
+  CACHE_OPERATION operation;
+  int parameter; // the power of CACHE_POWER, 0 otherwise
+  unsigned long long key;
+  unsigned long long hash; // of operands[0]
+  Polynomial *operands[2]; // operands[1] is only used by CACHE_PRODUCT
+  Polynomial *result;
+  size_t memory;
+
+  CacheEntry *chain; // next entry in the same bucket
+  CacheEntry *newer, *older; // neighbours in the list of entries, from the most to the least recently used
+};
+
+/*
+ * The powers of a polynomial currently cached, sorted in ascending order,
+ * so that polynomial_cache_power finds the highest one below the power it needs without trying each.
+ */
+typedef struct CachePowers CachePowers;
+
+struct CachePowers {
+  unsigned long long hash;
+  Polynomial *base;
+  int *powers;
+  unsigned int length;
+  unsigned int capacity;
+
+  CachePowers *chain;
+};
+
+struct PolynomialCache {
+  pthread_mutex_t mutex;
+
+  // both tables have number_of_buckets buckets, a power of 2
+  CacheEntry **entries;
+  CachePowers **powers;
+  unsigned long number_of_buckets;
+
+  CacheEntry *newest, *oldest;
+
+  PolynomialCacheStatistics statistics;
+};
+
+
+static void* cache_allocate(size_t size) {
+  void *memory = malloc(size);
+  if(!memory) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return memory;
+}
+
+
+static inline unsigned long long cache_mix(unsigned long long x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+
+static unsigned long long cache_key(CACHE_OPERATION operation, int parameter, unsigned long long left, unsigned long long right) {
+  unsigned long long key = cache_mix(((unsigned long long) operation << 32) ^ (unsigned int) parameter);
+  key = cache_mix(key ^ left);
+  return cache_mix(key ^ right);
+}
+
+
+static size_t cache_polynomial_memory(const Polynomial *polynomial) {
+  return CACHE_POLYNOMIAL_SIZE + CACHE_MONOMIAL_SIZE * polynomial_get_number_of_monomials(polynomial);
+}
+
+
+static CachePowers** cache_find_powers(PolynomialCache *cache, const Polynomial *base, unsigned long long hash) {
+  CachePowers **powers = &cache->powers[hash & (cache->number_of_buckets - 1)];
+  while(*powers != NULL && ((*powers)->hash != hash || !polynomial_equals((*powers)->base, base))) {
+    powers = &(*powers)->chain;
+  }
+
+  return powers;
+}
+
+
+static void cache_add_power(PolynomialCache *cache, const CacheEntry *entry) {
+  CachePowers **found = cache_find_powers(cache, entry->operands[0], entry->hash);
+  CachePowers *powers = *found;
+
+  if(powers == NULL) {
+    powers = cache_allocate(sizeof(CachePowers));
+    powers->hash = entry->hash;
+    powers->base = polynomial_copy(entry->operands[0]);
+    powers->length = 0;
+    powers->capacity = 4;
+    powers->powers = cache_allocate(sizeof(int) * powers->capacity);
+    powers->chain = NULL;
+    *found = powers;
+  }
+
+  if(powers->length == powers->capacity) {
+    powers->capacity *= 2;
+    int *bigger = realloc(powers->powers, sizeof(int) * powers->capacity);
+    if(!bigger) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(int) * powers->capacity);
+      exit(EXIT_FAILURE);
+    }
+    powers->powers = bigger;
+  }
+
+  unsigned int index = powers->length;
+  while(index > 0 && powers->powers[index - 1] > entry->parameter) {
+    powers->powers[index] = powers->powers[index - 1];
+    index--;
+  }
+  powers->powers[index] = entry->parameter;
+  powers->length++;
+}
+
+
+static void cache_remove_power(PolynomialCache *cache, const CacheEntry *entry) {
+  CachePowers **found = cache_find_powers(cache, entry->operands[0], entry->hash);
+  CachePowers *powers = *found;
+  assert(powers != NULL);
+
+  unsigned int index = 0;
+  while(powers->powers[index] != entry->parameter) {
+    index++;
+  }
+  powers->length--;
+  for(; index < powers->length; index++) {
+    powers->powers[index] = powers->powers[index + 1];
+  }
+
+  if(powers->length == 0) {
+    *found = powers->chain;
+    polynomial_free(&powers->base);
+    free(powers->powers);
+    free(powers);
+  }
+}
+
+
+static void cache_unlink(PolynomialCache *cache, CacheEntry *entry) {
+  if(entry->newer != NULL) {
+    entry->newer->older = entry->older;
+  } else {
+    cache->newest = entry->older;
+  }
+
+  if(entry->older != NULL) {
+    entry->older->newer = entry->newer;
+  } else {
+    cache->oldest = entry->newer;
+  }
+}
+
+
+static void cache_push_newest(PolynomialCache *cache, CacheEntry *entry) {
+  entry->newer = NULL;
+  entry->older = cache->newest;
+  if(cache->newest != NULL) {
+    cache->newest->newer = entry;
+  } else {
+    cache->oldest = entry;
+  }
+  cache->newest = entry;
+}
+
+
+/*
+ * Removes entry from cache and frees it. The mutex must be held.
+ */
+static void cache_evict(PolynomialCache *cache, CacheEntry *entry) {
+  CacheEntry **bucket = &cache->entries[entry->key & (cache->number_of_buckets - 1)];
+  while(*bucket != entry) {
+    bucket = &(*bucket)->chain;
+  }
+  *bucket = entry->chain;
+
+  cache_unlink(cache, entry);
+
+  if(entry->operation == CACHE_POWER) {
+    cache_remove_power(cache, entry);
+  }
+
+  cache->statistics.entries--;
+  cache->statistics.memory -= entry->memory;
+
+  polynomial_free(&entry->operands[0]);
+  if(entry->operands[1] != NULL) {
+    polynomial_free(&entry->operands[1]);
+  }
+  polynomial_free(&entry->result);
+  free(entry);
+}
+
+
+/*
+ * Doubles the number of buckets of both tables. The mutex must be held.
+ */
+static void cache_grow(PolynomialCache *cache) {
+  unsigned long number_of_buckets = cache->number_of_buckets * 2;
+  CacheEntry **entries = cache_allocate(sizeof(CacheEntry*) * number_of_buckets);
+  CachePowers **powers = cache_allocate(sizeof(CachePowers*) * number_of_buckets);
+  for(unsigned long index = 0; index < number_of_buckets; index++) {
+    entries[index] = NULL;
+    powers[index] = NULL;
+  }
+
+  for(unsigned long index = 0; index < cache->number_of_buckets; index++) {
+    CacheEntry *entry = cache->entries[index];
+    while(entry != NULL) {
+      CacheEntry *next = entry->chain;
+      CacheEntry **bucket = &entries[entry->key & (number_of_buckets - 1)];
+      entry->chain = *bucket;
+      *bucket = entry;
+      entry = next;
+    }
+
+    CachePowers *current = cache->powers[index];
+    while(current != NULL) {
+      CachePowers *next = current->chain;
+      CachePowers **bucket = &powers[current->hash & (number_of_buckets - 1)];
+      current->chain = *bucket;
+      *bucket = current;
+      current = next;
+    }
+  }
+
+  free(cache->entries);
+  free(cache->powers);
+  cache->entries = entries;
+  cache->powers = powers;
+  cache->number_of_buckets = number_of_buckets;
+}
+
+
+/*
+ * Finds an entry. The mutex must be held.
+ */
+static CacheEntry* cache_find(PolynomialCache *cache, CACHE_OPERATION operation, int parameter, unsigned long long key, const Polynomial *left, const Polynomial *right) {
+  CacheEntry *entry = cache->entries[key & (cache->number_of_buckets - 1)];
+  while(entry != NULL) {
+    if(entry->key == key && entry->operation == operation && entry->parameter == parameter
+      && polynomial_equals(entry->operands[0], left)
+      && (right == NULL || polynomial_equals(entry->operands[1], right))) {
+      return entry;
+    }
+    entry = entry->chain;
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return Polynomial*
+ * A copy of the cached result, or NULL if it isn't cached.
+ */
+static Polynomial* cache_lookup(PolynomialCache *cache, CACHE_OPERATION operation, int parameter, unsigned long long key, const Polynomial *left, const Polynomial *right) {
+  Polynomial *result = NULL;
+
+  pthread_mutex_lock(&cache->mutex);
+
+  CacheEntry *entry = cache_find(cache, operation, parameter, key, left, right);
+  if(entry != NULL) {
+    cache_unlink(cache, entry);
+    cache_push_newest(cache, entry);
+    result = polynomial_copy(entry->result);
+    cache->statistics.hits++;
+  } else {
+    cache->statistics.misses++;
+  }
+
+  pthread_mutex_unlock(&cache->mutex);
+
+  return result;
+}
+
+
+/*
+ * Caches result, then evicts the least recently used entries until the cache fits its memory limit.
+ * If another thread cached the same result meanwhile, keeps that one.
+ */
+static void cache_insert(PolynomialCache *cache, CACHE_OPERATION operation, int parameter, unsigned long long key, const Polynomial *left, const Polynomial *right, const Polynomial *result, unsigned long long left_hash) {
+  size_t memory = sizeof(CacheEntry) + cache_polynomial_memory(left) + cache_polynomial_memory(result);
+  if(right != NULL) {
+    memory += cache_polynomial_memory(right);
+  }
+  if(operation == CACHE_POWER) {
+    memory += sizeof(int);
+  }
+
+  if(memory > cache->statistics.memory_limit) {
+    return;
+  }
+
+  pthread_mutex_lock(&cache->mutex);
+
+  if(cache_find(cache, operation, parameter, key, left, right) != NULL) {
+    pthread_mutex_unlock(&cache->mutex);
+    return;
+  }
+
+  if(cache->statistics.entries >= cache->number_of_buckets) {
+    cache_grow(cache);
+  }
+
+  CacheEntry *entry = cache_allocate(sizeof(CacheEntry));
+  entry->operation = operation;
+  entry->parameter = parameter;
+  entry->key = key;
+  entry->hash = left_hash;
+  entry->operands[0] = polynomial_copy(left);
+  entry->operands[1] = (right != NULL) ? polynomial_copy(right) : NULL;
+  entry->result = polynomial_copy(result);
+  entry->memory = memory;
+
+  CacheEntry **bucket = &cache->entries[key & (cache->number_of_buckets - 1)];
+  entry->chain = *bucket;
+  *bucket = entry;
+  cache_push_newest(cache, entry);
+
+  if(operation == CACHE_POWER) {
+    cache_add_power(cache, entry);
+  }
+
+  cache->statistics.entries++;
+  cache->statistics.memory += memory;
+
+  while(cache->statistics.memory > cache->statistics.memory_limit) {
+    cache_evict(cache, cache->oldest);
+    cache->statistics.evictions++;
+  }
+
+  pthread_mutex_unlock(&cache->mutex);
+}
+
+
+/*
+ * @return int
+ * The highest power of base which is cached and at most power, 0 if there is none.
+ */
+static int cache_highest_power(PolynomialCache *cache, const Polynomial *base, unsigned long long hash, int power) {
+  int highest = 0;
+
+  pthread_mutex_lock(&cache->mutex);
+
+  CachePowers *powers = *cache_find_powers(cache, base, hash);
+  if(powers != NULL) {
+    // binary search for the last power <= power
+    unsigned int low = 0, high = powers->length;
+    while(low < high) {
+      unsigned int middle = low + (high - low) / 2;
+      if(powers->powers[middle] <= power) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    if(low > 0) {
+      highest = powers->powers[low - 1];
+    }
+  }
+
+  pthread_mutex_unlock(&cache->mutex);
+
+  return highest;
+}
+
+
+static Polynomial* cache_power(PolynomialCache *cache, const Polynomial *polynomial, unsigned long long hash, int power) {
+  if(power == 1) {
+    return polynomial_copy(polynomial);
+  }
+
+  unsigned long long key = cache_key(CACHE_POWER, power, hash, 0);
+  Polynomial *result = cache_lookup(cache, CACHE_POWER, power, key, polynomial, NULL);
+  if(result != NULL) {
+    return result;
+  }
+
+  /*
+   * polynomial ^ power = polynomial ^ split * polynomial ^ (power - split).
+   * The highest cached power is used as split if it's at least half of power, so that a single product is needed.
+   * Otherwise, split is half of power: like binary exponentiation, only log2(power) products are needed,
+   * and the intermediate powers are cached for the next calls.
+   */
+  int highest = cache_highest_power(cache, polynomial, hash, power - 1);
+  int split = (highest >= power - highest) ? highest : (power + 1) / 2;
+
+  Polynomial *high = cache_power(cache, polynomial, hash, split);
+  Polynomial *low = (power - split == split) ? polynomial_copy(high) : cache_power(cache, polynomial, hash, power - split);
+
+  result = polynomial_product(high, low);
+
+  polynomial_free(&high);
+  polynomial_free(&low);
+
+  cache_insert(cache, CACHE_POWER, power, key, polynomial, NULL, result, hash);
+
+  return result;
+}
+
+
+void polynomial_cache_clear(PolynomialCache *cache) {
+  assert(cache != NULL);
+
+  pthread_mutex_lock(&cache->mutex);
+
+  while(cache->oldest != NULL) {
+    cache_evict(cache, cache->oldest);
+  }
+
+  pthread_mutex_unlock(&cache->mutex);
+}
+
+
+PolynomialCache* polynomial_cache_create(size_t memory_limit) {
+  PolynomialCache *cache = cache_allocate(sizeof(PolynomialCache));
+
+  pthread_mutex_init(&cache->mutex, NULL);
+
+  cache->number_of_buckets = CACHE_INITIAL_BUCKETS;
+  cache->entries = cache_allocate(sizeof(CacheEntry*) * cache->number_of_buckets);
+  cache->powers = cache_allocate(sizeof(CachePowers*) * cache->number_of_buckets);
+  for(unsigned long index = 0; index < cache->number_of_buckets; index++) {
+    cache->entries[index] = NULL;
+    cache->powers[index] = NULL;
+  }
+
+  cache->newest = NULL;
+  cache->oldest = NULL;
+
+  cache->statistics.hits = 0;
+  cache->statistics.misses = 0;
+  cache->statistics.evictions = 0;
+  cache->statistics.entries = 0;
+  cache->statistics.memory = 0;
+  cache->statistics.memory_limit = memory_limit;
+
+  return cache;
+}
+
+
+Polynomial* polynomial_cache_derivative(PolynomialCache *cache, const Polynomial *polynomial) {
+  assert(cache != NULL);
+  assert(polynomial != NULL);
+
+  unsigned long long hash = polynomial_hash(polynomial);
+  unsigned long long key = cache_key(CACHE_DERIVATIVE, 0, hash, 0);
+
+  Polynomial *result = cache_lookup(cache, CACHE_DERIVATIVE, 0, key, polynomial, NULL);
+  if(result == NULL) {
+    result = polynomial_derivative(polynomial);
+    cache_insert(cache, CACHE_DERIVATIVE, 0, key, polynomial, NULL, result, hash);
+  }
+
+  return result;
+}
+
+
+void polynomial_cache_free(PolynomialCache **cache) {
+  assert(cache != NULL);
+  assert(*cache != NULL);
+
+  polynomial_cache_clear(*cache);
+
+  pthread_mutex_destroy(&(*cache)->mutex);
+  free((*cache)->entries);
+  free((*cache)->powers);
+  free(*cache);
+  *cache = NULL;
+}
+
+
+void polynomial_cache_get_statistics(PolynomialCache *cache, PolynomialCacheStatistics *statistics) {
+  assert(cache != NULL);
+  assert(statistics != NULL);
+
+  pthread_mutex_lock(&cache->mutex);
+  *statistics = cache->statistics;
+  pthread_mutex_unlock(&cache->mutex);
+}
+
+
+Polynomial* polynomial_cache_power(PolynomialCache *cache, const Polynomial *polynomial, int power) {
+  assert(cache != NULL);
+  assert(polynomial != NULL);
+  assert(power > 0);
+
+  return cache_power(cache, polynomial, polynomial_hash(polynomial), power);
+}
+
+
+Polynomial* polynomial_cache_product(PolynomialCache *cache, const Polynomial *leftp, const Polynomial *rightp) {
+  assert(cache != NULL);
+  assert(leftp != NULL);
+  assert(rightp != NULL);
+
+  unsigned long long left_hash = polynomial_hash(leftp), right_hash = polynomial_hash(rightp);
+
+  // the product commutes: order the operands by hash so that both orders share an entry
+  if(left_hash > right_hash) {
+    const Polynomial *operand = leftp;
+    leftp = rightp;
+    rightp = operand;
+
+    unsigned long long hash = left_hash;
+    left_hash = right_hash;
+    right_hash = hash;
+  }
+
+  unsigned long long key = cache_key(CACHE_PRODUCT, 0, left_hash, right_hash);
+
+  Polynomial *result = cache_lookup(cache, CACHE_PRODUCT, 0, key, leftp, rightp);
+  if(result == NULL) {
+    result = polynomial_product(leftp, rightp);
+    cache_insert(cache, CACHE_PRODUCT, 0, key, leftp, rightp, result, left_hash);
+  }
+
+  return result;
+}
@@ -0,0 +1,117 @@
+#ifndef H_POLYNOMIAL_CACHE
+#define H_POLYNOMIAL_CACHE
+
+#include <stddef.h>
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A cache remembers the results of products, powers and derivatives,
+ * so that computing them again with the same operands only costs a lookup.
+ *
+ * Results are keyed by the operation, its parameter and the hashes of its operands (see polynomial_hash),
+ * and the operands themselves are compared on a hit, so a collision never returns a wrong result.
+ * Operands and results are kept as copies sharing their monomials (see polynomial_copy),
+ * so caching them doesn't duplicate anything.
+ *
+ * The memory used by the cache is bounded: when it goes over its limit,
+ * the least recently used results are evicted first.
+ * A cache may be used by several threads at once.
+ */
+typedef struct PolynomialCache PolynomialCache;
+
+
+typedef struct {
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  unsigned long entries; // results currently held
+  size_t memory; // estimated bytes currently held
+  size_t memory_limit;
+} PolynomialCacheStatistics;
+
+
+/*
+ * @function polynomial_cache_clear
+ *
+ * Evicts every result of cache. Statistics are kept.
+ */
+extern void polynomial_cache_clear(PolynomialCache *cache);
+
+
+/*
+ * @function polynomial_cache_create
+ *
+ * @param size_t memory_limit
+ * Maximum number of bytes held by the cache, estimated from the number of monomials it holds.
+ * A result bigger than this is computed but never cached.
+ *
+ * @return PolynomialCache*
+ * An empty cache. Must be freed with polynomial_cache_free after use.
+ */
+extern PolynomialCache* polynomial_cache_create(size_t memory_limit);
+
+
+/*
+ * @function polynomial_cache_derivative
+ *
+ * Same as polynomial_derivative, through cache.
+ *
+ * @return Polynomial*
+ * The derivative of polynomial. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_cache_derivative(PolynomialCache *cache, const Polynomial *polynomial);
+
+
+/*
+ * @function polynomial_cache_free
+ *
+ * Frees associated resources and sets *cache to NULL to prevent further use.
+ */
+extern void polynomial_cache_free(PolynomialCache **cache);
+
+
+/*
+ * @function polynomial_cache_get_statistics
+ *
+ * Copies the current statistics of cache into statistics.
+ */
+extern void polynomial_cache_get_statistics(PolynomialCache *cache, PolynomialCacheStatistics *statistics);
+
+
+/*
+ * @function polynomial_cache_power
+ *
+ * Same as polynomial_power, through cache.
+ * When polynomial ^ power isn't cached, it starts from the highest power of polynomial which is,
+ * so computing p, p^2, ..., p^n one after the other costs a single product each.
+ * The intermediate powers it computes are cached as well.
+ *
+ * @return Polynomial*
+ * The result of polynomial ^ power. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_cache_power(PolynomialCache *cache, const Polynomial *polynomial, int power);
+
+
+/*
+ * @function polynomial_cache_product
+ *
+ * Same as polynomial_product, through cache.
+ * leftp * rightp and rightp * leftp are the same result.
+ *
+ * @return Polynomial*
+ * The result of the product of leftp and rightp. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_cache_product(PolynomialCache *cache, const Polynomial *leftp, const Polynomial *rightp);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
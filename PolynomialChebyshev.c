@@ -0,0 +1,217 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Coefficients.h"
+#include "PolynomialChebyshev.h"
+
+// number of points computed together by polynomial_chebyshev_compute_points, the width of a SSE2 register
+#define CHEBYSHEV_BATCH_WIDTH 2
+
+typedef double ChebyshevVector __attribute__((vector_size(CHEBYSHEV_BATCH_WIDTH * sizeof(double))));
+
+struct PolynomialChebyshev {
+  double *coefficients;
+  long degree;
+
+  // t = (x - center) * scale goes from -1 to 1 on [lower, upper]
+  double lower, upper;
+  double center, scale;
+};
+
+
+static void* chebyshev_allocate(size_t size) {
+  void *memory = malloc(size);
+  if(!memory) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return memory;
+}
+
+
+// takes ownership of coefficients
+static PolynomialChebyshev* chebyshev_create(double *coefficients, long degree, double lower, double upper) {
+  assert(lower < upper);
+
+  PolynomialChebyshev *chebyshev = chebyshev_allocate(sizeof(PolynomialChebyshev));
+  chebyshev->coefficients = coefficients;
+  chebyshev->degree = degree;
+  chebyshev->lower = lower;
+  chebyshev->upper = upper;
+  chebyshev->center = (lower + upper) / 2;
+  chebyshev->scale = 2 / (upper - lower);
+
+  return chebyshev;
+}
+
+
+/*
+ * The Clenshaw recurrence: b_k = c_k + 2t b_(k + 1) - b_(k + 2), and the value is c_0 + t b_1 - b_2.
+ * Like the Horner method, it costs one multiplication and two additions per coefficient,
+ * but its rounding errors stay of the order of the coefficients, instead of growing with the degree.
+ */
+double polynomial_chebyshev_compute(const PolynomialChebyshev *chebyshev, double x) {
+  assert(chebyshev != NULL);
+
+  const double *coefficients = chebyshev->coefficients;
+  double t = (x - chebyshev->center) * chebyshev->scale;
+  double next = 0, after_next = 0;
+
+  long index;
+  for(index = chebyshev->degree; index > 0; index--) {
+    double current = coefficients[index] + 2 * t * next - after_next;
+    after_next = next;
+    next = current;
+  }
+
+  return coefficients[0] + t * next - after_next;
+}
+
+
+void polynomial_chebyshev_compute_points(const PolynomialChebyshev *chebyshev, const double *points, unsigned long number_of_points, double *values) {
+  assert(chebyshev != NULL);
+  assert(points != NULL);
+  assert(values != NULL);
+
+  const double *coefficients = chebyshev->coefficients;
+
+  unsigned long point = 0;
+  for(; point + CHEBYSHEV_BATCH_WIDTH <= number_of_points; point += CHEBYSHEV_BATCH_WIDTH) {
+    ChebyshevVector x;
+    memcpy(&x, points + point, sizeof(x));
+
+    ChebyshevVector t = (x - chebyshev->center) * chebyshev->scale;
+    ChebyshevVector twice_t = t + t;
+    ChebyshevVector next = { 0 }, after_next = { 0 };
+
+    long index;
+    for(index = chebyshev->degree; index > 0; index--) {
+      ChebyshevVector current = coefficients[index] + twice_t * next - after_next;
+      after_next = next;
+      next = current;
+    }
+
+    ChebyshevVector value = coefficients[0] + t * next - after_next;
+    memcpy(values + point, &value, sizeof(value));
+  }
+
+  for(; point < number_of_points; point++) {
+    values[point] = polynomial_chebyshev_compute(chebyshev, points[point]);
+  }
+}
+
+
+PolynomialChebyshev* polynomial_chebyshev_create(const double *coefficients, long degree, double lower, double upper) {
+  assert(coefficients != NULL);
+  assert(degree >= 0);
+
+  double *copy = chebyshev_allocate(sizeof(double) * (degree + 1));
+  memcpy(copy, coefficients, sizeof(double) * (degree + 1));
+
+  return chebyshev_create(copy, degree, lower, upper);
+}
+
+
+PolynomialChebyshev* polynomial_chebyshev_create_from_polynomial(const Polynomial *polynomial, double lower, double upper) {
+  assert(polynomial != NULL);
+  assert(lower < upper);
+
+  long degree = polynomial_get_degree(polynomial);
+  double *monomial = chebyshev_allocate(sizeof(double) * (degree + 1));
+  double *coefficients = chebyshev_allocate(sizeof(double) * (degree + 1));
+
+  // p(x) with x = center + t / scale
+  polynomial_get_coefficients(polynomial, monomial);
+  coefficients_taylor_shift(monomial, degree, (lower + upper) / 2);
+  coefficients_scale_variable(monomial, degree, (upper - lower) / 2);
+
+  coefficients_chebyshev_from_monomial(monomial, degree, coefficients);
+
+  free(monomial);
+
+  return chebyshev_create(coefficients, degree, lower, upper);
+}
+
+
+void polynomial_chebyshev_free(PolynomialChebyshev **chebyshev) {
+  assert(chebyshev != NULL);
+  assert(*chebyshev != NULL);
+
+  free((*chebyshev)->coefficients);
+  free(*chebyshev);
+  *chebyshev = NULL;
+}
+
+
+void polynomial_chebyshev_get_coefficients(const PolynomialChebyshev *chebyshev, double *coefficients) {
+  assert(chebyshev != NULL);
+  assert(coefficients != NULL);
+
+  memcpy(coefficients, chebyshev->coefficients, sizeof(double) * (chebyshev->degree + 1));
+}
+
+
+long polynomial_chebyshev_get_degree(const PolynomialChebyshev *chebyshev) {
+  assert(chebyshev != NULL);
+
+  return chebyshev->degree;
+}
+
+
+PolynomialChebyshev* polynomial_chebyshev_interpolate(const double *values, long degree, double lower, double upper) {
+  assert(values != NULL);
+  assert(degree >= 0);
+
+  double *coefficients = chebyshev_allocate(sizeof(double) * (degree + 1));
+  coefficients_chebyshev_interpolate(values, degree, coefficients);
+
+  return chebyshev_create(coefficients, degree, lower, upper);
+}
+
+
+void polynomial_chebyshev_nodes(long degree, double lower, double upper, double *nodes) {
+  assert(nodes != NULL);
+  assert(lower < upper);
+
+  coefficients_chebyshev_nodes(degree, nodes);
+
+  double center = (lower + upper) / 2, radius = (upper - lower) / 2;
+  long index;
+  for(index = 0; index <= degree; index++) {
+    nodes[index] = center + radius * nodes[index];
+  }
+}
+
+
+Polynomial* polynomial_chebyshev_to_polynomial(const PolynomialChebyshev *chebyshev) {
+  assert(chebyshev != NULL);
+
+  // null coefficients of the highest degrees don't count against COEFFICIENTS_CHEBYSHEV_MAX_DEGREE
+  long degree = chebyshev->degree;
+  while(degree > 0 && chebyshev->coefficients[degree] == 0) {
+    degree--;
+  }
+
+  double *monomial = chebyshev_allocate(sizeof(double) * (degree + 1));
+
+  // p(t) with t = (x - center) * scale
+  if(!coefficients_chebyshev_to_monomial(chebyshev->coefficients, degree, monomial)) {
+    free(monomial);
+
+    errno = ERANGE;
+    polynomials_errno = POLYNOMIAL_MATH_ERROR;
+    return NULL;
+  }
+  coefficients_scale_variable(monomial, degree, chebyshev->scale);
+  coefficients_taylor_shift(monomial, degree, -chebyshev->center);
+
+  Polynomial *polynomial = polynomial_create(monomial, (unsigned int) degree);
+
+  free(monomial);
+
+  return polynomial;
+}
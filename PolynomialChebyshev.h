@@ -0,0 +1,132 @@
+#ifndef H_POLYNOMIAL_CHEBYSHEV
+#define H_POLYNOMIAL_CHEBYSHEV
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A polynomial written in the Chebyshev basis, on an interval [lower, upper]:
+ * the sum of coefficients[k] * T_k(t), where t = (2x - lower - upper) / (upper - lower) goes from -1 to 1.
+ *
+ * This is the basis to use for approximations of high degree on an interval:
+ * the monomial basis is ill-conditioned there, while the Clenshaw recurrence computes a Chebyshev series
+ * accurately in plain double, whatever its degree.
+ * An approximation of a function is obtained by interpolating its values at the Chebyshev nodes of the interval.
+ */
+typedef struct PolynomialChebyshev PolynomialChebyshev;
+
+
+/*
+ * @function polynomial_chebyshev_compute
+ *
+ * Computes chebyshev with x by the Clenshaw recurrence.
+ */
+extern double polynomial_chebyshev_compute(const PolynomialChebyshev *chebyshev, double x);
+
+
+/*
+ * @function polynomial_chebyshev_compute_points
+ *
+ * Computes chebyshev with every point, several points at a time.
+ *
+ * @param double *values
+ * Its length must be at least number_of_points. values[i] is set to the value of chebyshev at points[i].
+ * points and values may be the same array.
+ */
+extern void polynomial_chebyshev_compute_points(const PolynomialChebyshev *chebyshev, const double *points, unsigned long number_of_points, double *values);
+
+
+/*
+ * @function polynomial_chebyshev_create
+ *
+ * @param const double *coefficients
+ * The degree + 1 coefficients of T_0 to T_degree.
+ *
+ * @param double lower, upper
+ * The interval, lower < upper.
+ *
+ * @return PolynomialChebyshev*
+ * Must be freed with polynomial_chebyshev_free after use.
+ */
+extern PolynomialChebyshev* polynomial_chebyshev_create(const double *coefficients, long degree, double lower, double upper);
+
+
+/*
+ * @function polynomial_chebyshev_create_from_polynomial
+ *
+ * Converts polynomial to the Chebyshev basis on [lower, upper].
+ *
+ * @return PolynomialChebyshev*
+ * Must be freed with polynomial_chebyshev_free after use.
+ */
+extern PolynomialChebyshev* polynomial_chebyshev_create_from_polynomial(const Polynomial *polynomial, double lower, double upper);
+
+
+/*
+ * @function polynomial_chebyshev_free
+ *
+ * Frees associated resources and sets *chebyshev to NULL to prevent further use.
+ */
+extern void polynomial_chebyshev_free(PolynomialChebyshev **chebyshev);
+
+
+/*
+ * @function polynomial_chebyshev_get_coefficients
+ *
+ * @param double *coefficients
+ * Its length must be at least the degree of chebyshev + 1. coefficients[k] is set to the coefficient of T_k.
+ */
+extern void polynomial_chebyshev_get_coefficients(const PolynomialChebyshev *chebyshev, double *coefficients);
+
+
+/*
+ * @function polynomial_chebyshev_get_degree
+ */
+extern long polynomial_chebyshev_get_degree(const PolynomialChebyshev *chebyshev);
+
+
+/*
+ * @function polynomial_chebyshev_interpolate
+ *
+ * Computes the polynomial of degree degree which takes values[j] at the j-th node of polynomial_chebyshev_nodes,
+ * in O(n log n).
+ *
+ * @return PolynomialChebyshev*
+ * Must be freed with polynomial_chebyshev_free after use.
+ */
+extern PolynomialChebyshev* polynomial_chebyshev_interpolate(const double *values, long degree, double lower, double upper);
+
+
+/*
+ * @function polynomial_chebyshev_nodes
+ *
+ * Sets nodes[j] to the j-th of the degree + 1 Chebyshev nodes of [lower, upper], from upper down to lower.
+ * The interpolant of a smooth function at these nodes is close to its best approximation of degree degree.
+ */
+extern void polynomial_chebyshev_nodes(long degree, double lower, double upper, double *nodes);
+
+
+/*
+ * @function polynomial_chebyshev_to_polynomial
+ *
+ * Converts chebyshev to the monomial basis.
+ * Like polynomial_create, coefficients closer to 0 than POLYNOMIAL_NULL_TOLERANCE are dropped.
+ * The monomial basis loses accuracy as the degree grows: keep the Chebyshev form for computations.
+ *
+ * @return Polynomial*
+ * Must be freed with polynomial_free after use.
+ * NULL if the degree of chebyshev is over COEFFICIENTS_CHEBYSHEV_MAX_DEGREE, 1024, where the monomial coefficients
+ * can't be represented anymore: polynomials_errno is then set to POLYNOMIAL_MATH_ERROR, and errno to ERANGE.
+ */
+extern Polynomial* polynomial_chebyshev_to_polynomial(const PolynomialChebyshev *chebyshev);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
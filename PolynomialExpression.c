@@ -0,0 +1,663 @@
+#include <assert.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Polynomial.h"
+#include "PolynomialExpression.h"
+
+// deeper nesting of parentheses and signs is rejected, so that parsing never exhausts the stack
+#define EXPRESSION_MAX_DEPTH 1000
+
+// number of points computed together by polynomial_expression_compute_points, for every node
+#define EXPRESSION_POINTS_BLOCK 32
+
+#define EXPRESSION_MAX_NUMBER_LENGTH 64
+
+#define EXPRESSION_INITIAL_CAPACITY 16
+
+typedef enum {
+  EXPRESSION_NUMBER,
+  EXPRESSION_VARIABLE,
+  EXPRESSION_SUM,
+  EXPRESSION_DIFFERENCE,
+  EXPRESSION_PRODUCT,
+  EXPRESSION_NEGATION,
+  EXPRESSION_POWER
+} EXPRESSION_OPERATION;
+
+/*
+ * Unused fields are always 0, so that nodes can be hashed and compared as a whole.
+ */
+typedef struct {
+  EXPRESSION_OPERATION operation;
+  unsigned long left; // the operand of NEGATION and POWER
+  unsigned long right;
+  double number;
+  unsigned long exponent;
+} ExpressionNode;
+
+/*
+ * Nodes are stored in the order they were created, so the operands of a node always come before it:
+ * a single pass over them, from first to last, computes every node after its operands.
+ */
+struct PolynomialExpression {
+  ExpressionNode *nodes;
+  unsigned long length;
+  unsigned long root;
+};
+
+typedef struct {
+  const char *current;
+  int depth;
+  int failed;
+
+  PolynomialExpression *expression;
+  unsigned long capacity;
+
+  // open addressing table of the nodes created so far, at most half full: index of a node + 1, 0 if empty
+  unsigned long *table;
+  unsigned long table_size;
+} ExpressionParser;
+
+
+static void* expression_allocate(void *pointer, size_t size) {
+  void *allocated = realloc(pointer, size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+static double expression_power(double base, unsigned long exponent) {
+  double result = 1;
+  while(exponent > 0) {
+    if(exponent & 1) {
+      result *= base;
+    }
+    base *= base;
+    exponent >>= 1;
+  }
+
+  return result;
+}
+
+
+static unsigned long long expression_node_hash(const ExpressionNode *node) {
+  unsigned long long number;
+  memcpy(&number, &node->number, sizeof(number));
+
+  unsigned long long hash = node->operation;
+  hash = hash * 0x100000001b3ULL ^ node->left;
+  hash = hash * 0x100000001b3ULL ^ node->right;
+  hash = hash * 0x100000001b3ULL ^ number;
+  hash = hash * 0x100000001b3ULL ^ node->exponent;
+
+  hash ^= hash >> 31;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+
+static int expression_node_equals(const ExpressionNode *left, const ExpressionNode *right) {
+  return left->operation == right->operation && left->left == right->left && left->right == right->right
+    && memcmp(&left->number, &right->number, sizeof(double)) == 0 && left->exponent == right->exponent;
+}
+
+
+static void parser_insert(ExpressionParser *parser, unsigned long index) {
+  unsigned long slot = expression_node_hash(&parser->expression->nodes[index]) & (parser->table_size - 1);
+  while(parser->table[slot] != 0) {
+    slot = (slot + 1) & (parser->table_size - 1);
+  }
+  parser->table[slot] = index + 1;
+}
+
+
+/*
+ * @function parser_add
+ *
+ * Folds node if its operands are numbers, then returns the index of an identical node if there is one,
+ * or adds it to the expression.
+ */
+static unsigned long parser_add(ExpressionParser *parser, ExpressionNode node) {
+  const ExpressionNode *nodes = parser->expression->nodes;
+
+  // sums and products commute: order their operands so that a + b and b + a are the same node
+  if((node.operation == EXPRESSION_SUM || node.operation == EXPRESSION_PRODUCT) && node.left > node.right) {
+    unsigned long operand = node.left;
+    node.left = node.right;
+    node.right = operand;
+  }
+
+  if(node.operation == EXPRESSION_POWER && node.exponent == 1) {
+    return node.left;
+  }
+
+  ExpressionNode folded = { EXPRESSION_NUMBER, 0, 0, 0, 0 };
+  int fold = 1;
+  switch(node.operation) {
+    case EXPRESSION_NUMBER:
+    case EXPRESSION_VARIABLE:
+      fold = 0;
+      break;
+
+    case EXPRESSION_SUM:
+    case EXPRESSION_DIFFERENCE:
+    case EXPRESSION_PRODUCT:
+      fold = nodes[node.left].operation == EXPRESSION_NUMBER && nodes[node.right].operation == EXPRESSION_NUMBER;
+      if(fold) {
+        double left = nodes[node.left].number, right = nodes[node.right].number;
+        folded.number = node.operation == EXPRESSION_SUM ? left + right
+          : node.operation == EXPRESSION_DIFFERENCE ? left - right : left * right;
+      }
+      break;
+
+    case EXPRESSION_NEGATION:
+      fold = nodes[node.left].operation == EXPRESSION_NUMBER;
+      if(fold) {
+        folded.number = -nodes[node.left].number;
+      }
+      break;
+
+    case EXPRESSION_POWER:
+      // anything ^ 0 is 1
+      fold = node.exponent == 0 || nodes[node.left].operation == EXPRESSION_NUMBER;
+      if(fold) {
+        folded.number = node.exponent == 0 ? 1 : expression_power(nodes[node.left].number, node.exponent);
+      }
+      break;
+  }
+  if(fold) {
+    node = folded;
+  }
+
+  unsigned long slot = expression_node_hash(&node) & (parser->table_size - 1);
+  while(parser->table[slot] != 0) {
+    if(expression_node_equals(&nodes[parser->table[slot] - 1], &node)) {
+      return parser->table[slot] - 1;
+    }
+    slot = (slot + 1) & (parser->table_size - 1);
+  }
+
+  PolynomialExpression *expression = parser->expression;
+  if(expression->length == parser->capacity) {
+    parser->capacity *= 2;
+    expression->nodes = expression_allocate(expression->nodes, sizeof(ExpressionNode) * parser->capacity);
+  }
+
+  unsigned long index = expression->length++;
+  expression->nodes[index] = node;
+
+  if(2 * expression->length > parser->table_size) {
+    parser->table_size *= 2;
+    free(parser->table);
+    parser->table = calloc(parser->table_size, sizeof(unsigned long));
+    if(!parser->table) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long) * parser->table_size);
+      exit(EXIT_FAILURE);
+    }
+
+    unsigned long current;
+    for(current = 0; current < expression->length; current++) {
+      parser_insert(parser, current);
+    }
+  } else {
+    parser->table[slot] = index + 1;
+  }
+
+  return index;
+}
+
+
+static unsigned long parser_add_operation(ExpressionParser *parser, EXPRESSION_OPERATION operation, unsigned long left, unsigned long right, unsigned long exponent) {
+  ExpressionNode node = { operation, left, right, 0, exponent };
+  return parser_add(parser, node);
+}
+
+
+static unsigned long parser_fail(ExpressionParser *parser) {
+  parser->failed = 1;
+  return 0;
+}
+
+
+static void parser_skip_spaces(ExpressionParser *parser) {
+  while(isspace((unsigned char) *parser->current)) {
+    parser->current++;
+  }
+}
+
+
+static unsigned long parse_sum(ExpressionParser *parser);
+
+
+/*
+ * primary := number | x | ( sum )
+ */
+static unsigned long parse_primary(ExpressionParser *parser) {
+  parser_skip_spaces(parser);
+  char character = *parser->current;
+
+  if(character == '(') {
+    if(++parser->depth > EXPRESSION_MAX_DEPTH) {
+      return parser_fail(parser);
+    }
+
+    parser->current++;
+    unsigned long sum = parse_sum(parser);
+    if(parser->failed) {
+      return 0;
+    }
+
+    parser_skip_spaces(parser);
+    if(*parser->current != ')') {
+      return parser_fail(parser);
+    }
+    parser->current++;
+    parser->depth--;
+
+    return sum;
+  }
+
+  if(character == 'x') {
+    parser->current++;
+    return parser_add_operation(parser, EXPRESSION_VARIABLE, 0, 0, 0);
+  }
+
+  if(isdigit((unsigned char) character) || character == '.') {
+    // only digits and a point: strtod alone would also read exponents, hexadecimal numbers and infinities
+    char buffer[EXPRESSION_MAX_NUMBER_LENGTH + 1];
+    size_t length = 0;
+    while(isdigit((unsigned char) parser->current[length]) || parser->current[length] == '.') {
+      if(length == EXPRESSION_MAX_NUMBER_LENGTH) {
+        return parser_fail(parser);
+      }
+      buffer[length] = parser->current[length];
+      length++;
+    }
+    buffer[length] = '\0';
+
+    char *end;
+    double number = strtod(buffer, &end);
+    if(*end != '\0') {
+      return parser_fail(parser);
+    }
+    parser->current += length;
+
+    ExpressionNode node = { EXPRESSION_NUMBER, 0, 0, number, 0 };
+    return parser_add(parser, node);
+  }
+
+  return parser_fail(parser);
+}
+
+
+/*
+ * power := primary [ ^ natural ]
+ */
+static unsigned long parse_power(ExpressionParser *parser) {
+  unsigned long base = parse_primary(parser);
+  if(parser->failed) {
+    return 0;
+  }
+
+  parser_skip_spaces(parser);
+  if(*parser->current != '^') {
+    return base;
+  }
+  parser->current++;
+  parser_skip_spaces(parser);
+
+  if(!isdigit((unsigned char) *parser->current)) {
+    return parser_fail(parser);
+  }
+
+  // polynomial_power takes an int
+  unsigned long exponent = 0;
+  while(isdigit((unsigned char) *parser->current)) {
+    exponent = exponent * 10 + (*parser->current - '0');
+    if(exponent > INT_MAX) {
+      return parser_fail(parser);
+    }
+    parser->current++;
+  }
+
+  return parser_add_operation(parser, EXPRESSION_POWER, base, 0, exponent);
+}
+
+
+/*
+ * unary := - unary | + unary | power
+ */
+static unsigned long parse_unary(ExpressionParser *parser) {
+  parser_skip_spaces(parser);
+  char sign = *parser->current;
+  if(sign != '-' && sign != '+') {
+    return parse_power(parser);
+  }
+
+  if(++parser->depth > EXPRESSION_MAX_DEPTH) {
+    return parser_fail(parser);
+  }
+
+  parser->current++;
+  unsigned long operand = parse_unary(parser);
+  if(parser->failed) {
+    return 0;
+  }
+  parser->depth--;
+
+  return (sign == '-') ? parser_add_operation(parser, EXPRESSION_NEGATION, operand, 0, 0) : operand;
+}
+
+
+/*
+ * product := unary { * unary | power }
+ * A multiplication is implicit when a power starting with x or ( follows, as in 2x or 5(x - 1).
+ */
+static unsigned long parse_product(ExpressionParser *parser) {
+  unsigned long product = parse_unary(parser);
+
+  while(!parser->failed) {
+    parser_skip_spaces(parser);
+
+    unsigned long factor;
+    if(*parser->current == '*') {
+      parser->current++;
+      factor = parse_unary(parser);
+    } else if(*parser->current == 'x' || *parser->current == '(') {
+      factor = parse_power(parser);
+    } else {
+      break;
+    }
+
+    if(!parser->failed) {
+      product = parser_add_operation(parser, EXPRESSION_PRODUCT, product, factor, 0);
+    }
+  }
+
+  return product;
+}
+
+
+/*
+ * sum := product { + product | - product }
+ */
+static unsigned long parse_sum(ExpressionParser *parser) {
+  unsigned long sum = parse_product(parser);
+
+  while(!parser->failed) {
+    parser_skip_spaces(parser);
+
+    char sign = *parser->current;
+    if(sign != '+' && sign != '-') {
+      break;
+    }
+    parser->current++;
+
+    unsigned long term = parse_product(parser);
+    if(!parser->failed) {
+      sum = parser_add_operation(parser, sign == '+' ? EXPRESSION_SUM : EXPRESSION_DIFFERENCE, sum, term, 0);
+    }
+  }
+
+  return sum;
+}
+
+
+/*
+ * @function expression_release
+ *
+ * Frees the polynomial of node once its last user has been expanded.
+ */
+static void expression_release(Polynomial **polynomials, unsigned long *uses, unsigned long node) {
+  if(--uses[node] == 0) {
+    polynomial_free(&polynomials[node]);
+  }
+}
+
+
+double polynomial_expression_compute(const PolynomialExpression *expression, double x) {
+  double value;
+  polynomial_expression_compute_points(expression, &x, 1, &value);
+
+  return value;
+}
+
+
+void polynomial_expression_compute_points(const PolynomialExpression *expression, const double *points, unsigned long number_of_points, double *values) {
+  assert(expression != NULL);
+  assert(points != NULL || number_of_points == 0);
+  assert(values != NULL || number_of_points == 0);
+
+  // the values of every node for a block of points
+  unsigned long block = (number_of_points < EXPRESSION_POINTS_BLOCK) ? number_of_points : EXPRESSION_POINTS_BLOCK;
+  double *scratch = expression_allocate(NULL, sizeof(double) * expression->length * (block > 0 ? block : 1));
+
+  unsigned long first;
+  for(first = 0; first < number_of_points; first += block) {
+    unsigned long count = (number_of_points - first < block) ? number_of_points - first : block;
+
+    unsigned long index, point;
+    for(index = 0; index < expression->length; index++) {
+      const ExpressionNode *node = &expression->nodes[index];
+      double *result = scratch + index * block;
+      const double *left = scratch + node->left * block, *right = scratch + node->right * block;
+
+      switch(node->operation) {
+        case EXPRESSION_NUMBER:
+          for(point = 0; point < count; point++) {
+            result[point] = node->number;
+          }
+          break;
+
+        case EXPRESSION_VARIABLE:
+          memcpy(result, points + first, sizeof(double) * count);
+          break;
+
+        case EXPRESSION_SUM:
+          for(point = 0; point < count; point++) {
+            result[point] = left[point] + right[point];
+          }
+          break;
+
+        case EXPRESSION_DIFFERENCE:
+          for(point = 0; point < count; point++) {
+            result[point] = left[point] - right[point];
+          }
+          break;
+
+        case EXPRESSION_PRODUCT:
+          for(point = 0; point < count; point++) {
+            result[point] = left[point] * right[point];
+          }
+          break;
+
+        case EXPRESSION_NEGATION:
+          for(point = 0; point < count; point++) {
+            result[point] = -left[point];
+          }
+          break;
+
+        case EXPRESSION_POWER:
+          for(point = 0; point < count; point++) {
+            result[point] = expression_power(left[point], node->exponent);
+          }
+          break;
+      }
+    }
+
+    memcpy(values + first, scratch + expression->root * block, sizeof(double) * count);
+  }
+
+  free(scratch);
+}
+
+
+PolynomialExpression* polynomial_expression_create_from_string(const char *string) {
+  assert(string != NULL);
+
+  ExpressionParser parser;
+  parser.current = string;
+  parser.depth = 0;
+  parser.failed = 0;
+  parser.capacity = EXPRESSION_INITIAL_CAPACITY;
+  parser.table_size = 2 * EXPRESSION_INITIAL_CAPACITY;
+  parser.table = calloc(parser.table_size, sizeof(unsigned long));
+  if(!parser.table) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long) * parser.table_size);
+    exit(EXIT_FAILURE);
+  }
+
+  PolynomialExpression *expression = expression_allocate(NULL, sizeof(PolynomialExpression));
+  expression->nodes = expression_allocate(NULL, sizeof(ExpressionNode) * parser.capacity);
+  expression->length = 0;
+  parser.expression = expression;
+
+  expression->root = parse_sum(&parser);
+
+  parser_skip_spaces(&parser);
+  if(*parser.current != '\0') {
+    parser.failed = 1;
+  }
+
+  free(parser.table);
+
+  if(parser.failed) {
+    polynomial_expression_free(&expression);
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  return expression;
+}
+
+
+Polynomial* polynomial_expression_expand(const PolynomialExpression *expression) {
+  assert(expression != NULL);
+
+  Polynomial **polynomials = expression_allocate(NULL, sizeof(Polynomial*) * expression->length);
+  unsigned long *uses = calloc(expression->length, sizeof(unsigned long));
+  if(!uses) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(unsigned long) * expression->length);
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned long index;
+  for(index = 0; index < expression->length; index++) {
+    polynomials[index] = NULL;
+
+    const ExpressionNode *node = &expression->nodes[index];
+    switch(node->operation) {
+      case EXPRESSION_SUM:
+      case EXPRESSION_DIFFERENCE:
+      case EXPRESSION_PRODUCT:
+        uses[node->right]++;
+        uses[node->left]++;
+        break;
+
+      case EXPRESSION_NEGATION:
+      case EXPRESSION_POWER:
+        uses[node->left]++;
+        break;
+
+      default:
+        break;
+    }
+  }
+  uses[expression->root]++; // the result itself
+
+  for(index = 0; index < expression->length; index++) {
+    const ExpressionNode *node = &expression->nodes[index];
+    Polynomial *left = polynomials[node->left], *right = polynomials[node->right];
+    Polynomial *result = NULL;
+
+    switch(node->operation) {
+      case EXPRESSION_NUMBER:
+        result = polynomial_create(&node->number, 0);
+        break;
+
+      case EXPRESSION_VARIABLE: {
+        double coefficients[] = { 0, 1 };
+        result = polynomial_create(coefficients, 1);
+        break;
+      }
+
+      case EXPRESSION_SUM:
+        result = polynomial_sum(left, right);
+        break;
+
+      case EXPRESSION_DIFFERENCE:
+        result = polynomial_copy(left);
+        polynomial_axpy(result, -1, right);
+        break;
+
+      case EXPRESSION_PRODUCT:
+        result = polynomial_product(left, right);
+        break;
+
+      case EXPRESSION_NEGATION:
+        result = polynomial_copy(left);
+        polynomial_scale(result, -1);
+        break;
+
+      case EXPRESSION_POWER:
+        result = polynomial_power(left, (int) node->exponent);
+        break;
+    }
+    polynomials[index] = result;
+
+    switch(node->operation) {
+      case EXPRESSION_SUM:
+      case EXPRESSION_DIFFERENCE:
+      case EXPRESSION_PRODUCT:
+        expression_release(polynomials, uses, node->right);
+        expression_release(polynomials, uses, node->left);
+        break;
+
+      case EXPRESSION_NEGATION:
+      case EXPRESSION_POWER:
+        expression_release(polynomials, uses, node->left);
+        break;
+
+      default:
+        break;
+    }
+
+    // numbers folded into another one are never used
+    if(uses[index] == 0) {
+      polynomial_free(&polynomials[index]);
+    }
+  }
+
+  Polynomial *result = polynomials[expression->root];
+
+  free(uses);
+  free(polynomials);
+
+  return result;
+}
+
+
+void polynomial_expression_free(PolynomialExpression **expression) {
+  assert(expression != NULL);
+  assert(*expression != NULL);
+
+  free((*expression)->nodes);
+  free(*expression);
+  *expression = NULL;
+}
+
+
+unsigned long polynomial_expression_get_number_of_nodes(const PolynomialExpression *expression) {
+  assert(expression != NULL);
+
+  return expression->length;
+}
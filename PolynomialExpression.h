@@ -0,0 +1,89 @@
+#ifndef H_POLYNOMIAL_EXPRESSION
+#define H_POLYNOMIAL_EXPRESSION
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * An expression is a polynomial written in any form, such as "(x+1)^40 * (x-2)^3 + 5(x^2-1)",
+ * kept unexpanded as a directed acyclic graph of operations.
+ *
+ * Identical subexpressions are stored once (hash-consing): in "(x+1)^2 * (x+1)^3", x + 1 is a single node,
+ * computed once per point, and expanded once.
+ * An expression can be computed at points directly, which is much cheaper than expanding it first,
+ * and expanded into a Polynomial on demand.
+ */
+typedef struct PolynomialExpression PolynomialExpression;
+
+
+/*
+ * @function polynomial_expression_compute
+ *
+ * Computes expression with x, without expanding it.
+ */
+extern double polynomial_expression_compute(const PolynomialExpression *expression, double x);
+
+
+/*
+ * @function polynomial_expression_compute_points
+ *
+ * Computes expression with every point, for a block of points at a time.
+ *
+ * @param double *values
+ * Its length must be at least number_of_points. values[i] is set to the value of expression at points[i].
+ */
+extern void polynomial_expression_compute_points(const PolynomialExpression *expression, const double *points, unsigned long number_of_points, double *values);
+
+
+/*
+ * @function polynomial_expression_create_from_string
+ *
+ * Parses an expression made of numbers, x, parentheses, +, -, * and ^.
+ * Multiplication may be implicit, as in "2x" or "5(x^2-1)".
+ * Exponents must be natural numbers, written after ^ without any sign.
+ *
+ * @return PolynomialExpression*
+ * The expression, which must be freed with polynomial_expression_free after use,
+ * or NULL if string is malformed. polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern PolynomialExpression* polynomial_expression_create_from_string(const char *string);
+
+
+/*
+ * @function polynomial_expression_expand
+ *
+ * Expands every node of expression once, with polynomial_power and polynomial_product,
+ * freeing the intermediate polynomials as soon as they are not needed anymore.
+ *
+ * @return Polynomial*
+ * The expanded expression. Must be freed with polynomial_free after use.
+ */
+extern Polynomial* polynomial_expression_expand(const PolynomialExpression *expression);
+
+
+/*
+ * @function polynomial_expression_free
+ *
+ * Frees associated resources and sets *expression to NULL to prevent further use.
+ */
+extern void polynomial_expression_free(PolynomialExpression **expression);
+
+
+/*
+ * @function polynomial_expression_get_number_of_nodes
+ *
+ * @return unsigned long
+ * The number of distinct operations, numbers and variables of expression.
+ */
+extern unsigned long polynomial_expression_get_number_of_nodes(const PolynomialExpression *expression);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,423 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "Coefficients.h"
+#include "PolynomialFile.h"
+
+#define FILE_MAGIC "PLYCOEF1"
+#define FILE_HEADER_SIZE (sizeof(FILE_MAGIC) - 1 + sizeof(unsigned long long))
+
+/*
+ * checkpoint: this magic, then its parameters, the degrees and the fingerprints of the operands,
+ * the block size and the next block of result, then the carry
+ */
+#define CHECKPOINT_MAGIC "PLYCKPT2"
+#define CHECKPOINT_PARAMETERS 6
+#define CHECKPOINT_NEXT 5 // index of the next block of result in the parameters
+#define CHECKPOINT_FINGERPRINT_POINT 0x1d8e4e27c47d124fULL
+#define CHECKPOINT_SUFFIX ".checkpoint"
+#define CHECKPOINT_TEMPORARY_SUFFIX ".checkpoint.tmp"
+
+
+static void* file_allocate(size_t size) {
+  void *memory = malloc(size);
+  if(!memory) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return memory;
+}
+
+
+/*
+ * @function file_size_at_least
+ *
+ * @return int
+ * 1 if file holds at least size bytes, 0 otherwise or if its size can't be told.
+ * The position in file is kept.
+ */
+static int file_size_at_least(FILE *file, unsigned long long size) {
+  int saved_errno = errno;
+  int large_enough = 0;
+  off_t position = ftello(file);
+  if(position >= 0 && fseeko(file, 0, SEEK_END) == 0) {
+    off_t end = ftello(file);
+    large_enough = fseeko(file, position, SEEK_SET) == 0 && end >= 0 && (unsigned long long) end >= size;
+  }
+  errno = saved_errno;
+
+  return large_enough;
+}
+
+
+/*
+ * @function file_read_header
+ *
+ * Reads the header of a coefficient file, and checks its degree before anything is allocated for it:
+ * the size of the coefficients must not overflow, and they must all be in the file.
+ */
+static int file_read_header(FILE *file, unsigned long long *degree) {
+  char magic[sizeof(FILE_MAGIC) - 1];
+
+  return fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+    && memcmp(magic, FILE_MAGIC, sizeof(magic)) == 0
+    && fread(degree, sizeof(unsigned long long), 1, file) == 1
+    && *degree < (ULLONG_MAX - FILE_HEADER_SIZE) / sizeof(double)
+    && file_size_at_least(file, FILE_HEADER_SIZE + (*degree + 1) * sizeof(double));
+}
+
+
+static int file_write_header(FILE *file, unsigned long long degree) {
+  return fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC) - 1, file) == sizeof(FILE_MAGIC) - 1
+    && fwrite(&degree, sizeof(unsigned long long), 1, file) == 1;
+}
+
+
+// reads count coefficients, from degree first
+static int file_read_block(FILE *file, unsigned long long first, unsigned long long count, double *block) {
+  return fseeko(file, (off_t) (FILE_HEADER_SIZE + first * sizeof(double)), SEEK_SET) == 0
+    && fread(block, sizeof(double), count, file) == count;
+}
+
+
+// fingerprint of the bits of the coefficients of a file, read by blocks from the last one into buffer
+static int file_fingerprint(FILE *file, unsigned long long degree, unsigned long long block, double *buffer, unsigned long long *fingerprint) {
+  unsigned long long value = 0, end = degree + 1;
+  while(end > 0) {
+    unsigned long long count = (end < block) ? end : block;
+    if(!file_read_block(file, end - count, count, buffer)) {
+      return 0;
+    }
+
+    value = coefficients_fingerprint_bits(buffer, (long) count - 1, CHECKPOINT_FINGERPRINT_POINT, value);
+    end -= count;
+  }
+
+  *fingerprint = value;
+  return 1;
+}
+
+
+static char* file_checkpoint_name(const char *result_filename, const char *suffix) {
+  size_t length = strlen(result_filename);
+  char *name = file_allocate(length + strlen(suffix) + 1);
+
+  memcpy(name, result_filename, length);
+  strcpy(name + length, suffix);
+
+  return name;
+}
+
+
+/*
+ * @function file_checkpoint_load
+ *
+ * @param unsigned long long *parameters
+ * The degrees and the fingerprints of the operands and the block size, which the checkpoint must match,
+ * followed by the next block of result, set from the checkpoint.
+ *
+ * @return int
+ * 1 if the checkpoint exists and matches, carry is then set. 0 otherwise.
+ */
+static int file_checkpoint_load(const char *name, unsigned long long *parameters, double *carry, unsigned long long carry_length) {
+  FILE *checkpoint = fopen(name, "rb");
+  if(!checkpoint) {
+    return 0;
+  }
+
+  char magic[sizeof(CHECKPOINT_MAGIC) - 1];
+  unsigned long long saved[CHECKPOINT_PARAMETERS];
+  int loaded = fread(magic, 1, sizeof(magic), checkpoint) == sizeof(magic)
+    && memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) == 0
+    && fread(saved, sizeof(unsigned long long), CHECKPOINT_PARAMETERS, checkpoint) == CHECKPOINT_PARAMETERS
+    && memcmp(saved, parameters, sizeof(unsigned long long) * CHECKPOINT_NEXT) == 0
+    && fread(carry, sizeof(double), carry_length, checkpoint) == carry_length;
+
+  fclose(checkpoint);
+
+  if(loaded) {
+    parameters[CHECKPOINT_NEXT] = saved[CHECKPOINT_NEXT];
+  }
+
+  return loaded;
+}
+
+
+// written to a temporary file first, then renamed: a crash leaves either the previous checkpoint or the new one
+static int file_checkpoint_save(const char *name, const char *temporary, const unsigned long long *parameters, const double *carry, unsigned long long carry_length) {
+  FILE *checkpoint = fopen(temporary, "wb");
+  if(!checkpoint) {
+    return 0;
+  }
+
+  int saved = fwrite(CHECKPOINT_MAGIC, 1, sizeof(CHECKPOINT_MAGIC) - 1, checkpoint) == sizeof(CHECKPOINT_MAGIC) - 1
+    && fwrite(parameters, sizeof(unsigned long long), CHECKPOINT_PARAMETERS, checkpoint) == CHECKPOINT_PARAMETERS
+    && fwrite(carry, sizeof(double), carry_length, checkpoint) == carry_length;
+
+  if(fclose(checkpoint) != 0) {
+    saved = 0;
+  }
+
+  return saved && rename(temporary, name) == 0;
+}
+
+
+/*
+ * @function file_result_resume
+ *
+ * @return FILE*
+ * The result file of a checkpoint, positioned after its first written blocks,
+ * NULL if it doesn't hold them all, with a header of the expected degree.
+ */
+static FILE* file_result_resume(const char *filename, unsigned long long degree, unsigned long long written) {
+  FILE *result = fopen(filename, "r+b");
+  if(!result) {
+    return NULL;
+  }
+
+  char magic[sizeof(FILE_MAGIC) - 1];
+  unsigned long long saved_degree;
+  if(fread(magic, 1, sizeof(magic), result) != sizeof(magic)
+    || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0
+    || fread(&saved_degree, sizeof(unsigned long long), 1, result) != 1
+    || saved_degree != degree
+    || !file_size_at_least(result, FILE_HEADER_SIZE + written * sizeof(double))
+    || fseeko(result, (off_t) (FILE_HEADER_SIZE + written * sizeof(double)), SEEK_SET) != 0) {
+    fclose(result);
+    return NULL;
+  }
+
+  return result;
+}
+
+
+// number of pairs of blocks whose product starts in block diagonal of the result
+static unsigned long long file_diagonal_length(unsigned long long diagonal, unsigned long long left_blocks, unsigned long long right_blocks) {
+  unsigned long long first = (diagonal < right_blocks) ? 0 : diagonal - right_blocks + 1;
+  unsigned long long last = (diagonal < left_blocks) ? diagonal : left_blocks - 1;
+
+  return last - first + 1;
+}
+
+
+int polynomial_file_product(const char *left_filename, const char *right_filename, const char *result_filename, const PolynomialFileOptions *options) {
+  assert(left_filename != NULL);
+  assert(right_filename != NULL);
+  assert(result_filename != NULL);
+
+  unsigned long long block = (options != NULL && options->block_size > 0) ? options->block_size : POLYNOMIAL_FILE_BLOCK_SIZE;
+
+  errno = 0;
+  FILE *left = fopen(left_filename, "rb");
+  FILE *right = fopen(right_filename, "rb");
+  unsigned long long left_degree, right_degree;
+  if(!left || !right || !file_read_header(left, &left_degree) || !file_read_header(right, &right_degree)) {
+    if(left) {
+      fclose(left);
+    }
+    if(right) {
+      fclose(right);
+    }
+
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return 0;
+  }
+
+  /*
+   * Block k of the result, coefficients k * block to (k + 1) * block - 1, only receives
+   * the products of left block i by right block j with i + j = k (its diagonal) or i + j = k - 1.
+   * Diagonals are computed in order into an accumulator of two blocks:
+   * its first block is then final and written, its second one is carried to the next diagonal.
+   */
+  unsigned long long left_blocks = left_degree / block + 1, right_blocks = right_degree / block + 1;
+  unsigned long long diagonals = left_blocks + right_blocks - 1;
+  unsigned long long length = left_degree + right_degree + 1;
+
+  double *left_block = file_allocate(sizeof(double) * block);
+  double *right_block = file_allocate(sizeof(double) * block);
+  double *product = file_allocate(sizeof(double) * (2 * block - 1));
+  double *accumulator = calloc(2 * block - 1, sizeof(double));
+  if(!accumulator) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", (size_t) (sizeof(double) * (2 * block - 1)));
+    exit(EXIT_FAILURE);
+  }
+
+  char *checkpoint = file_checkpoint_name(result_filename, CHECKPOINT_SUFFIX);
+  char *temporary = file_checkpoint_name(result_filename, CHECKPOINT_TEMPORARY_SUFFIX);
+
+  // a checkpoint only resumes the product of the same operands: same degrees and same coefficients
+  FILE *result = NULL;
+  unsigned long long parameters[CHECKPOINT_PARAMETERS] = { left_degree, right_degree, 0, 0, block, 0 };
+  int status = 1;
+  if(!file_fingerprint(left, left_degree, block, left_block, &parameters[2])
+    || !file_fingerprint(right, right_degree, block, right_block, &parameters[3])) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    status = 0;
+  } else if(file_checkpoint_load(checkpoint, parameters, accumulator, block - 1)) {
+    result = file_result_resume(result_filename, length - 1, parameters[CHECKPOINT_NEXT] * block);
+  }
+
+  if(status == 1 && !result) {
+    // no usable checkpoint: start over
+    parameters[CHECKPOINT_NEXT] = 0;
+    memset(accumulator, 0, sizeof(double) * (block - 1));
+
+    result = fopen(result_filename, "wb");
+    if(!result || !file_write_header(result, length - 1)) {
+      polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+      status = 0;
+    }
+  }
+
+  unsigned long long done = 0, total = left_blocks * right_blocks;
+  unsigned long long diagonal;
+  for(diagonal = 0; diagonal < parameters[CHECKPOINT_NEXT]; diagonal++) {
+    done += file_diagonal_length(diagonal, left_blocks, right_blocks);
+  }
+
+  for(diagonal = parameters[CHECKPOINT_NEXT]; status == 1 && diagonal < diagonals; diagonal++) {
+    // the carry of the previous diagonal is in the first block - 1 coefficients
+    memset(accumulator + block - 1, 0, sizeof(double) * block);
+
+    unsigned long long first = (diagonal < right_blocks) ? 0 : diagonal - right_blocks + 1;
+    unsigned long long last = (diagonal < left_blocks) ? diagonal : left_blocks - 1;
+    unsigned long long index;
+    for(index = first; index <= last; index++) {
+      unsigned long long left_start = index * block, right_start = (diagonal - index) * block;
+      unsigned long long left_length = (left_degree + 1 - left_start < block) ? left_degree + 1 - left_start : block;
+      unsigned long long right_length = (right_degree + 1 - right_start < block) ? right_degree + 1 - right_start : block;
+
+      if(!file_read_block(left, left_start, left_length, left_block) || !file_read_block(right, right_start, right_length, right_block)) {
+        polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+        status = 0;
+        break;
+      }
+
+      coefficients_product(left_block, left_length - 1, right_block, right_length - 1, product);
+      coefficients_add(accumulator, product, left_length + right_length - 2);
+    }
+
+    if(status == 0) {
+      break;
+    }
+
+    // the last diagonal writes its carry too
+    unsigned long long count = (diagonal + 1 == diagonals) ? length - diagonal * block : block;
+    if(fwrite(accumulator, sizeof(double), count, result) != count || fflush(result) != 0) {
+      polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+      status = 0;
+      break;
+    }
+
+    memmove(accumulator, accumulator + block, sizeof(double) * (block - 1));
+    done += last - first + 1;
+
+    if(diagonal + 1 < diagonals) {
+      parameters[CHECKPOINT_NEXT] = diagonal + 1;
+      if(!file_checkpoint_save(checkpoint, temporary, parameters, accumulator, block - 1)) {
+        polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+        status = 0;
+        break;
+      }
+    }
+
+    if(options != NULL && options->progress != NULL && !options->progress(done, total, options->data) && diagonal + 1 < diagonals) {
+      // interrupted: the checkpoint is kept, polynomials_errno is unchanged
+      status = -1;
+    }
+  }
+
+  if(result && fclose(result) != 0 && status == 1) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    status = 0;
+  }
+
+  if(status == 1) {
+    remove(checkpoint);
+  }
+
+  fclose(left);
+  fclose(right);
+  free(left_block);
+  free(right_block);
+  free(product);
+  free(accumulator);
+  free(checkpoint);
+  free(temporary);
+
+  return status == 1;
+}
+
+
+Polynomial* polynomial_file_read(const char *filename) {
+  assert(filename != NULL);
+
+  errno = 0;
+  FILE *file = fopen(filename, "rb");
+  unsigned long long degree;
+  if(!file || !file_read_header(file, &degree)) {
+    if(file) {
+      fclose(file);
+    }
+
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  // the C polynomials take their degree as an unsigned int
+  if(degree > UINT_MAX) {
+    fclose(file);
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  double *coefficients = file_allocate(sizeof(double) * (degree + 1));
+  Polynomial *polynomial = NULL;
+  if(fread(coefficients, sizeof(double), degree + 1, file) == degree + 1) {
+    polynomial = polynomial_create(coefficients, (unsigned int) degree);
+  } else {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+  }
+
+  free(coefficients);
+  fclose(file);
+
+  return polynomial;
+}
+
+
+int polynomial_file_write(const Polynomial *polynomial, const char *filename) {
+  assert(polynomial != NULL);
+  assert(filename != NULL);
+
+  long degree = polynomial_get_degree(polynomial);
+  double *coefficients = file_allocate(sizeof(double) * (degree + 1));
+  polynomial_get_coefficients(polynomial, coefficients);
+
+  errno = 0;
+  FILE *file = fopen(filename, "wb");
+  int success = file != NULL
+    && file_write_header(file, degree)
+    && fwrite(coefficients, sizeof(double), degree + 1, file) == (size_t) degree + 1;
+
+  if(file && fclose(file) != 0) {
+    success = 0;
+  }
+
+  free(coefficients);
+
+  if(!success) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+  }
+
+  return success;
+}
@@ -0,0 +1,88 @@
+#ifndef H_POLYNOMIAL_FILE
+#define H_POLYNOMIAL_FILE
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Dense polynomials stored in files, for products too big to be held in memory.
+ *
+ * A coefficient file holds the magic "PLYCOEF1", the degree n as a 64-bit integer,
+ * then the n + 1 coefficients as doubles, sorted in ascending order, all in the host's byte order.
+ * Any program can write one coefficient at a time, so operands don't have to fit in memory either.
+ */
+
+// default number of coefficients per block, 8 MB
+#define POLYNOMIAL_FILE_BLOCK_SIZE (1UL << 20)
+
+
+typedef struct {
+  unsigned long block_size; // number of coefficients per block, 0 uses POLYNOMIAL_FILE_BLOCK_SIZE
+
+  /*
+   * Called after each group of block products, if it is not NULL,
+   * with the number of products of a left block by a right block done so far and their total number.
+   * Returning 0 interrupts the product, which can be resumed later.
+   */
+  int (*progress)(unsigned long long done, unsigned long long total, void *data);
+  void *data; // passed to progress
+} PolynomialFileOptions;
+
+
+/*
+ * @function polynomial_file_product
+ *
+ * Multiplies the polynomials of two coefficient files into a third one, with bounded memory.
+ *
+ * Operands are split into blocks of block_size coefficients, and the products of pairs of blocks,
+ * computed by coefficients_product (through a FFT for big blocks), are accumulated into the result
+ * one block of result at a time, in order: each block of the result is written once, sequentially.
+ * Memory use is proportional to block_size, whatever the degrees of the operands.
+ *
+ * After each block of the result, its state is saved to result_filename followed by ".checkpoint",
+ * with the degrees of the operands and a fingerprint of their coefficients.
+ * If such a checkpoint is found for the same operands and block size, and the result file holds the blocks it counts,
+ * the product resumes from it, after an interruption by progress or a crash. Otherwise it starts over.
+ * The checkpoint is removed once the product is complete.
+ *
+ * @param const PolynomialFileOptions *options
+ * NULL uses the defaults.
+ *
+ * @return int
+ * 1 when the product is complete, 0 if progress interrupted it, or on failure:
+ * polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR if an operand is not a coefficient file or is truncated,
+ * or to POLYNOMIAL_OUTPUT_ERROR if the result couldn't be written.
+ */
+extern int polynomial_file_product(const char *left_filename, const char *right_filename, const char *result_filename, const PolynomialFileOptions *options);
+
+
+/*
+ * @function polynomial_file_read
+ *
+ * @return Polynomial*
+ * The polynomial of a coefficient file, which must fit in memory. Must be freed with polynomial_free after use.
+ * NULL if the file couldn't be read, is truncated, or its degree doesn't fit in an unsigned int:
+ * polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern Polynomial* polynomial_file_read(const char *filename);
+
+
+/*
+ * @function polynomial_file_write
+ *
+ * Writes polynomial to a coefficient file.
+ *
+ * @return int
+ * 1 on success, 0 on failure, polynomials_errno is then set to POLYNOMIAL_OUTPUT_ERROR.
+ */
+extern int polynomial_file_write(const Polynomial *polynomial, const char *filename);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef HPP_POLYNOMIAL_FIXED
+#define HPP_POLYNOMIAL_FIXED
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include "Polynomial.hpp"
+
+/*
+ * Polynomials whose degree is known at compile time, such as splines and approximations.
+ *
+ * polynomials::FixedPolynomial<Degree> holds its Degree + 1 coefficients in a std::array, in ascending order,
+ * and its evaluation is unrolled by the compiler: there is no loop, and no list to follow.
+ * When the polynomial is constexpr, its coefficients are folded into the code as constants.
+ * Evaluation and derivative are constexpr too, so they can be computed at compile time:
+ *
+ *   constexpr polynomials::FixedPolynomial p(1., -2., 0.5); // 1 - 2x + 0.5x^2, Degree is deduced
+ *   static_assert(p(2.) == -1.);
+ *   static_assert(p.derivative()(2.) == 0.);
+ */
+
+// number of points computed together by FixedPolynomial::evaluate, the width of a SSE2 register
+#define FIXED_BATCH_WIDTH 2
+
+namespace polynomials {
+
+typedef double FixedPointsVector __attribute__((vector_size(FIXED_BATCH_WIDTH * sizeof(double))));
+
+
+template<std::size_t Degree>
+class FixedPolynomial {
+ public:
+  static constexpr std::size_t degree = Degree;
+
+  constexpr FixedPolynomial() : coefficients_{} {}
+
+  constexpr explicit FixedPolynomial(const std::array<double, Degree + 1> &coefficients) : coefficients_(coefficients) {}
+
+  template<class... Coefficients>
+  constexpr FixedPolynomial(double first, Coefficients... others) : coefficients_{ first, static_cast<double>(others)... } {
+    static_assert(sizeof...(Coefficients) == Degree, "a FixedPolynomial<Degree> has Degree + 1 coefficients");
+  }
+
+  constexpr double operator[](std::size_t index) const { return coefficients_[index]; }
+
+  // Horner's method, unrolled: Degree multiplications and additions, each depending on the previous one
+  constexpr double operator()(double x) const {
+    return horner(x, std::make_index_sequence<Degree>());
+  }
+
+  /*
+   * Estrin's scheme: terms are combined in pairs, with x, x^2, x^4...
+   * It does a few more multiplications than Horner's method, but its chain of dependent operations is log2(Degree) long
+   * instead of Degree, so it is faster on processors which run several operations at once.
+   * Rounding errors may differ slightly from those of Horner's method.
+   */
+  constexpr double estrin(double x) const {
+    std::array<double, Degree + 1> terms = coefficients_;
+
+    std::size_t length = Degree + 1;
+    double power = x;
+    while(length > 1) {
+      for(std::size_t index = 0; index < length / 2; index++) {
+        terms[index] = terms[2 * index] + terms[2 * index + 1] * power;
+      }
+      if(length % 2 == 1) {
+        terms[length / 2] = terms[length - 1];
+      }
+
+      length = (length + 1) / 2;
+      power *= power;
+    }
+
+    return terms[0];
+  }
+
+  constexpr FixedPolynomial<(Degree > 0) ? Degree - 1 : 0> derivative() const {
+    FixedPolynomial<(Degree > 0) ? Degree - 1 : 0> result;
+    for(std::size_t index = 1; index <= Degree; index++) {
+      result.coefficients_[index - 1] = index * coefficients_[index];
+    }
+    return result;
+  }
+
+  /*
+   * Computes the polynomial at count points, FIXED_BATCH_WIDTH at a time.
+   * points and values may be the same array.
+   */
+  void evaluate(const double *points, double *values, std::size_t count) const {
+    std::size_t index = 0;
+    for(; index + FIXED_BATCH_WIDTH <= count; index += FIXED_BATCH_WIDTH) {
+      FixedPointsVector x;
+      std::memcpy(&x, points + index, sizeof(x));
+
+      FixedPointsVector value = horner_vector(x, std::make_index_sequence<Degree>());
+      std::memcpy(values + index, &value, sizeof(value));
+    }
+
+    for(; index < count; index++) {
+      values[index] = (*this)(points[index]);
+    }
+  }
+
+  // the same polynomial, for the operations of polynomials::Polynomial, which drop coefficients closer to 0 than 0.0001
+  Polynomial to_polynomial() const {
+    return Polynomial(polynomial_create(coefficients_.data(), Degree));
+  }
+
+ private:
+  template<std::size_t> friend class FixedPolynomial;
+
+  template<std::size_t... Index>
+  constexpr double horner(double x, std::index_sequence<Index...>) const {
+    double value = coefficients_[Degree];
+    ((value = value * x + coefficients_[Degree - 1 - Index]), ...);
+    return value;
+  }
+
+  template<std::size_t... Index>
+  FixedPointsVector horner_vector(FixedPointsVector x, std::index_sequence<Index...>) const {
+    FixedPointsVector value = FixedPointsVector{} + coefficients_[Degree];
+    ((value = value * x + coefficients_[Degree - 1 - Index]), ...);
+    return value;
+  }
+
+  std::array<double, Degree + 1> coefficients_;
+};
+
+
+template<class... Coefficients>
+FixedPolynomial(double, Coefficients...) -> FixedPolynomial<sizeof...(Coefficients)>;
+
+}
+
+#endif
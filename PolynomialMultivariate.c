@@ -0,0 +1,666 @@
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PolynomialMultivariate.h"
+
+#define MULTIVARIATE_EXPONENT_BITS 7
+#define MULTIVARIATE_EXPONENT_MASK 0x7fULL
+#define MULTIVARIATE_DEGREE_SHIFT 56
+
+#define MULTIVARIATE_MAX_NUMBER_LENGTH 64
+
+// number of points computed together by polynomial_multivariate_compute_points, the width of a SSE2 register
+#define MULTIVARIATE_BATCH_WIDTH 2
+
+typedef double MultivariateVector __attribute__((vector_size(MULTIVARIATE_BATCH_WIDTH * sizeof(double))));
+
+static const char multivariate_names[MULTIVARIATE_MAX_VARIABLES] = { 'x', 'y', 'z', 'w', 'v', 'u', 't', 's' };
+
+typedef struct {
+  unsigned long long exponents; // packed, see PolynomialMultivariate.h
+  double coefficient;
+} MultivariateTerm;
+
+struct PolynomialMultivariate {
+  MultivariateTerm *terms;
+  unsigned long length;
+  int variables;
+};
+
+typedef struct {
+  unsigned long long exponents; // of the product of left[index_left] and right[index_right]
+  unsigned long index_left;
+  unsigned long index_right;
+} MultivariateHeapEntry;
+
+
+static void* multivariate_allocate(void *pointer, size_t size) {
+  void *allocated = realloc(pointer, size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+static inline int multivariate_is_null(double coefficient) {
+  return (coefficient > -POLYNOMIAL_NULL_TOLERANCE && coefficient < POLYNOMIAL_NULL_TOLERANCE);
+}
+
+
+static inline int multivariate_shift(int variable) {
+  return (MULTIVARIATE_MAX_VARIABLES - 1 - variable) * MULTIVARIATE_EXPONENT_BITS;
+}
+
+
+static inline unsigned int multivariate_exponent(unsigned long long exponents, int variable) {
+  return (unsigned int) ((exponents >> multivariate_shift(variable)) & MULTIVARIATE_EXPONENT_MASK);
+}
+
+
+static inline unsigned int multivariate_degree(unsigned long long exponents) {
+  return (unsigned int) (exponents >> MULTIVARIATE_DEGREE_SHIFT);
+}
+
+
+/*
+ * @function multivariate_pack
+ *
+ * @return int
+ * 1 on success, 0 if an exponent or the degree is too big.
+ */
+static int multivariate_pack(const unsigned int *exponents, int variables, unsigned long long *packed) {
+  unsigned long long word = 0, degree = 0;
+
+  int variable;
+  for(variable = 0; variable < variables; variable++) {
+    if(exponents[variable] > MULTIVARIATE_MAX_EXPONENT) {
+      return 0;
+    }
+
+    word |= (unsigned long long) exponents[variable] << multivariate_shift(variable);
+    degree += exponents[variable];
+  }
+
+  if(degree > MULTIVARIATE_MAX_DEGREE) {
+    return 0;
+  }
+
+  *packed = word | (degree << MULTIVARIATE_DEGREE_SHIFT);
+  return 1;
+}
+
+
+static PolynomialMultivariate* multivariate_create_empty(int variables, unsigned long capacity) {
+  PolynomialMultivariate *multivariate = multivariate_allocate(NULL, sizeof(PolynomialMultivariate));
+  multivariate->terms = multivariate_allocate(NULL, sizeof(MultivariateTerm) * (capacity > 0 ? capacity : 1));
+  multivariate->length = 0;
+  multivariate->variables = variables;
+
+  return multivariate;
+}
+
+
+// appends a term, in ascending order, merging it with the last one if they have the same exponents
+static inline void multivariate_append(PolynomialMultivariate *multivariate, unsigned long long exponents, double coefficient) {
+  if(multivariate->length > 0 && multivariate->terms[multivariate->length - 1].exponents == exponents) {
+    multivariate->terms[multivariate->length - 1].coefficient += coefficient;
+    return;
+  }
+
+  if(multivariate->length > 0 && multivariate_is_null(multivariate->terms[multivariate->length - 1].coefficient)) {
+    multivariate->length--;
+  }
+
+  multivariate->terms[multivariate->length].exponents = exponents;
+  multivariate->terms[multivariate->length].coefficient = coefficient;
+  multivariate->length++;
+}
+
+
+static inline void multivariate_finish(PolynomialMultivariate *multivariate) {
+  if(multivariate->length > 0 && multivariate_is_null(multivariate->terms[multivariate->length - 1].coefficient)) {
+    multivariate->length--;
+  }
+}
+
+
+static int multivariate_compare_terms(const void *left, const void *right) {
+  unsigned long long left_exponents = ((const MultivariateTerm*) left)->exponents;
+  unsigned long long right_exponents = ((const MultivariateTerm*) right)->exponents;
+
+  return (left_exponents > right_exponents) - (left_exponents < right_exponents);
+}
+
+
+// sorts terms, and appends them to a new polynomial, which takes ownership of nothing
+static PolynomialMultivariate* multivariate_create_from_terms(MultivariateTerm *terms, unsigned long length, int variables) {
+  qsort(terms, length, sizeof(MultivariateTerm), multivariate_compare_terms);
+
+  PolynomialMultivariate *multivariate = multivariate_create_empty(variables, length);
+
+  unsigned long index;
+  for(index = 0; index < length; index++) {
+    multivariate_append(multivariate, terms[index].exponents, terms[index].coefficient);
+  }
+  multivariate_finish(multivariate);
+
+  return multivariate;
+}
+
+
+double polynomial_multivariate_compute(const PolynomialMultivariate *multivariate, const double *point) {
+  assert(multivariate != NULL);
+  assert(point != NULL);
+
+  double value;
+  polynomial_multivariate_compute_points(multivariate, point, 1, &value);
+
+  return value;
+}
+
+
+/*
+ * The powers of every variable are computed once per point, up to the highest exponent of the variable,
+ * then each term only costs one multiplication per variable.
+ * Points are computed MULTIVARIATE_BATCH_WIDTH at a time, the last ones being padded with zeros.
+ */
+void polynomial_multivariate_compute_points(const PolynomialMultivariate *multivariate, const double *points, unsigned long number_of_points, double *values) {
+  assert(multivariate != NULL);
+  assert(points != NULL);
+  assert(values != NULL);
+
+  int variables = multivariate->variables, variable;
+
+  unsigned int highest[MULTIVARIATE_MAX_VARIABLES] = { 0 };
+  unsigned long index;
+  for(index = 0; index < multivariate->length; index++) {
+    for(variable = 0; variable < variables; variable++) {
+      unsigned int exponent = multivariate_exponent(multivariate->terms[index].exponents, variable);
+      highest[variable] = (exponent > highest[variable]) ? exponent : highest[variable];
+    }
+  }
+
+  // powers[variable * (MULTIVARIATE_MAX_EXPONENT + 1) + exponent]
+  MultivariateVector *powers = multivariate_allocate(NULL, sizeof(MultivariateVector) * variables * (MULTIVARIATE_MAX_EXPONENT + 1));
+
+  unsigned long point;
+  for(point = 0; point < number_of_points; point += MULTIVARIATE_BATCH_WIDTH) {
+    for(variable = 0; variable < variables; variable++) {
+      MultivariateVector x = { 0 };
+
+      unsigned long lane;
+      for(lane = 0; lane < MULTIVARIATE_BATCH_WIDTH && point + lane < number_of_points; lane++) {
+        x[lane] = points[(point + lane) * variables + variable];
+      }
+
+      MultivariateVector *variable_powers = powers + variable * (MULTIVARIATE_MAX_EXPONENT + 1);
+      variable_powers[0] = (MultivariateVector) { 0 } + 1;
+
+      unsigned int exponent;
+      for(exponent = 1; exponent <= highest[variable]; exponent++) {
+        variable_powers[exponent] = variable_powers[exponent - 1] * x;
+      }
+    }
+
+    MultivariateVector value = { 0 };
+    for(index = 0; index < multivariate->length; index++) {
+      unsigned long long exponents = multivariate->terms[index].exponents;
+      MultivariateVector term = (MultivariateVector) { 0 } + multivariate->terms[index].coefficient;
+
+      for(variable = 0; variable < variables; variable++) {
+        term *= powers[variable * (MULTIVARIATE_MAX_EXPONENT + 1) + multivariate_exponent(exponents, variable)];
+      }
+
+      value += term;
+    }
+
+    unsigned long lane;
+    for(lane = 0; lane < MULTIVARIATE_BATCH_WIDTH && point + lane < number_of_points; lane++) {
+      values[point + lane] = value[lane];
+    }
+  }
+
+  free(powers);
+}
+
+
+PolynomialMultivariate* polynomial_multivariate_create(int variables, const unsigned int *exponents, const double *coefficients, unsigned long number_of_terms) {
+  assert(exponents != NULL || number_of_terms == 0);
+  assert(coefficients != NULL || number_of_terms == 0);
+
+  if(variables < 1 || variables > MULTIVARIATE_MAX_VARIABLES) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  MultivariateTerm *terms = multivariate_allocate(NULL, sizeof(MultivariateTerm) * (number_of_terms > 0 ? number_of_terms : 1));
+
+  unsigned long index;
+  for(index = 0; index < number_of_terms; index++) {
+    if(!multivariate_pack(exponents + index * variables, variables, &terms[index].exponents)) {
+      free(terms);
+      polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+      return NULL;
+    }
+
+    terms[index].coefficient = coefficients[index];
+  }
+
+  PolynomialMultivariate *multivariate = multivariate_create_from_terms(terms, number_of_terms, variables);
+
+  free(terms);
+
+  return multivariate;
+}
+
+
+/*
+ * @function multivariate_read_term
+ *
+ * Reads a term, in the syntax of monomial_create_from_string:
+ * an optional sign, an optional coefficient, then variables, each optionally followed by ^ and its exponent.
+ * The term must be followed by a space, a sign or the end of the string.
+ *
+ * @return int
+ * 1 on success, 0 if the term is malformed.
+ */
+static int multivariate_read_term(const char **cursor, unsigned int *exponents, double *coefficient, int *variables) {
+  const char *current = *cursor;
+  double sign = 1;
+  int coefficient_read = 0, variable_read = 0;
+
+  if(*current == '+' || *current == '-') {
+    sign = (*current == '-') ? -1 : 1;
+    current++;
+  }
+
+  while(*current == ' ') {
+    current++;
+  }
+
+  *coefficient = 1;
+  if(isdigit((unsigned char) *current)) {
+    // copied first, so that strtod never reads hexadecimal numbers or exponents
+    char number[MULTIVARIATE_MAX_NUMBER_LENGTH];
+    size_t length = 0;
+    while((isdigit((unsigned char) *current) || *current == '.') && length + 1 < MULTIVARIATE_MAX_NUMBER_LENGTH) {
+      number[length++] = *current++;
+    }
+    number[length] = '\0';
+
+    char *number_end;
+    errno = 0;
+    *coefficient = strtod(number, &number_end);
+    if(*number_end != '\0' || errno != 0 || isdigit((unsigned char) *current) || *current == '.') {
+      return 0;
+    }
+
+    coefficient_read = 1;
+  }
+
+  int variable;
+  for(variable = 0; variable < MULTIVARIATE_MAX_VARIABLES; variable++) {
+    exponents[variable] = 0;
+  }
+
+  const char *name;
+  while(*current != '\0' && (name = memchr(multivariate_names, *current, MULTIVARIATE_MAX_VARIABLES)) != NULL) {
+    variable = (int) (name - multivariate_names);
+    current++;
+
+    unsigned long exponent = 1;
+    if(*current == '^') {
+      current++;
+      if(!isdigit((unsigned char) *current)) {
+        // ^ must be followed by a natural number
+        return 0;
+      }
+
+      char *exponent_end;
+      errno = 0;
+      exponent = strtoul(current, &exponent_end, 10);
+      if(errno != 0 || exponent > MULTIVARIATE_MAX_EXPONENT) {
+        return 0;
+      }
+      current = exponent_end;
+    }
+
+    exponents[variable] += (unsigned int) exponent;
+    if(variable + 1 > *variables) {
+      *variables = variable + 1;
+    }
+    variable_read = 1;
+  }
+
+  if(!coefficient_read && !variable_read) {
+    return 0;
+  }
+
+  if(*current != '\0' && *current != ' ' && *current != '+' && *current != '-') {
+    return 0;
+  }
+
+  *coefficient *= sign;
+  *cursor = current;
+  return 1;
+}
+
+
+PolynomialMultivariate* polynomial_multivariate_create_from_string(const char *string) {
+  assert(string != NULL);
+
+  unsigned long length = 0, capacity = 16;
+  MultivariateTerm *terms = multivariate_allocate(NULL, sizeof(MultivariateTerm) * capacity);
+  int variables = 1;
+
+  const char *cursor = string;
+  while(*cursor == ' ') {
+    cursor++;
+  }
+
+  while(*cursor != '\0') {
+    unsigned int exponents[MULTIVARIATE_MAX_VARIABLES];
+    double coefficient;
+
+    if(!multivariate_read_term(&cursor, exponents, &coefficient, &variables)) {
+      free(terms);
+      polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+      return NULL;
+    }
+
+    if(length == capacity) {
+      capacity *= 2;
+      terms = multivariate_allocate(terms, sizeof(MultivariateTerm) * capacity);
+    }
+
+    if(!multivariate_pack(exponents, MULTIVARIATE_MAX_VARIABLES, &terms[length].exponents)) {
+      free(terms);
+      polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+      return NULL;
+    }
+    terms[length].coefficient = coefficient;
+    length++;
+
+    while(*cursor == ' ') {
+      cursor++;
+    }
+  }
+
+  if(length == 0) {
+    free(terms);
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return NULL;
+  }
+
+  PolynomialMultivariate *multivariate = multivariate_create_from_terms(terms, length, variables);
+
+  free(terms);
+
+  return multivariate;
+}
+
+
+/*
+ * Dividing every term by the same variable keeps them in the same order,
+ * so the derivative is built in a single pass, without sorting.
+ */
+PolynomialMultivariate* polynomial_multivariate_derivative(const PolynomialMultivariate *multivariate, int variable) {
+  assert(multivariate != NULL);
+  assert(variable >= 0 && variable < MULTIVARIATE_MAX_VARIABLES);
+
+  int variables = (variable + 1 > multivariate->variables) ? variable + 1 : multivariate->variables;
+  PolynomialMultivariate *derivative = multivariate_create_empty(variables, multivariate->length);
+
+  unsigned long long step = (1ULL << multivariate_shift(variable)) + (1ULL << MULTIVARIATE_DEGREE_SHIFT);
+
+  unsigned long index;
+  for(index = 0; index < multivariate->length; index++) {
+    const MultivariateTerm *term = &multivariate->terms[index];
+    unsigned int exponent = multivariate_exponent(term->exponents, variable);
+
+    if(exponent > 0 && !multivariate_is_null(exponent * term->coefficient)) {
+      derivative->terms[derivative->length].exponents = term->exponents - step;
+      derivative->terms[derivative->length].coefficient = exponent * term->coefficient;
+      derivative->length++;
+    }
+  }
+
+  return derivative;
+}
+
+
+void polynomial_multivariate_free(PolynomialMultivariate **multivariate) {
+  assert(multivariate != NULL);
+  assert(*multivariate != NULL);
+
+  free((*multivariate)->terms);
+  free(*multivariate);
+  *multivariate = NULL;
+}
+
+
+long polynomial_multivariate_get_degree(const PolynomialMultivariate *multivariate) {
+  assert(multivariate != NULL);
+
+  if(multivariate->length == 0) {
+    return 0;
+  }
+
+  return multivariate_degree(multivariate->terms[multivariate->length - 1].exponents);
+}
+
+
+unsigned long polynomial_multivariate_get_number_of_terms(const PolynomialMultivariate *multivariate) {
+  assert(multivariate != NULL);
+
+  return multivariate->length;
+}
+
+
+int polynomial_multivariate_get_number_of_variables(const PolynomialMultivariate *multivariate) {
+  assert(multivariate != NULL);
+
+  return multivariate->variables;
+}
+
+
+double polynomial_multivariate_get_term(const PolynomialMultivariate *multivariate, unsigned long index, unsigned int *exponents) {
+  assert(multivariate != NULL);
+  assert(index < multivariate->length);
+  assert(exponents != NULL);
+
+  int variable;
+  for(variable = 0; variable < multivariate->variables; variable++) {
+    exponents[variable] = multivariate_exponent(multivariate->terms[index].exponents, variable);
+  }
+
+  return multivariate->terms[index].coefficient;
+}
+
+
+void polynomial_multivariate_print(const PolynomialMultivariate *multivariate, int newline) {
+  assert(multivariate != NULL);
+
+  printf("(");
+
+  unsigned long index;
+  for(index = 0; index < multivariate->length; index++) {
+    unsigned long long exponents = multivariate->terms[index].exponents;
+    printf("%s(%.2lf, ", (index > 0) ? ", " : "", multivariate->terms[index].coefficient);
+
+    if(multivariate_degree(exponents) == 0) {
+      printf("1");
+    }
+
+    int variable;
+    for(variable = 0; variable < multivariate->variables; variable++) {
+      unsigned int exponent = multivariate_exponent(exponents, variable);
+      if(exponent == 1) {
+        printf("%c", multivariate_names[variable]);
+      } else if(exponent > 1) {
+        printf("%c^%u", multivariate_names[variable], exponent);
+      }
+    }
+
+    printf(")");
+  }
+
+  printf(")");
+
+  if(newline) {
+    printf("\n");
+  }
+}
+
+
+static void multivariate_heap_push(MultivariateHeapEntry *heap, unsigned long *size, MultivariateHeapEntry entry) {
+  unsigned long index = (*size)++;
+  while(index > 0) {
+    unsigned long parent = (index - 1) / 2;
+    if(heap[parent].exponents <= entry.exponents) {
+      break;
+    }
+
+    heap[index] = heap[parent];
+    index = parent;
+  }
+
+  heap[index] = entry;
+}
+
+
+static MultivariateHeapEntry multivariate_heap_pop(MultivariateHeapEntry *heap, unsigned long *size) {
+  MultivariateHeapEntry top = heap[0];
+  MultivariateHeapEntry last = heap[--(*size)];
+
+  unsigned long index = 0;
+  while(2 * index + 1 < *size) {
+    unsigned long child = 2 * index + 1;
+    if(child + 1 < *size && heap[child + 1].exponents < heap[child].exponents) {
+      child++;
+    }
+
+    if(last.exponents <= heap[child].exponents) {
+      break;
+    }
+
+    heap[index] = heap[child];
+    index = child;
+  }
+
+  heap[index] = last;
+
+  return top;
+}
+
+
+PolynomialMultivariate* polynomial_multivariate_product(const PolynomialMultivariate *leftm, const PolynomialMultivariate *rightm) {
+  assert(leftm != NULL);
+  assert(rightm != NULL);
+
+  int variables = (leftm->variables > rightm->variables) ? leftm->variables : rightm->variables;
+
+  if(leftm->length == 0 || rightm->length == 0) {
+    return multivariate_create_empty(variables, 0);
+  }
+
+  // exponents can then be added as whole words, without any carry from a variable to the next one
+  unsigned int left_highest[MULTIVARIATE_MAX_VARIABLES] = { 0 }, right_highest[MULTIVARIATE_MAX_VARIABLES] = { 0 };
+  unsigned long index;
+  int variable;
+  for(index = 0; index < leftm->length; index++) {
+    for(variable = 0; variable < leftm->variables; variable++) {
+      unsigned int exponent = multivariate_exponent(leftm->terms[index].exponents, variable);
+      left_highest[variable] = (exponent > left_highest[variable]) ? exponent : left_highest[variable];
+    }
+  }
+  for(index = 0; index < rightm->length; index++) {
+    for(variable = 0; variable < rightm->variables; variable++) {
+      unsigned int exponent = multivariate_exponent(rightm->terms[index].exponents, variable);
+      right_highest[variable] = (exponent > right_highest[variable]) ? exponent : right_highest[variable];
+    }
+  }
+
+  int overflow = (polynomial_multivariate_get_degree(leftm) + polynomial_multivariate_get_degree(rightm) > MULTIVARIATE_MAX_DEGREE);
+  for(variable = 0; variable < variables; variable++) {
+    overflow = overflow || (left_highest[variable] + right_highest[variable] > MULTIVARIATE_MAX_EXPONENT);
+  }
+  if(overflow) {
+    polynomials_errno = POLYNOMIAL_MATH_ERROR;
+    errno = ERANGE;
+    return NULL;
+  }
+
+  /*
+   * Both polynomials are sorted in ascending order, and a monomial order is compatible with products,
+   * so left[i] * right[j] < left[i] * right[j + 1]: the heap only needs to hold one pair per term of leftm,
+   * and pair (i + 1, 0) is only pushed once (i, 0) has been popped.
+   */
+  const MultivariateTerm *left = leftm->terms, *right = rightm->terms;
+  MultivariateHeapEntry *heap = multivariate_allocate(NULL, sizeof(MultivariateHeapEntry) * leftm->length);
+  PolynomialMultivariate *product = multivariate_create_empty(variables, 16);
+  unsigned long capacity = 16;
+
+  unsigned long heap_size = 0;
+  MultivariateHeapEntry entry = { left[0].exponents + right[0].exponents, 0, 0 };
+  multivariate_heap_push(heap, &heap_size, entry);
+
+  while(heap_size > 0) {
+    entry = multivariate_heap_pop(heap, &heap_size);
+
+    if(product->length == capacity) {
+      capacity *= 2;
+      product->terms = multivariate_allocate(product->terms, sizeof(MultivariateTerm) * capacity);
+    }
+    multivariate_append(product, entry.exponents, left[entry.index_left].coefficient * right[entry.index_right].coefficient);
+
+    if(entry.index_right == 0 && entry.index_left + 1 < leftm->length) {
+      MultivariateHeapEntry below = { left[entry.index_left + 1].exponents + right[0].exponents, entry.index_left + 1, 0 };
+      multivariate_heap_push(heap, &heap_size, below);
+    }
+
+    if(entry.index_right + 1 < rightm->length) {
+      entry.index_right++;
+      entry.exponents = left[entry.index_left].exponents + right[entry.index_right].exponents;
+      multivariate_heap_push(heap, &heap_size, entry);
+    }
+  }
+
+  multivariate_finish(product);
+
+  free(heap);
+
+  return product;
+}
+
+
+PolynomialMultivariate* polynomial_multivariate_sum(const PolynomialMultivariate *leftm, const PolynomialMultivariate *rightm) {
+  assert(leftm != NULL);
+  assert(rightm != NULL);
+
+  int variables = (leftm->variables > rightm->variables) ? leftm->variables : rightm->variables;
+  PolynomialMultivariate *sum = multivariate_create_empty(variables, leftm->length + rightm->length);
+
+  unsigned long index_left = 0, index_right = 0;
+  while(index_left < leftm->length || index_right < rightm->length) {
+    const MultivariateTerm *term;
+    if(index_right == rightm->length || (index_left < leftm->length && leftm->terms[index_left].exponents <= rightm->terms[index_right].exponents)) {
+      term = &leftm->terms[index_left++];
+    } else {
+      term = &rightm->terms[index_right++];
+    }
+
+    multivariate_append(sum, term->exponents, term->coefficient);
+  }
+
+  multivariate_finish(sum);
+
+  return sum;
+}
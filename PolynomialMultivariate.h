@@ -0,0 +1,169 @@
+#ifndef H_POLYNOMIAL_MULTIVARIATE
+#define H_POLYNOMIAL_MULTIVARIATE
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A polynomial in up to 8 variables, named x, y, z, w, v, u, t and s.
+ *
+ * Each term packs its exponents into a single 64-bit word: 7 bits per variable, x highest,
+ * under 8 bits holding the total degree of the term.
+ * Comparing two words is then comparing the terms in the graded lexicographic order
+ * (total degree first, then the exponent of x, of y...), and the word of a product is the sum of the words.
+ * So an exponent is at most 127, and the total degree of a term at most 255.
+ *
+ * Terms are sorted in ascending order, at most one per exponent vector, none null.
+ * Like those of Polynomial, coefficients closer to 0 than POLYNOMIAL_NULL_TOLERANCE are null.
+ */
+typedef struct PolynomialMultivariate PolynomialMultivariate;
+
+#define MULTIVARIATE_MAX_VARIABLES 8
+#define MULTIVARIATE_MAX_EXPONENT 127
+#define MULTIVARIATE_MAX_DEGREE 255
+
+
+/*
+ * @function polynomial_multivariate_compute
+ *
+ * @param const double *point
+ * The value of each variable of multivariate, x first.
+ */
+extern double polynomial_multivariate_compute(const PolynomialMultivariate *multivariate, const double *point);
+
+
+/*
+ * @function polynomial_multivariate_compute_points
+ *
+ * Computes multivariate at every point, several points at a time.
+ *
+ * @param const double *points
+ * number_of_points points one after the other, each made of the values of the variables of multivariate.
+ *
+ * @param double *values
+ * Its length must be at least number_of_points. values[i] is set to the value of multivariate at the i-th point.
+ */
+extern void polynomial_multivariate_compute_points(const PolynomialMultivariate *multivariate, const double *points, unsigned long number_of_points, double *values);
+
+
+/*
+ * @function polynomial_multivariate_create
+ *
+ * @param int variables
+ * From 1 to MULTIVARIATE_MAX_VARIABLES.
+ *
+ * @param const unsigned int *exponents
+ * The exponents of each term, variables by variables: exponents[i * variables + v] is the exponent of variable v in term i.
+ * Terms may be given in any order, and several times.
+ *
+ * @return PolynomialMultivariate*
+ * Must be freed with polynomial_multivariate_free after use,
+ * or NULL if an exponent or a degree is too big. polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern PolynomialMultivariate* polynomial_multivariate_create(int variables, const unsigned int *exponents, const double *coefficients, unsigned long number_of_terms);
+
+
+/*
+ * @function polynomial_multivariate_create_from_string
+ *
+ * Parses terms in the syntax of monomial_create_from_string, with any of the variables, such as "3x^2y - 2yz^3 + 1".
+ * The polynomial has as many variables as the last one it uses: "3y" has 2.
+ *
+ * @return PolynomialMultivariate*
+ * Must be freed with polynomial_multivariate_free after use,
+ * or NULL if string is malformed or empty. polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern PolynomialMultivariate* polynomial_multivariate_create_from_string(const char *string);
+
+
+/*
+ * @function polynomial_multivariate_derivative
+ *
+ * @return PolynomialMultivariate*
+ * The partial derivative of multivariate with respect to variable, from 0 for x.
+ * Must be freed with polynomial_multivariate_free after use.
+ */
+extern PolynomialMultivariate* polynomial_multivariate_derivative(const PolynomialMultivariate *multivariate, int variable);
+
+
+/*
+ * @function polynomial_multivariate_free
+ *
+ * Frees associated resources and sets *multivariate to NULL to prevent further use.
+ */
+extern void polynomial_multivariate_free(PolynomialMultivariate **multivariate);
+
+
+/*
+ * @function polynomial_multivariate_get_degree
+ *
+ * @return long
+ * The total degree of the leading term of multivariate, 0 for the null polynomial.
+ */
+extern long polynomial_multivariate_get_degree(const PolynomialMultivariate *multivariate);
+
+
+/*
+ * @function polynomial_multivariate_get_number_of_terms
+ */
+extern unsigned long polynomial_multivariate_get_number_of_terms(const PolynomialMultivariate *multivariate);
+
+
+/*
+ * @function polynomial_multivariate_get_number_of_variables
+ */
+extern int polynomial_multivariate_get_number_of_variables(const PolynomialMultivariate *multivariate);
+
+
+/*
+ * @function polynomial_multivariate_get_term
+ *
+ * @param unsigned int *exponents
+ * Its length must be at least the number of variables of multivariate. It is set to the exponents of the index-th term.
+ *
+ * @return double
+ * The coefficient of the index-th term, in ascending order.
+ */
+extern double polynomial_multivariate_get_term(const PolynomialMultivariate *multivariate, unsigned long index, unsigned int *exponents);
+
+
+/*
+ * @function polynomial_multivariate_print
+ *
+ * Prints multivariate to stdout, such as ((1.00, 1), (3.00, x^2y)).
+ */
+extern void polynomial_multivariate_print(const PolynomialMultivariate *multivariate, int newline);
+
+
+/*
+ * @function polynomial_multivariate_product
+ *
+ * Multiplies the terms with a heap, which merges the products in ascending order as they are generated,
+ * and only holds one pending product per term of leftm.
+ *
+ * @return PolynomialMultivariate*
+ * The result of the product of leftm and rightm. Must be freed with polynomial_multivariate_free after use,
+ * or NULL if an exponent or a degree of the product would be too big.
+ * polynomials_errno is then set to POLYNOMIAL_MATH_ERROR, and errno to ERANGE.
+ */
+extern PolynomialMultivariate* polynomial_multivariate_product(const PolynomialMultivariate *leftm, const PolynomialMultivariate *rightm);
+
+
+/*
+ * @function polynomial_multivariate_sum
+ *
+ * @return PolynomialMultivariate*
+ * The result of the sum of leftm and rightm. Must be freed with polynomial_multivariate_free after use.
+ */
+extern PolynomialMultivariate* polynomial_multivariate_sum(const PolynomialMultivariate *leftm, const PolynomialMultivariate *rightm);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,437 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "Polynomial.h"
+#include "PolynomialPipeline.h"
+
+#define PIPELINE_SLOTS_PER_WORKER 4
+#define PIPELINE_INITIAL_LINES_SIZE 4096
+
+// lines go through the stages by blocks, so that threads synchronize once per block rather than once per line
+#define PIPELINE_LINES_PER_SLOT 64
+
+typedef enum {
+  PIPELINE_SLOT_EMPTY, // owned by the reader
+  PIPELINE_SLOT_READ, // waiting for a worker, or owned by the worker which claimed it
+  PIPELINE_SLOT_DONE // owned by the writer
+} PIPELINE_SLOT_STATE;
+
+/*
+ * Block number n always goes through slot n % slots_count,
+ * so the slots are both the queue between the stages and the buffer restoring input order.
+ * Buffers are kept from one block to the next.
+ */
+typedef struct {
+  PIPELINE_SLOT_STATE state;
+  char *lines; // lines_count lines, each one ended by '\0' instead of '\n'
+  size_t lines_size;
+  unsigned int lines_count;
+  char *result;
+  size_t result_length;
+} PipelineSlot;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t slot_emptied; // waited for by the reader
+  pthread_cond_t slot_read; // waited for by the workers
+  pthread_cond_t slot_done; // waited for by the writer
+
+  PipelineSlot *slots;
+  unsigned int slots_count;
+  unsigned int lines_per_slot;
+
+  unsigned long read_count; // blocks handed to the workers
+  unsigned long claimed_count; // blocks claimed by a worker
+  int reading_done;
+  int input_error;
+  unsigned long malformed_lines; // written as empty lines
+
+  FILE *input;
+  const PolynomialPipelineOptions *options;
+} Pipeline;
+
+
+static void* pipeline_allocate(void *pointer, size_t size) {
+  void *allocated = realloc(pointer, size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+/*
+ * @function pipeline_read_line
+ *
+ * Appends a whole line to slot->lines, from offset, growing it as needed, without its '\n'.
+ *
+ * @return size_t
+ * The offset following the line, or 0 at the end of the input.
+ */
+static size_t pipeline_read_line(FILE *input, PipelineSlot *slot, size_t offset) {
+  if(slot->lines_size - offset < 2) {
+    slot->lines_size *= 2;
+    slot->lines = pipeline_allocate(slot->lines, slot->lines_size);
+  }
+
+  char *line = slot->lines + offset;
+  if(fgets(line, slot->lines_size - offset, input) != line) {
+    return 0;
+  }
+
+  // a line starting with '\0' looks empty
+  size_t line_length = strlen(line);
+  while(line_length > 0 && line[line_length - 1] != '\n' && !feof(input)) {
+    slot->lines_size *= 2;
+    slot->lines = pipeline_allocate(slot->lines, slot->lines_size);
+    line = slot->lines + offset;
+
+    if(fgets(line + line_length, slot->lines_size - offset - line_length, input) != line + line_length) {
+      break;
+    }
+
+    line_length += strlen(line + line_length);
+  }
+
+  if(line_length > 0 && line[line_length - 1] == '\n') {
+    line[line_length - 1] = '\0';
+    return offset + line_length;
+  }
+
+  return offset + line_length + 1;
+}
+
+
+static void* pipeline_reader_run(void *argument) {
+  Pipeline *pipeline = argument;
+
+  for(;;) {
+    pthread_mutex_lock(&pipeline->mutex);
+    PipelineSlot *slot = &pipeline->slots[pipeline->read_count % pipeline->slots_count];
+    while(slot->state != PIPELINE_SLOT_EMPTY) {
+      pthread_cond_wait(&pipeline->slot_emptied, &pipeline->mutex);
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    // the slot is empty: no other stage touches it until it is marked as read
+    size_t offset = 0;
+    slot->lines_count = 0;
+    while(slot->lines_count < pipeline->lines_per_slot) {
+      offset = pipeline_read_line(pipeline->input, slot, offset);
+      if(offset == 0) {
+        break;
+      }
+
+      slot->lines_count++;
+    }
+
+    pthread_mutex_lock(&pipeline->mutex);
+    if(slot->lines_count == 0) {
+      pipeline->reading_done = 1;
+      pipeline->input_error = ferror(pipeline->input);
+      pthread_cond_broadcast(&pipeline->slot_read);
+      pthread_cond_signal(&pipeline->slot_done);
+      pthread_mutex_unlock(&pipeline->mutex);
+      break;
+    }
+
+    slot->state = PIPELINE_SLOT_READ;
+    pipeline->read_count++;
+    pthread_cond_signal(&pipeline->slot_read);
+    pthread_mutex_unlock(&pipeline->mutex);
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @function pipeline_process_line
+ *
+ * @return int
+ * 0 if line is malformed, 1 otherwise.
+ */
+static int pipeline_process_line(const PolynomialPipelineOptions *options, char *line, FILE *output) {
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  Polynomial *polynomial = polynomial_create_from_string(line);
+  if(!polynomial) {
+    fprintf(output, "\n");
+    return polynomials_errno != POLYNOMIAL_INPUT_ERROR;
+  }
+
+  switch(options->operation) {
+    case POLYNOMIAL_PIPELINE_DERIVATIVE: {
+      Polynomial *derivative = polynomial_derivative(polynomial);
+      polynomial_write_to_stream(derivative, output);
+      polynomial_free(&derivative);
+      break;
+    }
+
+    case POLYNOMIAL_PIPELINE_POWER: {
+      Polynomial *power = polynomial_power(polynomial, (int) options->parameter);
+      polynomial_write_to_stream(power, output);
+      polynomial_free(&power);
+      break;
+    }
+
+    case POLYNOMIAL_PIPELINE_COMPUTE: {
+      double value;
+      polynomial_compute_derivatives(polynomial, options->parameter, &value, 1);
+      fprintf(output, "%.17g\n", value);
+      break;
+    }
+
+    case POLYNOMIAL_PIPELINE_CUSTOM:
+      options->custom(polynomial, output, options->context);
+      break;
+  }
+
+  polynomial_free(&polynomial);
+
+  return 1;
+}
+
+
+/*
+ * @function pipeline_process
+ *
+ * @return unsigned int
+ * The number of malformed lines in the slot.
+ */
+static unsigned int pipeline_process(const PolynomialPipelineOptions *options, PipelineSlot *slot) {
+  free(slot->result);
+  slot->result = NULL;
+
+  FILE *output = open_memstream(&slot->result, &slot->result_length);
+  if(!output) {
+    fprintf(stderr, "Fatal error: couldn't open a memory stream!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned int malformed = 0;
+  char *line = slot->lines;
+  unsigned int index;
+  for(index = 0; index < slot->lines_count; index++) {
+    malformed += !pipeline_process_line(options, line, output);
+    line += strlen(line) + 1;
+  }
+
+  fclose(output);
+
+  return malformed;
+}
+
+
+static void* pipeline_worker_run(void *argument) {
+  Pipeline *pipeline = argument;
+
+  for(;;) {
+    pthread_mutex_lock(&pipeline->mutex);
+    while(pipeline->claimed_count == pipeline->read_count && !pipeline->reading_done) {
+      pthread_cond_wait(&pipeline->slot_read, &pipeline->mutex);
+    }
+
+    if(pipeline->claimed_count == pipeline->read_count) {
+      pthread_mutex_unlock(&pipeline->mutex);
+      break;
+    }
+
+    PipelineSlot *slot = &pipeline->slots[pipeline->claimed_count % pipeline->slots_count];
+    pipeline->claimed_count++;
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    unsigned int malformed = pipeline_process(pipeline->options, slot);
+
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->malformed_lines += malformed;
+    slot->state = PIPELINE_SLOT_DONE;
+    pthread_cond_signal(&pipeline->slot_done);
+    pthread_mutex_unlock(&pipeline->mutex);
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @function pipeline_write
+ *
+ * The writer stage, run by the calling thread: writes the results in input order.
+ *
+ * @return int
+ * 1 on success, 0 if output couldn't be written.
+ * The remaining results are then still consumed, so that the other stages can end.
+ */
+static int pipeline_write(Pipeline *pipeline, FILE *output) {
+  int success = 1;
+
+  unsigned long written;
+  for(written = 0; ; written++) {
+    pthread_mutex_lock(&pipeline->mutex);
+    PipelineSlot *slot = &pipeline->slots[written % pipeline->slots_count];
+    while(slot->state != PIPELINE_SLOT_DONE && !(pipeline->reading_done && written == pipeline->read_count)) {
+      pthread_cond_wait(&pipeline->slot_done, &pipeline->mutex);
+    }
+
+    if(slot->state != PIPELINE_SLOT_DONE) {
+      pthread_mutex_unlock(&pipeline->mutex);
+      break;
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+
+    if(success && fwrite(slot->result, 1, slot->result_length, output) != slot->result_length) {
+      success = 0;
+    }
+
+    pthread_mutex_lock(&pipeline->mutex);
+    slot->state = PIPELINE_SLOT_EMPTY;
+    pthread_cond_signal(&pipeline->slot_emptied);
+    pthread_mutex_unlock(&pipeline->mutex);
+  }
+
+  return success;
+}
+
+
+int polynomial_pipeline_run(const char *input_filename, const char *output_filename, const PolynomialPipelineOptions *options) {
+  assert(input_filename != NULL);
+  assert(output_filename != NULL);
+  assert(options != NULL);
+
+  errno = 0;
+  FILE *input = fopen(input_filename, "r");
+  if(!input) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return 0;
+  }
+
+  FILE *output = fopen(output_filename, "w");
+  if(!output) {
+    fclose(input);
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    return 0;
+  }
+
+  int success = polynomial_pipeline_run_streams(input, output, options);
+
+  fclose(input);
+  if(fclose(output) != 0 && success) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+    success = 0;
+  }
+
+  return success;
+}
+
+
+int polynomial_pipeline_run_streams(FILE *input, FILE *output, const PolynomialPipelineOptions *options) {
+  assert(input != NULL);
+  assert(output != NULL);
+  assert(options != NULL);
+  assert(options->operation != POLYNOMIAL_PIPELINE_CUSTOM || options->custom != NULL);
+
+  // polynomial_power only takes whole powers >= 1
+  if(options->operation == POLYNOMIAL_PIPELINE_POWER
+    && (!(options->parameter >= 1 && options->parameter <= INT_MAX) || options->parameter != (int) options->parameter)) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    return 0;
+  }
+
+  unsigned int workers = options->workers;
+  if(workers == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = online > 0 ? (unsigned int) online : 1;
+  }
+
+  Pipeline pipeline;
+  pipeline.slots_count = workers * PIPELINE_SLOTS_PER_WORKER;
+  pipeline.lines_per_slot = PIPELINE_LINES_PER_SLOT;
+  if(options->lines_in_flight > 0) {
+    if(pipeline.slots_count > options->lines_in_flight) {
+      pipeline.slots_count = options->lines_in_flight;
+    }
+
+    pipeline.lines_per_slot = options->lines_in_flight / pipeline.slots_count;
+  }
+
+  pipeline.slots = pipeline_allocate(NULL, sizeof(PipelineSlot) * pipeline.slots_count);
+  pipeline.read_count = 0;
+  pipeline.claimed_count = 0;
+  pipeline.reading_done = 0;
+  pipeline.input_error = 0;
+  pipeline.malformed_lines = 0;
+  pipeline.input = input;
+  pipeline.options = options;
+
+  unsigned int index;
+  for(index = 0; index < pipeline.slots_count; index++) {
+    pipeline.slots[index].state = PIPELINE_SLOT_EMPTY;
+    pipeline.slots[index].lines_size = PIPELINE_INITIAL_LINES_SIZE;
+    pipeline.slots[index].lines = pipeline_allocate(NULL, PIPELINE_INITIAL_LINES_SIZE);
+    pipeline.slots[index].lines_count = 0;
+    pipeline.slots[index].result = NULL;
+    pipeline.slots[index].result_length = 0;
+  }
+
+  pthread_mutex_init(&pipeline.mutex, NULL);
+  pthread_cond_init(&pipeline.slot_emptied, NULL);
+  pthread_cond_init(&pipeline.slot_read, NULL);
+  pthread_cond_init(&pipeline.slot_done, NULL);
+
+  pthread_t reader;
+  pthread_t *threads = pipeline_allocate(NULL, sizeof(pthread_t) * workers);
+  if(pthread_create(&reader, NULL, pipeline_reader_run, &pipeline) != 0) {
+    fprintf(stderr, "Fatal error: couldn't start the pipeline's reader!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned int started = 0;
+  for(index = 0; index < workers; index++) {
+    if(pthread_create(&threads[started], NULL, pipeline_worker_run, &pipeline) == 0) {
+      started++;
+    }
+  }
+
+  if(started == 0) {
+    fprintf(stderr, "Fatal error: couldn't start any pipeline's worker!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  int success = pipeline_write(&pipeline, output);
+
+  pthread_join(reader, NULL);
+  for(index = 0; index < started; index++) {
+    pthread_join(threads[index], NULL);
+  }
+
+  if(!success) {
+    polynomials_errno = POLYNOMIAL_OUTPUT_ERROR;
+  } else if(pipeline.input_error || pipeline.malformed_lines > 0) {
+    polynomials_errno = POLYNOMIAL_INPUT_ERROR;
+    success = 0;
+  }
+
+  pthread_cond_destroy(&pipeline.slot_done);
+  pthread_cond_destroy(&pipeline.slot_read);
+  pthread_cond_destroy(&pipeline.slot_emptied);
+  pthread_mutex_destroy(&pipeline.mutex);
+
+  for(index = 0; index < pipeline.slots_count; index++) {
+    free(pipeline.slots[index].lines);
+    free(pipeline.slots[index].result);
+  }
+  free(pipeline.slots);
+  free(threads);
+
+  return success;
+}
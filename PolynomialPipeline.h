@@ -0,0 +1,74 @@
+#ifndef H_POLYNOMIAL_PIPELINE
+#define H_POLYNOMIAL_PIPELINE
+
+#include <stdio.h>
+
+#include "Polynomial.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A pipeline applies an operation to every polynomial of a file, one per line,
+ * and writes one line of result per polynomial, in input order.
+ *
+ * A reader thread reads lines, worker threads parse them and apply the operation,
+ * and the calling thread writes the results as soon as the oldest one is ready.
+ * The stages are connected by a bounded ring of blocks of lines: the reader waits when it is full,
+ * so memory use doesn't depend on the size of the file, and I/O overlaps computation.
+ */
+
+typedef enum {
+  POLYNOMIAL_PIPELINE_DERIVATIVE, // writes the derivative
+  POLYNOMIAL_PIPELINE_POWER, // writes polynomial ^ parameter, which must be a whole number >= 1
+  POLYNOMIAL_PIPELINE_COMPUTE, // writes the value at x = parameter
+  POLYNOMIAL_PIPELINE_CUSTOM // calls custom
+} POLYNOMIAL_PIPELINE_OPERATION;
+
+
+typedef struct {
+  POLYNOMIAL_PIPELINE_OPERATION operation;
+  double parameter;
+
+  unsigned int workers; // 0 uses one worker per online processor
+  unsigned int lines_in_flight; // maximum number of lines held at once, 0 uses 4 blocks of 64 lines per worker
+
+  /*
+   * Used by POLYNOMIAL_PIPELINE_CUSTOM.
+   * Writes the result for polynomial to output, which is private to the calling worker.
+   * May be called by several workers at once.
+   */
+  void (*custom)(const Polynomial *polynomial, FILE *output, void *context);
+  void *context;
+} PolynomialPipelineOptions;
+
+
+/*
+ * @function polynomial_pipeline_run
+ *
+ * Runs the pipeline from input_filename to output_filename.
+ *
+ * @return int
+ * 1 on success, 0 on failure.
+ * polynomials_errno is then set to POLYNOMIAL_INPUT_ERROR or POLYNOMIAL_OUTPUT_ERROR.
+ * Malformed lines are a failure too, but don't stop the pipeline: an empty line is written for each of them.
+ */
+extern int polynomial_pipeline_run(const char *input_filename, const char *output_filename, const PolynomialPipelineOptions *options);
+
+
+/*
+ * @function polynomial_pipeline_run_streams
+ *
+ * Same as polynomial_pipeline_run, on streams which are not closed.
+ * A power which is not a whole number >= 1 fails at once, with polynomials_errno set to POLYNOMIAL_INPUT_ERROR.
+ */
+extern int polynomial_pipeline_run_streams(FILE *input, FILE *output, const PolynomialPipelineOptions *options);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,55 @@
+#ifndef H_POLYNOMIAL_PROTOCOL
+#define H_POLYNOMIAL_PROTOCOL
+
+#include <stdint.h>
+
+/*
+ * Protocol spoken by polyserver over a Unix-domain socket.
+ *
+ * Every message, request or response, is a frame:
+ * a uint32_t holding the length of the rest of the frame, a PolynomialFrameHeader, then a payload.
+ * Numbers are in the host's byte order: client and server always run on the same machine.
+ *
+ * A client may send several requests without waiting for their responses.
+ * Responses carry the tag of their request, and may come back in any order.
+ *
+ * Requests and payloads:
+ * - REGISTER: the polynomial as text, in the format of polynomial_create_from_string.
+ *   Response: the uint64_t id of the polynomial in the registry.
+ * - UNREGISTER: a uint64_t id. Response: empty.
+ * - EVALUATE: a uint64_t id, a uint32_t count, then count doubles.
+ *   Response: the count values of the polynomial at these points.
+ * - DERIVE: a uint64_t id. Response: the uint64_t id of its derivative, added to the registry.
+ * - MULTIPLY: two uint64_t ids. Response: the uint64_t id of their product, added to the registry.
+ * - GET: a uint64_t id. Response: the polynomial as text, in the format of polynomial_write_to_stream.
+ */
+
+#define POLYNOMIAL_PROTOCOL_DEFAULT_SOCKET "/tmp/polyserver.sock"
+
+// longest frame accepted by the server, the length prefix excluded
+#define POLYNOMIAL_PROTOCOL_MAX_FRAME (16 * 1024 * 1024)
+
+typedef enum {
+  POLYNOMIAL_REQUEST_REGISTER = 1,
+  POLYNOMIAL_REQUEST_UNREGISTER,
+  POLYNOMIAL_REQUEST_EVALUATE,
+  POLYNOMIAL_REQUEST_DERIVE,
+  POLYNOMIAL_REQUEST_MULTIPLY,
+  POLYNOMIAL_REQUEST_GET
+} POLYNOMIAL_REQUEST;
+
+typedef enum {
+  POLYNOMIAL_RESPONSE_OK,
+  POLYNOMIAL_RESPONSE_UNKNOWN_ID,
+  POLYNOMIAL_RESPONSE_MALFORMED, // unknown operation, or payload of the wrong size
+  POLYNOMIAL_RESPONSE_MATH_ERROR
+} POLYNOMIAL_RESPONSE;
+
+typedef struct {
+  uint8_t operation; // a POLYNOMIAL_REQUEST, repeated in the response
+  uint8_t status; // a POLYNOMIAL_RESPONSE, 0 in requests
+  uint16_t reserved;
+  uint32_t tag; // chosen by the client, repeated in the response
+} PolynomialFrameHeader;
+
+#endif
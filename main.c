@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 #include "monomial_tests.h"
+#include "polynomial_hpp_tests.h"
 #include "polynomial_tests.h"
 
 int main(void) {
@@ -19,5 +20,12 @@ int main(void) {
   puts("");
   polynomial_tests_run();
 
+  printf("\n\n\n");
+  puts("##############################");
+  puts("Running tests on the C++ LAYER");
+  puts("##############################");
+  puts("");
+  polynomial_hpp_tests_run();
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,437 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Polynomial.h"
+#include "PolynomialProtocol.h"
+
+// tolerance used when checking the values computed by the server
+#define LOAD_CHECK_TOLERANCE 1e-9
+
+typedef struct {
+  const char *socket_path;
+  unsigned int connections;
+  unsigned long requests; // per connection
+  unsigned int points; // per request
+  unsigned int depth; // requests sent ahead of their responses, per connection
+  unsigned int degree;
+  unsigned int polynomials;
+  int check;
+} Options;
+
+typedef struct {
+  const Options *options;
+  const uint64_t *ids;
+  Polynomial **polynomials;
+  unsigned int seed;
+
+  double *latencies; // in seconds, one per request
+  unsigned long errors;
+} Client;
+
+
+static void fail(const char *message) {
+  fprintf(stderr, "polyload: %s: %s\n", message, strerror(errno));
+  exit(EXIT_FAILURE);
+}
+
+
+static void* load_allocate(size_t size) {
+  void *allocated = malloc(size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+static double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+
+/*
+ * @function random_double
+ *
+ * @return double
+ * A pseudo-random number in [-1, 1], from a xorshift generator private to the caller.
+ */
+static double random_double(unsigned int *seed) {
+  *seed ^= *seed << 13;
+  *seed ^= *seed >> 17;
+  *seed ^= *seed << 5;
+
+  return *seed / (double) UINT32_MAX * 2. - 1.;
+}
+
+
+static int connect_to_server(const char *socket_path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(fd < 0 || connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+    fail(socket_path);
+  }
+
+  return fd;
+}
+
+
+static void write_all(int fd, const void *data, size_t length) {
+  const char *cursor = data;
+  while(length > 0) {
+    ssize_t written = write(fd, cursor, length);
+    if(written < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      fail("couldn't send a request");
+    }
+
+    cursor += written;
+    length -= written;
+  }
+}
+
+
+static void read_all(int fd, void *data, size_t length) {
+  char *cursor = data;
+  while(length > 0) {
+    ssize_t received = read(fd, cursor, length);
+    if(received <= 0) {
+      if(received < 0 && errno == EINTR) {
+        continue;
+      }
+      errno = received == 0 ? ECONNRESET : errno;
+      fail("couldn't receive a response");
+    }
+
+    cursor += received;
+    length -= received;
+  }
+}
+
+
+static void send_request(int fd, POLYNOMIAL_REQUEST operation, uint32_t tag, const void *payload, uint32_t payload_length) {
+  uint32_t length = sizeof(PolynomialFrameHeader) + payload_length;
+  PolynomialFrameHeader header = { operation, 0, 0, tag };
+
+  write_all(fd, &length, sizeof(length));
+  write_all(fd, &header, sizeof(header));
+  write_all(fd, payload, payload_length);
+}
+
+
+/*
+ * @function receive_response
+ *
+ * @return void*
+ * The payload of the response, to be freed with free.
+ */
+static void* receive_response(int fd, PolynomialFrameHeader *header, uint32_t *payload_length) {
+  uint32_t length;
+  read_all(fd, &length, sizeof(length));
+  if(length < sizeof(PolynomialFrameHeader)) {
+    errno = EPROTO;
+    fail("malformed response");
+  }
+
+  read_all(fd, header, sizeof(PolynomialFrameHeader));
+
+  *payload_length = length - sizeof(PolynomialFrameHeader);
+  void *payload = load_allocate(*payload_length > 0 ? *payload_length : 1);
+  read_all(fd, payload, *payload_length);
+
+  return payload;
+}
+
+
+/*
+ * @function register_polynomials
+ *
+ * Registers options->polynomials random polynomials of degree options->degree.
+ * The polynomials are kept, to check the values computed by the server.
+ */
+static void register_polynomials(const Options *options, uint64_t *ids, Polynomial **polynomials) {
+  int fd = connect_to_server(options->socket_path);
+  unsigned int seed = 2463534242u;
+
+  double *coefficients = load_allocate(sizeof(double) * (options->degree + 1));
+
+  unsigned int index;
+  for(index = 0; index < options->polynomials; index++) {
+    char *text = NULL;
+    size_t text_length = 0;
+    FILE *stream = open_memstream(&text, &text_length);
+    if(!stream) {
+      fail("couldn't open a memory stream");
+    }
+
+    unsigned int degree;
+    for(degree = 0; degree <= options->degree; degree++) {
+      // two decimals, so that the text holds the exact coefficients
+      coefficients[degree] = round(random_double(&seed) * 100) / 100;
+      if(coefficients[degree] == 0) {
+        coefficients[degree] = 1;
+      }
+      fprintf(stream, "%s%.2fx^%u ", coefficients[degree] >= 0 ? "+ " : "- ", fabs(coefficients[degree]), degree);
+    }
+    fclose(stream);
+
+    polynomials[index] = polynomial_create(coefficients, options->degree);
+
+    send_request(fd, POLYNOMIAL_REQUEST_REGISTER, index, text, text_length);
+    free(text);
+
+    PolynomialFrameHeader header;
+    uint32_t payload_length;
+    void *payload = receive_response(fd, &header, &payload_length);
+    if(header.status != POLYNOMIAL_RESPONSE_OK || payload_length != sizeof(uint64_t)) {
+      fprintf(stderr, "polyload: couldn't register polynomial %u (status %u)\n", index, header.status);
+      exit(EXIT_FAILURE);
+    }
+
+    memcpy(&ids[index], payload, sizeof(uint64_t));
+    free(payload);
+  }
+
+  free(coefficients);
+  close(fd);
+}
+
+
+static void* client_run(void *argument) {
+  Client *client = argument;
+  const Options *options = client->options;
+  int fd = connect_to_server(options->socket_path);
+
+  uint32_t request_length = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(double) * options->points;
+  char *request = load_allocate(request_length);
+
+  /*
+   * Requests in flight use one of depth slots, holding their points and send time.
+   * Responses may come back in any order, so the slots are reused through a stack of the free ones,
+   * and the tag of a request is its slot.
+   */
+  double *points = load_allocate(sizeof(double) * options->points * options->depth);
+  double *sent_at = load_allocate(sizeof(double) * options->depth);
+  unsigned int *polynomial_of = load_allocate(sizeof(unsigned int) * options->depth);
+  unsigned int *free_slots = load_allocate(sizeof(unsigned int) * options->depth);
+  unsigned int free_count;
+  for(free_count = 0; free_count < options->depth; free_count++) {
+    free_slots[free_count] = options->depth - 1 - free_count;
+  }
+
+  unsigned long sent = 0, received = 0;
+  while(received < options->requests) {
+    // keep depth requests in flight
+    while(sent < options->requests && free_count > 0) {
+      unsigned int slot = free_slots[--free_count];
+      unsigned int polynomial = sent % options->polynomials;
+      double *slot_points = points + slot * options->points;
+
+      unsigned int point;
+      for(point = 0; point < options->points; point++) {
+        slot_points[point] = random_double(&client->seed);
+      }
+
+      uint32_t count = options->points;
+      memcpy(request, &client->ids[polynomial], sizeof(uint64_t));
+      memcpy(request + sizeof(uint64_t), &count, sizeof(uint32_t));
+      memcpy(request + sizeof(uint64_t) + sizeof(uint32_t), slot_points, sizeof(double) * count);
+
+      polynomial_of[slot] = polynomial;
+      sent_at[slot] = now();
+      send_request(fd, POLYNOMIAL_REQUEST_EVALUATE, slot, request, request_length);
+      sent++;
+    }
+
+    PolynomialFrameHeader header;
+    uint32_t payload_length;
+    double *values = receive_response(fd, &header, &payload_length);
+    double received_at = now();
+
+    unsigned int slot = header.tag;
+    if(slot >= options->depth) {
+      errno = EPROTO;
+      fail("response to an unknown request");
+    }
+
+    client->latencies[received++] = received_at - sent_at[slot];
+    free_slots[free_count++] = slot;
+
+    if(header.status != POLYNOMIAL_RESPONSE_OK || payload_length != sizeof(double) * options->points) {
+      client->errors++;
+    } else if(options->check) {
+      unsigned int point;
+      for(point = 0; point < options->points; point++) {
+        double expected;
+        polynomial_compute_derivatives(client->polynomials[polynomial_of[slot]], points[slot * options->points + point], &expected, 1);
+        if(fabs(values[point] - expected) > LOAD_CHECK_TOLERANCE * (1 + fabs(expected))) {
+          client->errors++;
+          break;
+        }
+      }
+    }
+
+    free(values);
+  }
+
+  free(free_slots);
+  free(polynomial_of);
+  free(sent_at);
+  free(points);
+  free(request);
+  close(fd);
+
+  return NULL;
+}
+
+
+static int compare_doubles(const void *left, const void *right) {
+  double difference = *(const double*) left - *(const double*) right;
+  return (difference > 0) - (difference < 0);
+}
+
+
+static double percentile(const double *sorted, unsigned long length, double rank) {
+  unsigned long index = (unsigned long) ceil(rank / 100. * length);
+
+  return sorted[index > 0 ? index - 1 : 0];
+}
+
+
+static void usage(void) {
+  fprintf(stderr,
+    "usage: polyload [options]\n"
+    "\n"
+    "Sends evaluation requests to polyserver and reports throughput and latency percentiles.\n"
+    "\n"
+    "  -s SOCKET        path of the server's socket, " POLYNOMIAL_PROTOCOL_DEFAULT_SOCKET " by default\n"
+    "  -c CONNECTIONS   concurrent connections, one thread each (default 4)\n"
+    "  -n REQUESTS      requests per connection (default 10000)\n"
+    "  -p POINTS        points per request (default 16)\n"
+    "  -d DEPTH         requests in flight per connection (default 8)\n"
+    "  -g DEGREE        degree of the polynomials (default 20)\n"
+    "  -k POLYNOMIALS   number of polynomials registered (default 16)\n"
+    "  -v               checks every value against a local computation\n"
+  );
+  exit(EXIT_FAILURE);
+}
+
+
+static unsigned long parse_count(const char *string, unsigned long minimum) {
+  char *end;
+  errno = 0;
+  unsigned long count = strtoul(string, &end, 10);
+  if(*end != '\0' || errno != 0 || count < minimum || count > UINT32_MAX) {
+    usage();
+  }
+
+  return count;
+}
+
+
+int main(int argc, char **argv) {
+  Options options = { POLYNOMIAL_PROTOCOL_DEFAULT_SOCKET, 4, 10000, 16, 8, 20, 16, 0 };
+
+  int option;
+  while((option = getopt(argc, argv, "s:c:n:p:d:g:k:v")) != -1) {
+    switch(option) {
+      case 's': options.socket_path = optarg; break;
+      case 'c': options.connections = parse_count(optarg, 1); break;
+      case 'n': options.requests = parse_count(optarg, 1); break;
+      case 'p': options.points = parse_count(optarg, 0); break;
+      case 'd': options.depth = parse_count(optarg, 1); break;
+      case 'g': options.degree = parse_count(optarg, 0); break;
+      case 'k': options.polynomials = parse_count(optarg, 1); break;
+      case 'v': options.check = 1; break;
+      default: usage();
+    }
+  }
+
+  if(optind != argc) {
+    usage();
+  }
+
+  uint64_t *ids = load_allocate(sizeof(uint64_t) * options.polynomials);
+  Polynomial **polynomials = load_allocate(sizeof(Polynomial*) * options.polynomials);
+  register_polynomials(&options, ids, polynomials);
+
+  Client *clients = load_allocate(sizeof(Client) * options.connections);
+  pthread_t *threads = load_allocate(sizeof(pthread_t) * options.connections);
+
+  double start = now();
+
+  unsigned int index;
+  for(index = 0; index < options.connections; index++) {
+    clients[index].options = &options;
+    clients[index].ids = ids;
+    clients[index].polynomials = polynomials;
+    clients[index].seed = 88675123u + index * 7919u;
+    clients[index].latencies = load_allocate(sizeof(double) * options.requests);
+    clients[index].errors = 0;
+
+    if(pthread_create(&threads[index], NULL, client_run, &clients[index]) != 0) {
+      fail("couldn't start a client");
+    }
+  }
+
+  for(index = 0; index < options.connections; index++) {
+    pthread_join(threads[index], NULL);
+  }
+
+  double elapsed = now() - start;
+
+  unsigned long total = options.requests * options.connections;
+  double *latencies = load_allocate(sizeof(double) * total);
+  unsigned long errors = 0;
+  for(index = 0; index < options.connections; index++) {
+    memcpy(latencies + index * options.requests, clients[index].latencies, sizeof(double) * options.requests);
+    errors += clients[index].errors;
+    free(clients[index].latencies);
+  }
+
+  qsort(latencies, total, sizeof(double), compare_doubles);
+
+  printf("%lu requests of %u points on %u connections in %.3f s\n", total, options.points, options.connections, elapsed);
+  printf("throughput: %.0f requests/s, %.0f points/s\n", total / elapsed, total * (double) options.points / elapsed);
+  printf("latency (us): p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+    percentile(latencies, total, 50) * 1e6,
+    percentile(latencies, total, 90) * 1e6,
+    percentile(latencies, total, 99) * 1e6,
+    percentile(latencies, total, 99.9) * 1e6,
+    latencies[total - 1] * 1e6
+  );
+  printf("errors: %lu\n", errors);
+
+  for(index = 0; index < options.polynomials; index++) {
+    polynomial_free(&polynomials[index]);
+  }
+
+  free(latencies);
+  free(threads);
+  free(clients);
+  free(polynomials);
+  free(ids);
+
+  return errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
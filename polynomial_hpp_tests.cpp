@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+#include "Polynomial.hpp"
+#include "PolynomialFixed.hpp"
+#include "polynomial_hpp_tests.h"
+
+#define TEST_HPP_WIDE_DEGREE 100
+
+namespace poly = polynomials;
+
+// computed at compile time: a failure doesn't build
+constexpr poly::FixedPolynomial cubic(1., -2., 0., 0.5); // 1 - 2x + 0.5x^3
+static_assert(cubic(2.) == 1.);
+static_assert(cubic.estrin(2.) == 1.);
+static_assert(cubic.derivative()(2.) == 4.);
+static_assert(cubic.derivative().derivative().derivative()(0.) == 3.);
+
+static void print(const char *name, const poly::Polynomial &polynomial) {
+  printf("%s = ", name);
+  polynomial_print(polynomial.get(), 1);
+}
+
+void polynomial_hpp_tests_run(void) {
+
+  printf("\n==========CONSTRUCTION==========\n");
+  poly::Polynomial a = { 1, 2 }; // 1 + 2x
+  poly::Polynomial b = poly::Polynomial::from_string("x^2 - 3");
+  poly::Polynomial c = { 0, 0, 0, 1 }; // x^3
+  poly::Polynomial null;
+  print("a", a);
+  print("b", b);
+  print("c", c);
+  print("null", null);
+
+  try {
+    poly::Polynomial malformed = poly::Polynomial::from_string("2x^^3");
+    printf("malformed string accepted\n");
+  } catch(const std::invalid_argument &error) {
+    printf("malformed string rejected: %s\n", error.what());
+  }
+
+  printf("\n==========MOVES==========\n");
+  const ::Polynomial *address = a.get();
+  poly::Polynomial moved = std::move(a);
+  printf("moved without allocating: %s\n", moved.get() == address && a.get() == nullptr ? "yes" : "no");
+  a = std::move(moved);
+  poly::Polynomial copy = a.clone();
+  printf("clone equal to the original: %s\n", copy == a ? "yes" : "no");
+
+  printf("\n==========EXPRESSIONS==========\n");
+  poly::Polynomial sum = a + b - c;
+  print("a + b - c", sum);
+
+  poly::Polynomial fused = 2. * a + poly::derivative(b) - c / 2.;
+  print("2a + b' - c / 2", fused);
+
+  poly::Polynomial product = a * b;
+  print("a * b", product);
+
+  poly::Polynomial products = a * b + c * c - b;
+  print("a * b + c * c - b", products);
+
+  poly::Polynomial nested = poly::derivative((a + b) * c);
+  print("((a + b) * c)'", nested);
+
+  poly::Polynomial cancelled = a - a;
+  print("a - a", cancelled);
+
+  printf("a(2) = %g, (a * b)(2) = %g\n", a(2), product(2));
+
+  // only the monomials are read: no array of a million coefficients
+  poly::Polynomial sparse = poly::Polynomial::from_string("x^1000000 + 1");
+  poly::Polynomial sparse_sum = 2. * sparse + poly::derivative(sparse) - a;
+  print("2s + s' - a", sparse_sum);
+  poly::Polynomial sparse_product = (sparse + a) * (sparse - a);
+  print("(s + a)(s - a)", sparse_product);
+
+  // products of non-leaf operands go through polynomial_product, exact for integral coefficients
+  double wide_coefficients[TEST_HPP_WIDE_DEGREE + 1];
+  for(int index = 0; index <= TEST_HPP_WIDE_DEGREE; index++) {
+    wide_coefficients[index] = 1000 + index;
+  }
+  poly::Polynomial wide(polynomial_create(wide_coefficients, TEST_HPP_WIDE_DEGREE));
+  poly::Polynomial wide_square = wide * wide;
+  poly::Polynomial doubled_square = (wide + wide) * wide - wide_square;
+  printf("(w + w) * w - w * w == w * w: %s\n", doubled_square == wide_square ? "yes" : "no");
+
+  printf("\n==========IN PLACE==========\n");
+  copy += b;
+  print("a + b", copy);
+  copy *= 3;
+  print("3(a + b)", copy);
+  copy -= b;
+  print("3(a + b) - b", copy);
+
+  printf("\n==========FIXED DEGREE==========\n");
+  // 1 - x^2/2 + x^4/24 - x^6/720, the Taylor series of cos
+  constexpr poly::FixedPolynomial cosine(1., 0., -1. / 2, 0., 1. / 24, 0., -1. / 720);
+  poly::Polynomial dynamic = cosine.to_polynomial();
+
+  double points[] = { -1, -0.5, 0, 0.25, 0.5, 1, 2 };
+  double values[sizeof(points) / sizeof(points[0])];
+  cosine.evaluate(points, values, sizeof(points) / sizeof(points[0]));
+
+  for(unsigned int index = 0; index < sizeof(points) / sizeof(points[0]); index++) {
+    double x = points[index];
+    printf("x = %5.2f: horner %.10f, estrin %.10f, batch %.10f, generic %.10f, derivative %.10f\n",
+      x, cosine(x), cosine.estrin(x), values[index], dynamic(x), cosine.derivative()(x));
+  }
+}
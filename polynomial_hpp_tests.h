@@ -0,0 +1,15 @@
+#ifndef H_POLYNOMIAL_HPP_TESTS
+#define H_POLYNOMIAL_HPP_TESTS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void polynomial_hpp_tests_run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -1,11 +1,45 @@
 
+#include <complex.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "Coefficients.h"
 #include "Polynomial.h"
+#include "PolynomialBatch.h"
+#include "PolynomialCache.h"
+#include "PolynomialChebyshev.h"
+#include "PolynomialExpression.h"
+#include "PolynomialFile.h"
+#include "PolynomialMultivariate.h"
+#include "PolynomialPipeline.h"
 
 #define NUMBER_OF_TEST_POLYNOMIALS 7
 #define TEST_X 3
 #define TEST_POWER 2
+#define TEST_EXACT_POWER_DEGREE 40
+#define TEST_LOW_PRODUCT_DEGREE 100
+#define TEST_SHIFT 1
+#define TEST_SHIFT_DEGREE 100
+#define TEST_SCALE 2
+#define TEST_ORDER 5
+#define TEST_DERIVATIVES 4
+#define TEST_BATCH_LENGTH 4000
+#define TEST_BATCH_DEGREE 63
+#define TEST_CACHE_POWERS 6
+#define TEST_HASH_POWER 9
+#define TEST_HASH_WIDE_POWER 40
+#define TEST_CHEBYSHEV_DEGREE 40
+#define TEST_CHEBYSHEV_POINTS 1001
+#define TEST_CHEBYSHEV_LONG_DEGREE 2049
+#define TEST_FLOAT_LENGTH 16
+#define TEST_FLOAT_POINTS 37
+#define TEST_KERNELS_LENGTH 75
+#define TEST_FILE_LEFT_DEGREE 1000
+#define TEST_FILE_RIGHT_DEGREE 700
+#define TEST_FILE_BLOCK 96
+#define TEST_PREPARED_DEGREE 300
+#define TEST_PREPARED_SPARSE_DEGREE 5000
 
 static void dump_polynomials_errno(void) {
   switch(polynomials_errno) {
@@ -21,6 +55,190 @@ static void dump_polynomials_errno(void) {
   }
 }
 
+static void run_pipeline_on(const char *name, FILE *input, const PolynomialPipelineOptions *options) {
+  FILE *output = tmpfile();
+  if(!output) {
+    fprintf(stderr, "Error in a temporary file!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("%s: %s\n", name, polynomial_pipeline_run_streams(input, output, options) ? "successful" : "failure");
+
+  rewind(output);
+  int character;
+  while((character = fgetc(output)) != EOF) {
+    putchar(character);
+  }
+
+  fclose(output);
+}
+
+static void run_pipeline(const char *name, const PolynomialPipelineOptions *options) {
+  FILE *input = fopen("saved.txt", "r");
+  if(!input) {
+    fprintf(stderr, "Error in file 'saved.txt'!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  run_pipeline_on(name, input, options);
+
+  fclose(input);
+}
+
+/*
+ * Runs every element-wise kernel for every length up to TEST_KERNELS_LENGTH, and writes their results to results,
+ * which holds 7 * TEST_KERNELS_LENGTH * TEST_KERNELS_LENGTH doubles.
+ */
+static void run_kernels(const double *source, double *results) {
+  double destination[TEST_KERNELS_LENGTH];
+  long degrees[TEST_KERNELS_LENGTH];
+
+  int length;
+  for(length = 1; length <= TEST_KERNELS_LENGTH; length++) {
+    double *result = results + 7 * TEST_KERNELS_LENGTH * (length - 1);
+
+    memcpy(destination, source + 1, sizeof(double) * length);
+    coefficients_add(destination, source, length - 1);
+    memcpy(result, destination, sizeof(double) * length);
+
+    coefficients_axpy(destination, -0.7, source, length - 1);
+    memcpy(result + TEST_KERNELS_LENGTH, destination, sizeof(double) * length);
+
+    coefficients_scale(destination, length - 1, 1.3);
+    memcpy(result + 2 * TEST_KERNELS_LENGTH, destination, sizeof(double) * length);
+
+    coefficients_derivative(source, length - 1, result + 3 * TEST_KERNELS_LENGTH);
+
+    long count = coefficients_compact(source, length - 1, 0.0001, result + 4 * TEST_KERNELS_LENGTH, degrees);
+    int index;
+    for(index = 0; index < count; index++) {
+      result[5 * TEST_KERNELS_LENGTH + index] = degrees[index];
+    }
+
+    result[6 * TEST_KERNELS_LENGTH] = count;
+    result[6 * TEST_KERNELS_LENGTH + 1] = coefficients_degree(source, length - 1, 0.0001);
+  }
+}
+
+/*
+ * 1 if polynomial_taylor_shift matches the O(n^2) Horner scheme on these coefficients,
+ * each one up to 1e-12 times the same coefficient shifted with absolute values, the scale of its rounding errors
+ */
+static int taylor_shift_matches_horner(const double *coefficients, long degree, double shift) {
+  double *expected = malloc(sizeof(double) * 3 * (degree + 1));
+  if(!expected) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * 3 * (degree + 1));
+    exit(EXIT_FAILURE);
+  }
+  double *scale = expected + degree + 1, *computed = expected + 2 * (degree + 1);
+
+  long step, index;
+  for(index = 0; index <= degree; index++) {
+    expected[index] = coefficients[index];
+    scale[index] = fabs(coefficients[index]);
+  }
+  for(step = 0; step < degree; step++) {
+    for(index = degree - 1; index >= step; index--) {
+      expected[index] += shift * expected[index + 1];
+      scale[index] += fabs(shift) * scale[index + 1];
+    }
+  }
+
+  Polynomial *polynomial = polynomial_create(coefficients, degree);
+  Polynomial *shifted = polynomial_taylor_shift(polynomial, shift);
+  memset(computed, 0, sizeof(double) * (degree + 1));
+  int same = polynomial_get_degree(shifted) == degree;
+  if(same) {
+    polynomial_get_coefficients(shifted, computed);
+  }
+
+  for(index = 0; index <= degree; index++) {
+    same = same && fabs(computed[index] - expected[index]) <= 0.0001 + 1e-12 * scale[index];
+  }
+
+  polynomial_free(&polynomial);
+  polynomial_free(&shifted);
+  free(expected);
+
+  return same;
+}
+
+// interrupts a file product after its third group of blocks
+static int interrupt_file_product(unsigned long long done, unsigned long long total, void *data) {
+  (void) done;
+  (void) total;
+  unsigned long long *calls = data;
+  (*calls)++;
+
+  return *calls < 3;
+}
+
+static int count_file_product(unsigned long long done, unsigned long long total, void *data) {
+  unsigned long long *last = data;
+  *last = (done == total) ? done : 0;
+
+  return 1;
+}
+
+// 1 if the coefficient file holds the product of left and right, up to the tolerance of null coefficients
+static int file_holds_product(const char *filename, const Polynomial *left, const Polynomial *right) {
+  Polynomial *file_product = polynomial_file_read(filename);
+  if(!file_product) {
+    return 0;
+  }
+
+  Polynomial *difference = polynomial_product(left, right);
+  polynomial_axpy(difference, -1, file_product);
+  int same = polynomial_get_number_of_monomials(difference) == 0;
+
+  polynomial_free(&difference);
+  polynomial_free(&file_product);
+
+  return same;
+}
+
+// writes a coefficient file of header size bytes, whose degree is all ones
+static void write_file_header(const char *filename, size_t size) {
+  unsigned char header[16] = "PLYCOEF1";
+  memset(header + 8, 0xff, 8);
+
+  FILE *file = fopen(filename, "wb");
+  if(!file || fwrite(header, 1, size, file) != size || fclose(file) != 0) {
+    fprintf(stderr, "Error in %s!\nExiting\n", filename);
+    exit(EXIT_FAILURE);
+  }
+}
+
+// reads a binary batch made of a header claiming these counts, then a single polynomial of one coefficient
+static int read_binary_header(unsigned long long polynomials, unsigned long long coefficients) {
+  FILE *file = tmpfile();
+  if(!file) {
+    fprintf(stderr, "Error in a temporary file!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned long long header[3] = { polynomials, coefficients, 1 };
+  double coefficient = 1.0;
+  fwrite("PLYBATC1", 1, 8, file);
+  fwrite(header, sizeof(unsigned long long), 3, file);
+  fwrite(&coefficient, sizeof(double), 1, file);
+  rewind(file);
+
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  PolynomialBatch *batch = polynomial_batch_create_from_binary_stream(file);
+  fclose(file);
+
+  int accepted = batch != NULL;
+  if(batch) {
+    polynomial_batch_free(&batch);
+  } else {
+    accepted = polynomials_errno == POLYNOMIAL_INPUT_ERROR ? 0 : -1;
+  }
+
+  return accepted;
+}
+
+
 void polynomial_tests_run(void) {
 
   printf("\n==========CREATE FROM STRINGS==========\n");
@@ -59,6 +277,16 @@ void polynomial_tests_run(void) {
   printf("P%d = ", NUMBER_OF_TEST_POLYNOMIALS - 1);
   polynomial_print(polynomials[index], 1);
 
+  printf("\n==========DEGREES==========\n");
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    printf(
+      "deg(P%d) = %ld, leading coefficient %.2lf\n",
+      index,
+      polynomial_get_degree(polynomials[index]),
+      polynomial_get_leading_coefficient(polynomials[index])
+    );
+  }
+
   printf("\n==========COMPUTATIONS WITH X=%d==========\n", TEST_X);
   for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
     polynomials_errno = POLYNOMIAL_SUCCESS;
@@ -69,6 +297,28 @@ void polynomial_tests_run(void) {
     dump_polynomials_errno();
   }
 
+  printf("\n==========EXACT COMPUTATIONS==========\n");
+  {
+    long long exact_points[] = {TEST_X, -1000000, 3000000000LL};
+
+    unsigned int index_point;
+    for(index_point = 0; index_point < sizeof(exact_points) / sizeof(*exact_points); index_point++) {
+      for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+        PolynomialExactValue exact;
+        const char *status_names[] = {"int64", "int128", "multilimb", "not integral"};
+
+        POLYNOMIAL_EXACT_STATUS status = polynomial_compute_exact(polynomials[index], exact_points[index_point], &exact);
+        printf("P%d(%lld) = ", index, exact_points[index_point]);
+        if(status != POLYNOMIAL_EXACT_NOT_INTEGRAL) {
+          polynomial_exact_value_print(&exact, 0);
+        }
+        printf(" (%s)\n", status_names[status]);
+
+        polynomial_exact_value_free(&exact);
+      }
+    }
+  }
+
   printf("\n==========DERIVATIVES==========\n");
   for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
     polynomials_errno = POLYNOMIAL_SUCCESS;
@@ -81,6 +331,59 @@ void polynomial_tests_run(void) {
     dump_polynomials_errno();
   }
 
+  printf("\n==========DERIVATIVES COMPUTED WITH X=%d==========\n", TEST_X);
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    double values[TEST_DERIVATIVES];
+    polynomial_compute_derivatives(polynomials[index], TEST_X, values, TEST_DERIVATIVES);
+
+    printf("P%d(%d), P%d'(%d)... = ", index, TEST_X, index, TEST_X);
+
+    int index_derivative;
+    for(index_derivative = 0; index_derivative < TEST_DERIVATIVES; index_derivative++) {
+      printf("%.2lf ", values[index_derivative]);
+    }
+    printf("\n");
+  }
+
+  {
+    double points[] = {-1, 0, 0.5, TEST_X, 10};
+    unsigned long number_of_points = sizeof(points) / sizeof(*points);
+    double values[sizeof(points) / sizeof(*points) * TEST_DERIVATIVES];
+
+    for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+      polynomial_compute_derivatives_batch(polynomials[index], points, number_of_points, values, TEST_DERIVATIVES);
+
+      printf("P%d batch =", index);
+
+      unsigned long index_value;
+      for(index_value = 0; index_value < number_of_points * TEST_DERIVATIVES; index_value++) {
+        printf(" %.2lf", values[index_value]);
+      }
+      printf("\n");
+    }
+  }
+
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    double complex values[TEST_DERIVATIVES];
+    polynomial_compute_derivatives_complex(polynomials[index], I, values, TEST_DERIVATIVES);
+
+    printf("P%d(i), P%d'(i)... = ", index, index);
+
+    int index_derivative;
+    for(index_derivative = 0; index_derivative < TEST_DERIVATIVES; index_derivative++) {
+      printf("%.2lf%+.2lfi ", creal(values[index_derivative]), cimag(values[index_derivative]));
+    }
+    printf("\n");
+  }
+
+  {
+    double untouched[1] = { -1 };
+    double points[] = { TEST_X };
+    polynomial_compute_derivatives(polynomials[0], TEST_X, untouched, 0);
+    polynomial_compute_derivatives_batch(polynomials[0], points, 1, untouched, 0);
+    printf("no derivative asked: values %s\n", untouched[0] == -1 ? "untouched" : "written");
+  }
+
   printf("\n==========SUMS==========\n");
   for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS / 2; index++) {
     polynomials_errno = POLYNOMIAL_SUCCESS;
@@ -107,6 +410,91 @@ void polynomial_tests_run(void) {
     dump_polynomials_errno();
   }
 
+  printf("\n==========SPARSE PRODUCTS==========\n");
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS / 2; index++) {
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+
+    printf("P%d * P%d = ", index, (index + (NUMBER_OF_TEST_POLYNOMIALS / 2)));
+
+    Polynomial *product = polynomial_product_sparse(polynomials[index], polynomials[index + (NUMBER_OF_TEST_POLYNOMIALS / 2)]);
+    polynomial_print(product, 1);
+    polynomial_free(&product);
+
+    dump_polynomials_errno();
+  }
+
+  {
+    char sparse_left_string[] = "x^1000000 + 3x^500 - 1";
+    char sparse_right_string[] = "2x^1500000 + x^500 + 1";
+    Polynomial *sparse_left = polynomial_create_from_string(sparse_left_string);
+    Polynomial *sparse_right = polynomial_create_from_string(sparse_right_string);
+
+    printf("(%s) * (%s) = ", sparse_left_string, sparse_right_string);
+    Polynomial *product = polynomial_product(sparse_left, sparse_right);
+    polynomial_print(product, 1);
+
+    polynomial_free(&product);
+    polynomial_free(&sparse_left);
+    polynomial_free(&sparse_right);
+  }
+
+  printf("\n==========IN PLACE==========\n");
+  {
+    Polynomial *accumulator = polynomial_copy(polynomials[0]);
+    for(index = 1; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+      polynomial_add_into(accumulator, polynomials[index]);
+    }
+
+    printf("P0 + P1 + ... = ");
+    polynomial_print(accumulator, 1);
+
+    polynomial_axpy(accumulator, -TEST_SCALE, polynomials[0]);
+    printf("P0 + P1 + ... - %d * P0 = ", TEST_SCALE);
+    polynomial_print(accumulator, 1);
+
+    polynomial_mul_into(accumulator, polynomials[0], polynomials[NUMBER_OF_TEST_POLYNOMIALS / 2]);
+    printf("P0 * P%d = ", NUMBER_OF_TEST_POLYNOMIALS / 2);
+    polynomial_print(accumulator, 1);
+
+    polynomial_mul_into(accumulator, accumulator, accumulator);
+    printf("(P0 * P%d)^2 = ", NUMBER_OF_TEST_POLYNOMIALS / 2);
+    polynomial_print(accumulator, 1);
+
+    polynomial_derivative_in_place(accumulator);
+    printf("((P0 * P%d)^2)' = ", NUMBER_OF_TEST_POLYNOMIALS / 2);
+    polynomial_print(accumulator, 1);
+
+    polynomial_scale(accumulator, 0.5);
+    polynomial_reduct_in_place(accumulator);
+    printf("((P0 * P%d)^2)' / 2 = ", NUMBER_OF_TEST_POLYNOMIALS / 2);
+    polynomial_print(accumulator, 1);
+
+    polynomial_axpy(accumulator, -1, accumulator);
+    printf("0 = ");
+    polynomial_print(accumulator, 1);
+
+    polynomial_free(&accumulator);
+  }
+
+  printf("\n==========COPIES==========\n");
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    Polynomial *copy = polynomial_copy(polynomials[index]);
+    Polynomial *copy_of_copy = polynomial_copy(copy);
+
+    // modifying a copy must leave the others untouched
+    polynomial_scale(copy, TEST_SCALE);
+
+    printf("P%d = ", index);
+    polynomial_print(polynomials[index], 0);
+    printf(", %d * P%d = ", TEST_SCALE, index);
+    polynomial_print(copy, 0);
+    printf(", copy = ");
+    polynomial_print(copy_of_copy, 1);
+
+    polynomial_free(&copy);
+    polynomial_free(&copy_of_copy);
+  }
+
   printf("\n==========POWERS of %d==========\n", TEST_POWER);
   for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
     Polynomial *powered = polynomial_power(polynomials[index], TEST_POWER);
@@ -116,6 +504,176 @@ void polynomial_tests_run(void) {
     polynomial_free(&powered);
   }
 
+  printf("\n==========TAYLOR SHIFTS by %d==========\n", TEST_SHIFT);
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    Polynomial *shifted = polynomial_taylor_shift(polynomials[index], TEST_SHIFT);
+
+    printf("P%d(x + %d) = ", index, TEST_SHIFT);
+    polynomial_print(shifted, 1);
+    polynomial_free(&shifted);
+  }
+
+  // past the degree of the Horner scheme, with small coefficients and with integral ones
+  double shift_coefficients[TEST_SHIFT_DEGREE + 1];
+  long shift_degrees[] = { 64, TEST_SHIFT_DEGREE };
+  int shift_degree;
+  for(shift_degree = 0; shift_degree < 2; shift_degree++) {
+    long degree = shift_degrees[shift_degree], coefficient;
+    for(coefficient = 0; coefficient <= degree; coefficient++) {
+      shift_coefficients[coefficient] = sin(1.3 * coefficient + 0.4);
+    }
+    printf("degree %ld in [-1, 1] same as Horner: %s", degree, taylor_shift_matches_horner(shift_coefficients, degree, TEST_SHIFT) ? "yes" : "no");
+
+    for(coefficient = 0; coefficient <= degree; coefficient++) {
+      shift_coefficients[coefficient] = (coefficient % 7) - 3;
+    }
+    printf(", integral same as Horner: %s\n", taylor_shift_matches_horner(shift_coefficients, degree, TEST_SHIFT) ? "yes" : "no");
+  }
+
+  printf("\n==========VARIABLE SCALINGS by %d==========\n", TEST_SCALE);
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    Polynomial *scaled = polynomial_copy(polynomials[index]);
+    polynomial_scale_variable(scaled, TEST_SCALE);
+
+    printf("P%d(%dx) = ", index, TEST_SCALE);
+    polynomial_print(scaled, 1);
+    polynomial_free(&scaled);
+  }
+
+  printf("\n==========COMPOSITIONS==========\n");
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS / 2; index++) {
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+
+    printf("P%d(P%d) = ", index, (index + (NUMBER_OF_TEST_POLYNOMIALS / 2)));
+
+    Polynomial *composed = polynomial_compose(polynomials[index], polynomials[index + (NUMBER_OF_TEST_POLYNOMIALS / 2)]);
+    polynomial_print(composed, 1);
+    polynomial_free(&composed);
+
+    dump_polynomials_errno();
+  }
+
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS / 2; index++) {
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+
+    printf("P%d(P%d) mod P%d = ", index, (index + (NUMBER_OF_TEST_POLYNOMIALS / 2)), NUMBER_OF_TEST_POLYNOMIALS - 1);
+
+    Polynomial *composed = polynomial_compose_modulo(
+      polynomials[index],
+      polynomials[index + (NUMBER_OF_TEST_POLYNOMIALS / 2)],
+      polynomials[NUMBER_OF_TEST_POLYNOMIALS - 1]
+    );
+    polynomial_print(composed, 1);
+    polynomial_free(&composed);
+
+    dump_polynomials_errno();
+  }
+
+  printf("\n==========POWER SERIES mod x^%d==========\n", TEST_ORDER);
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS / 2; index++) {
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+
+    printf("P%d * P%d = ", index, (index + (NUMBER_OF_TEST_POLYNOMIALS / 2)));
+
+    Polynomial *product = polynomial_series_product(polynomials[index], polynomials[index + (NUMBER_OF_TEST_POLYNOMIALS / 2)], TEST_ORDER);
+    polynomial_print(product, 1);
+    polynomial_free(&product);
+
+    dump_polynomials_errno();
+  }
+
+  for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+    Polynomial *powered = polynomial_power_truncated(polynomials[index], TEST_POWER, TEST_ORDER);
+
+    printf("P%d^%d = ", index, TEST_POWER);
+    polynomial_print(powered, 1);
+    polynomial_free(&powered);
+  }
+
+  {
+    double cubed_coefficients[TEST_EXACT_POWER_DEGREE + 1];
+    for(index = 0; index <= TEST_EXACT_POWER_DEGREE; index++) {
+      cubed_coefficients[index] = (double) ((index * 5) % 11) - 5.0;
+    }
+    cubed_coefficients[TEST_EXACT_POWER_DEGREE] = 3.0;
+
+    Polynomial *cubed_base = polynomial_create(cubed_coefficients, TEST_EXACT_POWER_DEGREE);
+    Polynomial *cubed = polynomial_power(cubed_base, 3);
+    Polynomial *squared = polynomial_product(cubed_base, cubed_base);
+    Polynomial *expected_cubed = polynomial_product(squared, cubed_base);
+
+    printf("integral polynomial of degree %d cubed, same as successive products: %s\n", TEST_EXACT_POWER_DEGREE,
+      polynomial_equals(cubed, expected_cubed) ? "yes" : "no");
+
+    polynomial_free(&cubed_base);
+    polynomial_free(&cubed);
+    polynomial_free(&squared);
+    polynomial_free(&expected_cubed);
+
+    char sparse_string[] = "x^1000000 + 1";
+    Polynomial *sparse_base = polynomial_create_from_string(sparse_string);
+    Polynomial *sparse_power = polynomial_power(sparse_base, 4);
+
+    printf("(%s)^4 = ", sparse_string);
+    polynomial_print(sparse_power, 1);
+
+    polynomial_free(&sparse_base);
+    polynomial_free(&sparse_power);
+  }
+
+  {
+    // big enough for the FFT, with an odd order so that the halves differ
+    double low_coefficients[2 * TEST_LOW_PRODUCT_DEGREE + 2];
+    double low_product[2 * TEST_LOW_PRODUCT_DEGREE + 1];
+    double low_truncated[2 * TEST_LOW_PRODUCT_DEGREE + 1];
+    for(index = 0; index < 2 * TEST_LOW_PRODUCT_DEGREE + 2; index++) {
+      low_coefficients[index] = sin((double) index) * 3.0;
+    }
+
+    coefficients_product(low_coefficients, TEST_LOW_PRODUCT_DEGREE, low_coefficients + TEST_LOW_PRODUCT_DEGREE + 1, TEST_LOW_PRODUCT_DEGREE, low_product);
+
+    long low_order;
+    double low_error = 0;
+    for(low_order = TEST_LOW_PRODUCT_DEGREE - 17; low_order <= 2 * TEST_LOW_PRODUCT_DEGREE + 1; low_order += 59) {
+      coefficients_product_low(low_coefficients, TEST_LOW_PRODUCT_DEGREE, low_coefficients + TEST_LOW_PRODUCT_DEGREE + 1, TEST_LOW_PRODUCT_DEGREE, low_truncated, low_order);
+      long low_index;
+      for(low_index = 0; low_index < low_order && low_index <= 2 * TEST_LOW_PRODUCT_DEGREE; low_index++) {
+        double error = fabs(low_truncated[low_index] - low_product[low_index]);
+        low_error = (error > low_error) ? error : low_error;
+      }
+    }
+    printf("truncated products of degree %d, same as full products: %s\n", TEST_LOW_PRODUCT_DEGREE, low_error < 1e-10 ? "yes" : "no");
+  }
+
+  {
+    Polynomial* (*series_functions[])(const Polynomial*, long) = {
+      polynomial_series_inverse,
+      polynomial_series_sqrt,
+      polynomial_series_log,
+      polynomial_series_exp
+    };
+    const char *series_names[] = {"1 / ", "sqrt", "log", "exp"};
+
+    unsigned int index_function;
+    for(index_function = 0; index_function < sizeof(series_functions) / sizeof(*series_functions); index_function++) {
+      for(index = 0; index < NUMBER_OF_TEST_POLYNOMIALS; index++) {
+        polynomials_errno = POLYNOMIAL_SUCCESS;
+
+        printf("%s(P%d) = ", series_names[index_function], index);
+
+        Polynomial *series = series_functions[index_function](polynomials[index], TEST_ORDER);
+        if(series != NULL) {
+          polynomial_print(series, 1);
+          polynomial_free(&series);
+        } else {
+          printf("\n");
+        }
+
+        dump_polynomials_errno();
+      }
+    }
+  }
+
   printf("\n==========WRITING TO FILE==========\n");
   printf(
     polynomial_write_to_file((const Polynomial **)polynomials, NUMBER_OF_TEST_POLYNOMIALS, "saved.txt") ?
@@ -141,4 +699,767 @@ void polynomial_tests_run(void) {
   }
 
   free(file_polynomials);
+
+  printf("\n==========BATCH FROM FILE==========\n");
+  PolynomialBatch *batch = polynomial_batch_create_from_file("saved.txt");
+  if(!batch) {
+    fprintf(stderr, "Error in file 'saved.txt'!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned long batch_length = polynomial_batch_get_length(batch);
+  unsigned long batch_index;
+  for(batch_index = 0; batch_index < batch_length; batch_index++) {
+    Polynomial *batchp = polynomial_batch_get(batch, batch_index);
+    printf("P%lu (degree %ld) = ", batch_index, polynomial_batch_get_degree(batch, batch_index));
+    polynomial_print(batchp, 1);
+    polynomial_free(&batchp);
+  }
+
+  printf("\n==========BATCH COMPUTATIONS WITH X==========\n");
+  double batch_values[NUMBER_OF_TEST_POLYNOMIALS * 4];
+  polynomial_batch_compute(batch, TEST_X, batch_values);
+  for(batch_index = 0; batch_index < batch_length; batch_index++) {
+    printf("P%lu(%d) = %.2lf\n", batch_index, TEST_X, batch_values[batch_index]);
+  }
+
+  printf("\n==========BATCH COMPUTATIONS WITH POINTS==========\n");
+  const double batch_points[4] = { -1., 0., 0.5, 2. };
+  polynomial_batch_compute_points(batch, batch_points, 4, batch_values);
+  for(batch_index = 0; batch_index < batch_length; batch_index++) {
+    printf("P%lu(-1, 0, 0.5, 2) = %.2lf, %.2lf, %.2lf, %.2lf\n",
+      batch_index,
+      batch_values[batch_index * 4], batch_values[batch_index * 4 + 1],
+      batch_values[batch_index * 4 + 2], batch_values[batch_index * 4 + 3]
+    );
+  }
+
+  printf("\n==========BATCH SUM==========\n");
+  Polynomial *batch_sum = polynomial_batch_sum(batch);
+  printf("P0 + ... + P%lu = ", batch_length - 1);
+  polynomial_print(batch_sum, 1);
+  polynomial_free(&batch_sum);
+
+  printf("\n==========BATCH DERIVATIVES==========\n");
+  PolynomialBatch *batch_derivatives = polynomial_batch_derivative(batch);
+  for(batch_index = 0; batch_index < batch_length; batch_index++) {
+    Polynomial *derivative = polynomial_batch_get(batch_derivatives, batch_index);
+    printf("P%lu' = ", batch_index);
+    polynomial_print(derivative, 1);
+    polynomial_free(&derivative);
+  }
+  polynomial_batch_free(&batch_derivatives);
+
+  printf("\n==========BATCH WRITING TO FILE==========\n");
+  printf(polynomial_batch_write_to_file(batch, "saved.txt") ? "successful\n" : "failure\n");
+  polynomial_batch_free(&batch);
+
+  printf("well-formed binary header: %s\n", read_binary_header(1, 1) == 1 ? "accepted" : "rejected");
+  printf("header with 2^61 polynomials: %s\n", read_binary_header(1ULL << 61, 1ULL << 61) == 0 ? "rejected" : "accepted");
+  printf("header with 2^40 coefficients: %s\n", read_binary_header(1, 1ULL << 40) == 0 ? "rejected" : "accepted");
+  printf("header with more polynomials than coefficients: %s\n", read_binary_header(2, 1) == 0 ? "rejected" : "accepted");
+
+  printf("\n==========PIPELINE==========\n");
+  // fewer lines in flight than lines in the file, so that the reader has to wait for the writer
+  PolynomialPipelineOptions pipeline_options = { POLYNOMIAL_PIPELINE_DERIVATIVE, 0, 2, 3, NULL, NULL };
+  run_pipeline("derivatives", &pipeline_options);
+
+  pipeline_options.operation = POLYNOMIAL_PIPELINE_POWER;
+  pipeline_options.parameter = TEST_POWER;
+  run_pipeline("powers", &pipeline_options);
+
+  pipeline_options.operation = POLYNOMIAL_PIPELINE_COMPUTE;
+  pipeline_options.parameter = TEST_X;
+  run_pipeline("computations", &pipeline_options);
+
+  pipeline_options.operation = POLYNOMIAL_PIPELINE_POWER;
+  pipeline_options.parameter = 0;
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  run_pipeline("power 0", &pipeline_options);
+  printf("power 0 rejected as an input error: %s\n", polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "yes" : "no");
+
+  // an empty line for the first one, which looks empty
+  FILE *nul_input = tmpfile();
+  if(!nul_input || fwrite("\0x\nx^2\n", 1, 7, nul_input) != 7) {
+    fprintf(stderr, "Error in a temporary file!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+  rewind(nul_input);
+  pipeline_options.operation = POLYNOMIAL_PIPELINE_DERIVATIVE;
+  run_pipeline_on("line starting with a NUL byte", nul_input, &pipeline_options);
+  fclose(nul_input);
+
+  printf("\n==========BATCH IN PARALLEL==========\n");
+  // big enough to be shared between threads, the results must not depend on their number
+  batch = polynomial_batch_create();
+  double batch_coefficients[TEST_BATCH_DEGREE + 1];
+  for(batch_index = 0; batch_index < TEST_BATCH_LENGTH; batch_index++) {
+    int degree;
+    for(degree = 0; degree <= TEST_BATCH_DEGREE; degree++) {
+      batch_coefficients[degree] = (double) ((batch_index + degree) % 7) - 3.;
+    }
+
+    Polynomial *batchp = polynomial_create(batch_coefficients, batch_index % (TEST_BATCH_DEGREE + 1));
+    polynomial_batch_append(batch, batchp);
+    polynomial_free(&batchp);
+  }
+
+  double *sequential_values = malloc(sizeof(double) * TEST_BATCH_LENGTH);
+  double *parallel_values = malloc(sizeof(double) * TEST_BATCH_LENGTH);
+  if(!sequential_values || !parallel_values) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * TEST_BATCH_LENGTH);
+    exit(EXIT_FAILURE);
+  }
+
+  polynomial_batch_set_threads(1);
+  polynomial_batch_compute(batch, 0.99, sequential_values);
+  Polynomial *sequential_sum = polynomial_batch_sum(batch);
+
+  polynomial_batch_set_threads(4);
+  polynomial_batch_compute(batch, 0.99, parallel_values);
+  Polynomial *parallel_sum = polynomial_batch_sum(batch);
+  polynomial_batch_set_threads(0);
+
+  int identical = 1;
+  for(batch_index = 0; batch_index < TEST_BATCH_LENGTH; batch_index++) {
+    identical = identical && (sequential_values[batch_index] == parallel_values[batch_index]);
+  }
+  printf("%d polynomials computed with 1 and 4 threads: %s\n", TEST_BATCH_LENGTH, identical ? "identical" : "different");
+
+  printf("sum with 1 thread = ");
+  polynomial_print(sequential_sum, 1);
+  printf("sum with 4 threads = ");
+  polynomial_print(parallel_sum, 1);
+
+  polynomial_free(&sequential_sum);
+  polynomial_free(&parallel_sum);
+  free(sequential_values);
+  free(parallel_values);
+  polynomial_batch_free(&batch);
+
+  printf("\n==========CACHE==========\n");
+  double cache_coefficients[] = { 1, 1, 0, 2 };
+  Polynomial *cachep = polynomial_create(cache_coefficients, 1);
+  Polynomial *cacheq = polynomial_create(cache_coefficients, 3);
+
+  PolynomialCache *cache = polynomial_cache_create(1024 * 1024);
+  PolynomialCacheStatistics cache_statistics;
+
+  // the second product is the first one, with its operands swapped
+  Polynomial *cached = polynomial_cache_product(cache, cachep, cacheq);
+  polynomial_free(&cached);
+  cached = polynomial_cache_product(cache, cacheq, cachep);
+  polynomial_print(cachep, 0);
+  printf(" * ");
+  polynomial_print(cacheq, 0);
+  printf(" = ");
+  polynomial_print(cached, 1);
+  polynomial_free(&cached);
+
+  // each power starts from the previous one
+  int cache_power;
+  for(cache_power = 1; cache_power <= TEST_CACHE_POWERS; cache_power++) {
+    cached = polynomial_cache_power(cache, cachep, cache_power);
+    polynomial_print(cachep, 0);
+    printf("^%d = ", cache_power);
+    polynomial_print(cached, 1);
+    polynomial_free(&cached);
+  }
+
+  cached = polynomial_cache_derivative(cache, cacheq);
+  polynomial_free(&cached);
+  cached = polynomial_cache_derivative(cache, cacheq);
+  printf("derivative of ");
+  polynomial_print(cacheq, 0);
+  printf(" = ");
+  polynomial_print(cached, 1);
+  polynomial_free(&cached);
+
+  polynomial_cache_get_statistics(cache, &cache_statistics);
+  printf("%lu hits, %lu misses, %lu evictions, %lu results cached\n",
+    cache_statistics.hits, cache_statistics.misses, cache_statistics.evictions, cache_statistics.entries);
+  polynomial_cache_free(&cache);
+
+  // too small for more than a few results: the oldest ones are evicted
+  cache = polynomial_cache_create(1024);
+  for(cache_power = 1; cache_power <= TEST_CACHE_POWERS; cache_power++) {
+    cached = polynomial_cache_power(cache, cacheq, cache_power);
+    polynomial_free(&cached);
+  }
+  polynomial_cache_get_statistics(cache, &cache_statistics);
+  printf("with a limit of %zu bytes: %zu bytes used, %lu evictions\n",
+    cache_statistics.memory_limit, cache_statistics.memory, cache_statistics.evictions);
+  polynomial_cache_free(&cache);
+
+  polynomial_free(&cachep);
+  polynomial_free(&cacheq);
+
+  printf("\n==========HASHING==========\n");
+  // the same polynomial, computed two ways, and two close ones
+  double linear_coefficients[] = { 1, 1 };
+  double hash_coefficients[] = { 1, 2, 1 };
+  double close_coefficients[] = { 1.00001, 2, 1 };
+  double other_coefficients[] = { 2, 2, 1 };
+  Polynomial *linear = polynomial_create(linear_coefficients, 1);
+  Polynomial *hashp = polynomial_create(hash_coefficients, 2);
+  Polynomial *squared = polynomial_product(linear, linear);
+  Polynomial *close = polynomial_create(close_coefficients, 2);
+  Polynomial *other = polynomial_create(other_coefficients, 2);
+  Polynomial *big = polynomial_power(linear, TEST_HASH_POWER);
+
+  printf("(1 + x)^2 and 1 + 2x + x^2: %s hashes\n",
+    polynomial_hash(hashp) == polynomial_hash(squared) ? "same" : "different");
+  printf("1 + 2x + x^2 and 1.00001 + 2x + x^2: %s hashes, %s hashes with tolerance 0.001\n",
+    polynomial_hash(hashp) == polynomial_hash(close) ? "same" : "different",
+    polynomial_hash_with_tolerance(hashp, 0.001) == polynomial_hash_with_tolerance(close, 0.001) ? "same" : "different");
+
+  unsigned long long point = polynomial_fingerprint_random_point();
+  unsigned long long fingerprints[4];
+  polynomial_fingerprint(hashp, point, &fingerprints[0]);
+  polynomial_fingerprint(squared, point, &fingerprints[1]);
+  polynomial_fingerprint(other, point, &fingerprints[2]);
+  printf("fingerprints of (1 + x)^2 and 1 + 2x + x^2: %s\n", fingerprints[0] == fingerprints[1] ? "same" : "different");
+  printf("fingerprints of 1 + 2x + x^2 and 2 + 2x + x^2: %s\n", fingerprints[0] == fingerprints[2] ? "same" : "different");
+  printf("fingerprint of 1.00001 + 2x + x^2: %s\n", polynomial_fingerprint(close, point, &fingerprints[3]) ? "computed" : "not integral");
+
+  const Polynomial *hashed[] = { hashp, squared, close, other, big };
+  PolynomialBatch *hash_batch = polynomial_batch_create_from_polynomials(hashed, 5);
+  unsigned long long batch_hashes[5];
+  polynomial_batch_hash(hash_batch, 0, batch_hashes);
+  int same_hashes = 1;
+  for(batch_index = 0; batch_index < 5; batch_index++) {
+    same_hashes = same_hashes && (batch_hashes[batch_index] == polynomial_hash(hashed[batch_index]));
+  }
+  printf("hashes in and out of a batch: %s\n", same_hashes ? "same" : "different");
+
+  unsigned long long batch_fingerprints[5];
+  printf("fingerprints of the batch: %s\n", polynomial_batch_fingerprint(hash_batch, point, batch_fingerprints) ? "computed" : "not integral");
+
+  // integral polynomials only, one of them wide enough for the FFT products
+  Polynomial *half = polynomial_power(linear, TEST_HASH_WIDE_POWER / 2);
+  Polynomial *wide = polynomial_product(half, half);
+  Polynomial *wide_power = polynomial_power(linear, TEST_HASH_WIDE_POWER);
+  const Polynomial *integral_hashed[] = { hashp, squared, other, big, wide };
+  PolynomialBatch *integral_batch = polynomial_batch_create_from_polynomials(integral_hashed, 5);
+  int integral_computed = polynomial_batch_fingerprint(integral_batch, point, batch_fingerprints);
+  int same_fingerprints = integral_computed;
+  for(batch_index = 0; integral_computed && batch_index < 5; batch_index++) {
+    same_fingerprints = same_fingerprints && polynomial_fingerprint(integral_hashed[batch_index], point, &fingerprints[0])
+      && fingerprints[0] == batch_fingerprints[batch_index];
+  }
+  printf("fingerprints of an integral batch: %s, %s in and out of the batch\n",
+    integral_computed ? "computed" : "not integral", same_fingerprints ? "same" : "different");
+  polynomial_fingerprint(wide_power, point, &fingerprints[1]);
+  printf("fingerprints of (1 + x)^%d and its two halves multiplied: %s\n", TEST_HASH_WIDE_POWER,
+    fingerprints[1] == batch_fingerprints[4] ? "same" : "different");
+  polynomial_batch_free(&integral_batch);
+  polynomial_free(&half);
+  polynomial_free(&wide);
+  polynomial_free(&wide_power);
+
+  PolynomialBatch *unique = polynomial_batch_unique(hash_batch, 0);
+  printf("%lu polynomials, %lu different ones, ", polynomial_batch_get_length(hash_batch), polynomial_batch_get_length(unique));
+  polynomial_batch_free(&unique);
+  unique = polynomial_batch_unique(hash_batch, 0.001);
+  printf("%lu with tolerance 0.001\n", polynomial_batch_get_length(unique));
+  polynomial_batch_free(&unique);
+  polynomial_batch_free(&hash_batch);
+
+  polynomial_free(&hashp);
+  polynomial_free(&squared);
+  polynomial_free(&close);
+  polynomial_free(&other);
+  polynomial_free(&big);
+  polynomial_free(&linear);
+
+  printf("\n==========PARSED EXPRESSIONS==========\n");
+  const char *expression_string = "(x+1)^3 * (x-2) + 5(x^2-1) - (1 + x)^3";
+  PolynomialExpression *expression = polynomial_expression_create_from_string(expression_string);
+  // x, 1, x + 1, (x + 1)^3, 2, x - 2, their product, 5, x^2, x^2 - 1, its product by 5, the sum and the difference
+  printf("%s: %lu nodes\n", expression_string, polynomial_expression_get_number_of_nodes(expression));
+
+  double expression_points[] = { -1, 0, 0.5, 2, 3 };
+  double expression_values[5];
+  polynomial_expression_compute_points(expression, expression_points, 5, expression_values);
+
+  Polynomial *expanded = polynomial_expression_expand(expression);
+  printf("expanded: ");
+  polynomial_print(expanded, 1);
+
+  double expanded_values[5];
+  polynomial_compute_derivatives_batch(expanded, expression_points, 5, expanded_values, 1);
+  for(index = 0; index < 5; index++) {
+    printf("x = %g: %g, expanded %g\n", expression_points[index], expression_values[index], expanded_values[index]);
+  }
+  printf("x = 3 alone: %g\n", polynomial_expression_compute(expression, 3));
+
+  polynomial_free(&expanded);
+  polynomial_expression_free(&expression);
+
+  const char *malformed_expressions[] = { "(x + 1", "x^", "2 +", "x^-1", "x^2^3", "2 3", "" };
+  for(index = 0; index < 7; index++) {
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+    expression = polynomial_expression_create_from_string(malformed_expressions[index]);
+    printf("\"%s\": %s\n", malformed_expressions[index],
+      expression == NULL && polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "rejected" : "accepted");
+    if(expression != NULL) {
+      polynomial_expression_free(&expression);
+    }
+  }
+
+  printf("\n==========CHEBYSHEV BASIS==========\n");
+  // exp on [0, 3], interpolated at the Chebyshev nodes, then computed in double at points in between
+  double chebyshev_nodes[TEST_CHEBYSHEV_DEGREE + 1];
+  polynomial_chebyshev_nodes(TEST_CHEBYSHEV_DEGREE, 0, 3, chebyshev_nodes);
+  for(index = 0; index <= TEST_CHEBYSHEV_DEGREE; index++) {
+    chebyshev_nodes[index] = exp(chebyshev_nodes[index]);
+  }
+  PolynomialChebyshev *chebyshev = polynomial_chebyshev_interpolate(chebyshev_nodes, TEST_CHEBYSHEV_DEGREE, 0, 3);
+
+  double *chebyshev_points = malloc(sizeof(double) * TEST_CHEBYSHEV_POINTS);
+  double *chebyshev_values = malloc(sizeof(double) * TEST_CHEBYSHEV_POINTS);
+  if(!chebyshev_points || !chebyshev_values) {
+    fprintf(stderr, "Fatal error: couldn't allocate memory!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+  for(index = 0; index < TEST_CHEBYSHEV_POINTS; index++) {
+    chebyshev_points[index] = 3. * index / (TEST_CHEBYSHEV_POINTS - 1);
+  }
+  polynomial_chebyshev_compute_points(chebyshev, chebyshev_points, TEST_CHEBYSHEV_POINTS, chebyshev_values);
+
+  double chebyshev_error = 0;
+  for(index = 0; index < TEST_CHEBYSHEV_POINTS; index++) {
+    double error = fabs(chebyshev_values[index] - exp(chebyshev_points[index])) / exp(chebyshev_points[index]);
+    chebyshev_error = (error > chebyshev_error) ? error : chebyshev_error;
+  }
+  printf("exp on [0, 3], degree %ld: relative error %s 1e-14, exp(1) = %.15f\n", polynomial_chebyshev_get_degree(chebyshev),
+    chebyshev_error < 1e-14 ? "under" : "over", polynomial_chebyshev_compute(chebyshev, 1));
+
+  free(chebyshev_points);
+  free(chebyshev_values);
+  polynomial_chebyshev_free(&chebyshev);
+
+  // 1 + 2x + 3x^2 on [-1, 2], and back
+  double chebyshev_coefficients[] = { 1, 2, 3 };
+  Polynomial *monomials = polynomial_create(chebyshev_coefficients, 2);
+  chebyshev = polynomial_chebyshev_create_from_polynomial(monomials, -1, 2);
+  polynomial_chebyshev_get_coefficients(chebyshev, chebyshev_coefficients);
+  printf("1 + 2x + 3x^2 on [-1, 2]: %g T0 + %g T1 + %g T2, at x = 2: %g\n",
+    chebyshev_coefficients[0], chebyshev_coefficients[1], chebyshev_coefficients[2], polynomial_chebyshev_compute(chebyshev, 2));
+
+  Polynomial *back = polynomial_chebyshev_to_polynomial(chebyshev);
+  printf("back to monomials: ");
+  polynomial_print(back, 1);
+
+  polynomial_free(&monomials);
+  polynomial_free(&back);
+  polynomial_chebyshev_free(&chebyshev);
+
+  // over COEFFICIENTS_CHEBYSHEV_MAX_DEGREE, T_n has no monomial form in double, unless its coefficient is null
+  double *long_coefficients = calloc(TEST_CHEBYSHEV_LONG_DEGREE + 1, sizeof(double));
+  if(!long_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (TEST_CHEBYSHEV_LONG_DEGREE + 1));
+    exit(EXIT_FAILURE);
+  }
+  long_coefficients[0] = 1;
+  long_coefficients[2] = 1;
+  long_coefficients[TEST_CHEBYSHEV_LONG_DEGREE] = 1;
+
+  chebyshev = polynomial_chebyshev_create(long_coefficients, TEST_CHEBYSHEV_LONG_DEGREE, -1, 1);
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  back = polynomial_chebyshev_to_polynomial(chebyshev);
+  printf("T0 + T2 + T%d to monomials: %s\n", TEST_CHEBYSHEV_LONG_DEGREE,
+    back == NULL && polynomials_errno == POLYNOMIAL_MATH_ERROR ? "rejected" : "accepted");
+  polynomial_chebyshev_free(&chebyshev);
+
+  long_coefficients[TEST_CHEBYSHEV_LONG_DEGREE] = 0;
+  chebyshev = polynomial_chebyshev_create(long_coefficients, TEST_CHEBYSHEV_LONG_DEGREE, -1, 1);
+  back = polynomial_chebyshev_to_polynomial(chebyshev);
+  printf("T0 + T2 with null coefficients up to T%d: ", TEST_CHEBYSHEV_LONG_DEGREE);
+  polynomial_print(back, 1);
+  polynomial_free(&back);
+  polynomial_chebyshev_free(&chebyshev);
+  free(long_coefficients);
+
+  printf("\n==========COMPENSATED EVALUATION==========\n");
+  // (2x - 1)^11 near its root: its terms cancel out, and Horner's method in double only returns rounding errors
+  double halving_coefficients[] = { -1, 2 };
+  Polynomial *halving = polynomial_create(halving_coefficients, 1);
+  Polynomial *cancelling = polynomial_power(halving, 11);
+  double cancelling_points[] = { 0.25, 0.51, 0.75 };
+  const char *method_names[] = { "double", "compensated", "long double" };
+  POLYNOMIAL_COMPUTE_METHOD methods[] = { POLYNOMIAL_COMPUTE_DOUBLE, POLYNOMIAL_COMPUTE_COMPENSATED, POLYNOMIAL_COMPUTE_LONG_DOUBLE };
+
+  for(index = 0; index < 3; index++) {
+    double cancelling_values[3], cancelling_bounds[3], bound;
+    polynomial_compute_points(cancelling, cancelling_points, 3, cancelling_values, methods[index], cancelling_bounds);
+    double value = polynomial_compute_with_method(cancelling, 0.51, methods[index], &bound);
+    double error = fabs(value - pow(2 * 0.51 - 1, 11));
+
+    printf("%s: (2 * 0.51 - 1)^11 = %.3e, error %s its bound, %s points computed alone\n", method_names[index], value,
+      error <= bound ? "within" : "over", (value == cancelling_values[1] && bound == cancelling_bounds[1]) ? "same" : "different");
+  }
+
+  polynomial_set_compute_method(POLYNOMIAL_COMPUTE_COMPENSATED);
+  printf("with compensated Horner by default: P(3) = %Lg\n", polynomial_compute(cancelling, 3));
+  polynomial_set_compute_method(POLYNOMIAL_COMPUTE_DEFAULT);
+  printf("default method reset to long double: %s\n", polynomial_get_compute_method() == POLYNOMIAL_COMPUTE_LONG_DOUBLE ? "yes" : "no");
+
+  polynomial_free(&halving);
+  polynomial_free(&cancelling);
+
+  printf("\n==========MULTIVARIATE==========\n");
+  PolynomialMultivariate *multivariate_left = polynomial_multivariate_create_from_string("3x^2y - 2yz^3 + 1");
+  PolynomialMultivariate *multivariate_right = polynomial_multivariate_create_from_string("x + y - 1");
+  printf("3x^2y - 2yz^3 + 1 in graded order: ");
+  polynomial_multivariate_print(multivariate_left, 1);
+
+  PolynomialMultivariate *multivariate_product = polynomial_multivariate_product(multivariate_left, multivariate_right);
+  printf("times x + y - 1: ");
+  polynomial_multivariate_print(multivariate_product, 1);
+
+  PolynomialMultivariate *multivariate_partial = polynomial_multivariate_derivative(multivariate_product, 2);
+  printf("d/dz: ");
+  polynomial_multivariate_print(multivariate_partial, 1);
+
+  double multivariate_points[] = { 1, 2, 3, 0.5, -1, 2, 2, 0, 1 };
+  double multivariate_values[3];
+  polynomial_multivariate_compute_points(multivariate_product, multivariate_points, 3, multivariate_values);
+  for(index = 0; index < 3; index++) {
+    const double *point = multivariate_points + 3 * index;
+    printf("at (%g, %g, %g): %g, product of the values %g\n", point[0], point[1], point[2], multivariate_values[index],
+      polynomial_multivariate_compute(multivariate_left, point) * polynomial_multivariate_compute(multivariate_right, point));
+  }
+
+  PolynomialMultivariate *multivariate_high = polynomial_multivariate_create_from_string("x^100 + y");
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  PolynomialMultivariate *multivariate_overflow = polynomial_multivariate_product(multivariate_high, multivariate_high);
+  printf("(x^100 + y)^2: %s\n", multivariate_overflow == NULL && polynomials_errno == POLYNOMIAL_MATH_ERROR ? "exponent too big" : "computed");
+
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  printf("\"3x^2 q\": %s\n", polynomial_multivariate_create_from_string("3x^2 q") == NULL && polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "rejected" : "accepted");
+
+  polynomial_multivariate_free(&multivariate_left);
+  polynomial_multivariate_free(&multivariate_right);
+  polynomial_multivariate_free(&multivariate_product);
+  polynomial_multivariate_free(&multivariate_partial);
+  polynomial_multivariate_free(&multivariate_high);
+
+  printf("\n==========FLOAT STORAGE==========\n");
+  // the error of float storage and float accumulation stays below the documented bounds
+  batch = polynomial_batch_create();
+  for(batch_index = 0; batch_index < TEST_FLOAT_LENGTH; batch_index++) {
+    int degree;
+    for(degree = 0; degree <= TEST_BATCH_DEGREE; degree++) {
+      batch_coefficients[degree] = 1. / (1 + (batch_index * 7 + degree * 3) % 11) - 0.3;
+    }
+
+    Polynomial *batchp = polynomial_create(batch_coefficients, TEST_BATCH_DEGREE);
+    polynomial_batch_append(batch, batchp);
+    polynomial_free(&batchp);
+  }
+
+  PolynomialBatch *float_batch = polynomial_batch_convert(batch, POLYNOMIAL_BATCH_FLOAT);
+  printf("converted batch stored in float: %s\n", polynomial_batch_get_precision(float_batch) == POLYNOMIAL_BATCH_FLOAT ? "yes" : "no");
+
+  double float_points[TEST_FLOAT_POINTS];
+  float float_points_single[TEST_FLOAT_POINTS];
+  for(index = 0; index < TEST_FLOAT_POINTS; index++) {
+    float_points_single[index] = (float) (-1 + 2. * index / (TEST_FLOAT_POINTS - 1));
+    float_points[index] = float_points_single[index];
+  }
+
+  double double_values[TEST_FLOAT_LENGTH * TEST_FLOAT_POINTS];
+  double float_storage_values[TEST_FLOAT_LENGTH * TEST_FLOAT_POINTS];
+  float float_values[TEST_FLOAT_LENGTH * TEST_FLOAT_POINTS];
+  polynomial_batch_compute_points(batch, float_points, TEST_FLOAT_POINTS, double_values);
+  polynomial_batch_compute_points(float_batch, float_points, TEST_FLOAT_POINTS, float_storage_values);
+  polynomial_batch_compute_points_float(float_batch, float_points_single, TEST_FLOAT_POINTS, float_values);
+
+  double epsilon = ldexp(1, -24);
+  int storage_within = 1, accumulation_within = 1;
+  for(batch_index = 0; batch_index < TEST_FLOAT_LENGTH; batch_index++) {
+    const float *stored = polynomial_batch_get_coefficients_float(float_batch, batch_index);
+    const double *exact = polynomial_batch_get_coefficients(batch, batch_index);
+
+    for(index = 0; index < TEST_FLOAT_POINTS; index++) {
+      double magnitude = 0, power = 1;
+      int degree;
+      for(degree = 0; degree <= TEST_BATCH_DEGREE; degree++) {
+        magnitude += fabs(exact[degree]) * power;
+        power *= fabs(float_points[index]);
+      }
+
+      unsigned long result = batch_index * TEST_FLOAT_POINTS + index;
+      storage_within = storage_within && fabs(float_storage_values[result] - double_values[result]) <= 2 * epsilon * magnitude;
+      accumulation_within = accumulation_within
+        && fabs(float_values[result] - double_values[result]) <= (2 * TEST_BATCH_DEGREE + 2) * epsilon * magnitude;
+    }
+
+    int degree;
+    for(degree = 0; degree <= TEST_BATCH_DEGREE; degree++) {
+      storage_within = storage_within && fabs(stored[degree] - exact[degree]) <= epsilon * fabs(exact[degree]);
+    }
+  }
+  printf("float storage, double accumulation: %s the bound\n", storage_within ? "within" : "over");
+  printf("float storage, float accumulation: %s the bound\n", accumulation_within ? "within" : "over");
+
+  FILE *float_file = tmpfile();
+  if(!float_file) {
+    fprintf(stderr, "Error in a temporary file!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+  polynomial_batch_write_to_binary_stream(float_batch, float_file);
+  rewind(float_file);
+  PolynomialBatch *float_read = polynomial_batch_create_from_binary_stream(float_file);
+  fclose(float_file);
+
+  int float_identical = float_read != NULL && polynomial_batch_get_precision(float_read) == POLYNOMIAL_BATCH_FLOAT;
+  for(batch_index = 0; float_identical && batch_index < TEST_FLOAT_LENGTH; batch_index++) {
+    const float *written = polynomial_batch_get_coefficients_float(float_batch, batch_index);
+    const float *read = polynomial_batch_get_coefficients_float(float_read, batch_index);
+    int degree;
+    for(degree = 0; degree <= TEST_BATCH_DEGREE; degree++) {
+      float_identical = float_identical && written[degree] == read[degree];
+    }
+  }
+  printf("binary float batch read back: %s\n", float_identical ? "identical" : "different");
+
+  PolynomialBatch *float_derivatives = polynomial_batch_derivative(float_batch);
+  Polynomial *float_first = polynomial_batch_get(float_batch, 0);
+  Polynomial *float_derivative = polynomial_batch_get(float_derivatives, 0);
+  float float_coefficients[TEST_BATCH_DEGREE + 1];
+  polynomial_get_coefficients_float(float_first, float_coefficients);
+  polynomial_get_coefficients(float_derivative, batch_coefficients);
+  printf("derivative of a float batch stored in float: %s, degree %ld, P0'(0) = %.6f for %.6f\n",
+    polynomial_batch_get_precision(float_derivatives) == POLYNOMIAL_BATCH_FLOAT ? "yes" : "no",
+    polynomial_batch_get_degree(float_derivatives, 0), batch_coefficients[0], float_coefficients[1]);
+
+  polynomial_free(&float_first);
+  polynomial_free(&float_derivative);
+  polynomial_batch_free(&float_derivatives);
+  polynomial_batch_free(&float_read);
+  polynomial_batch_free(&float_batch);
+  polynomial_batch_free(&batch);
+
+  printf("\n==========SIMD KERNELS==========\n");
+  // a third of the coefficients are null, some only within the tolerance
+  double kernels_source[TEST_KERNELS_LENGTH + 1];
+  for(index = 0; index <= TEST_KERNELS_LENGTH; index++) {
+    kernels_source[index] = (index % 3 == 1) ? ((index % 2) ? 0. : -0.00005) : sin(index) * 100;
+  }
+  kernels_source[TEST_KERNELS_LENGTH - 2] = 0;
+
+  size_t kernels_size = sizeof(double) * 7 * TEST_KERNELS_LENGTH * TEST_KERNELS_LENGTH;
+  double *scalar_results = calloc(1, kernels_size);
+  double *kernels_results = calloc(1, kernels_size);
+  if(!scalar_results || !kernels_results) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", kernels_size);
+    exit(EXIT_FAILURE);
+  }
+
+  COEFFICIENTS_KERNELS selected = coefficients_get_kernels();
+  coefficients_set_kernels(COEFFICIENTS_KERNELS_SCALAR);
+  run_kernels(kernels_source, scalar_results);
+
+  int kernels_identical = 1;
+  COEFFICIENTS_KERNELS kernels;
+  for(kernels = COEFFICIENTS_KERNELS_SSE2; kernels <= COEFFICIENTS_KERNELS_AVX512; kernels++) {
+    if(!coefficients_set_kernels(kernels)) {
+      continue;
+    }
+
+    memset(kernels_results, 0, kernels_size);
+    run_kernels(kernels_source, kernels_results);
+    kernels_identical = kernels_identical && memcmp(scalar_results, kernels_results, kernels_size) == 0;
+  }
+
+  coefficients_set_kernels(COEFFICIENTS_KERNELS_AUTO);
+  printf("automatic selection same as at startup: %s\n", coefficients_get_kernels() == selected ? "yes" : "no");
+  printf("supported SIMD kernels identical to scalar ones: %s\n", kernels_identical ? "yes" : "no");
+  printf("%ld of %d coefficients not null, up to degree %ld\n",
+    (long) scalar_results[7 * TEST_KERNELS_LENGTH * TEST_KERNELS_LENGTH - TEST_KERNELS_LENGTH], TEST_KERNELS_LENGTH,
+    (long) scalar_results[7 * TEST_KERNELS_LENGTH * TEST_KERNELS_LENGTH - TEST_KERNELS_LENGTH + 1]);
+
+  free(scalar_results);
+  free(kernels_results);
+
+  printf("\n==========FILE PRODUCT==========\n");
+  // blocks smaller than the operands, so that the product goes through several diagonals and a checkpoint
+  double *file_coefficients = malloc(sizeof(double) * (TEST_FILE_LEFT_DEGREE + 1));
+  if(!file_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (TEST_FILE_LEFT_DEGREE + 1));
+    exit(EXIT_FAILURE);
+  }
+  for(index = 0; index <= TEST_FILE_LEFT_DEGREE; index++) {
+    file_coefficients[index] = (index % 5) - 2 + 0.5 * (index % 3);
+  }
+  Polynomial *file_left = polynomial_create(file_coefficients, TEST_FILE_LEFT_DEGREE);
+  Polynomial *file_right = polynomial_create(file_coefficients + 3, TEST_FILE_RIGHT_DEGREE);
+  free(file_coefficients);
+
+  printf("operands written: %s\n", polynomial_file_write(file_left, "file_left.tmp") && polynomial_file_write(file_right, "file_right.tmp") ? "yes" : "no");
+
+  unsigned long long file_calls = 0;
+  PolynomialFileOptions file_options = { TEST_FILE_BLOCK, interrupt_file_product, &file_calls };
+  int interrupted = !polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", &file_options);
+  FILE *file_checkpoint = fopen("file_product.tmp.checkpoint", "rb");
+  printf("interrupted with a checkpoint: %s\n", interrupted && file_checkpoint != NULL ? "yes" : "no");
+  if(file_checkpoint) {
+    fclose(file_checkpoint);
+  }
+
+  unsigned long long file_done = 0;
+  file_options.progress = count_file_product;
+  file_options.data = &file_done;
+  int resumed = polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", &file_options);
+  printf("resumed: %s, %llu block products in all\n", resumed ? "complete" : "failure", file_done);
+
+  Polynomial *file_product = polynomial_file_read("file_product.tmp");
+  Polynomial *memory_product = polynomial_product(file_left, file_right);
+  long file_degree = polynomial_get_degree(file_product);
+  double *file_values = malloc(sizeof(double) * 2 * (file_degree + 1));
+  if(!file_values) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * 2 * (file_degree + 1));
+    exit(EXIT_FAILURE);
+  }
+
+  int file_same = polynomial_get_degree(memory_product) == file_degree;
+  if(file_same) {
+    polynomial_get_coefficients(file_product, file_values);
+    polynomial_get_coefficients(memory_product, file_values + file_degree + 1);
+    for(index = 0; index <= file_degree; index++) {
+      file_same = file_same && fabs(file_values[index] - file_values[file_degree + 1 + index]) < 1e-6;
+    }
+  }
+  printf("degree %ld, same as in memory: %s\n", file_degree, file_same ? "yes" : "no");
+  free(file_values);
+
+  file_checkpoint = fopen("file_product.tmp.checkpoint", "rb");
+  printf("checkpoint removed: %s\n", file_checkpoint == NULL ? "yes" : "no");
+  if(file_checkpoint) {
+    fclose(file_checkpoint);
+  }
+
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  printf("text file as an operand: %s\n",
+    !polynomial_file_product("saved.txt", "file_right.tmp", "file_product.tmp", NULL) && polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "rejected" : "accepted");
+
+  // a degree of 2^64 - 1, whose coefficients aren't in the file
+  write_file_header("file_corrupt.tmp", 16);
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  Polynomial *corrupt = polynomial_file_read("file_corrupt.tmp");
+  printf("huge degree in a header: %s", corrupt == NULL && polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "rejected" : "accepted");
+  if(corrupt) {
+    polynomial_free(&corrupt);
+  }
+  polynomials_errno = POLYNOMIAL_SUCCESS;
+  printf(", %s as an operand\n",
+    !polynomial_file_product("file_left.tmp", "file_corrupt.tmp", "file_product.tmp", NULL) && polynomials_errno == POLYNOMIAL_INPUT_ERROR ? "rejected" : "accepted");
+  remove("file_corrupt.tmp");
+
+  // interrupted, then resumed with another right operand of the same degree: the checkpoint must not be used
+  file_calls = 0;
+  file_options.progress = interrupt_file_product;
+  file_options.data = &file_calls;
+  polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", &file_options);
+  Polynomial *other_right = polynomial_copy(file_right);
+  polynomial_scale(other_right, 2);
+  polynomial_file_write(other_right, "file_right.tmp");
+  int other_complete = polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", NULL);
+  printf("resumed with other operands: %s, %s product\n", other_complete ? "complete" : "failure",
+    file_holds_product("file_product.tmp", file_left, other_right) ? "right" : "wrong");
+
+  // interrupted, then resumed with a result cut after its header: the product starts over
+  file_calls = 0;
+  polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", &file_options);
+  FILE *file_result = fopen("file_product.tmp", "rb");
+  unsigned char file_header[16];
+  int header_read = file_result != NULL && fread(file_header, 1, sizeof(file_header), file_result) == sizeof(file_header);
+  if(file_result) {
+    fclose(file_result);
+  }
+  file_result = fopen("file_product.tmp", "wb");
+  if(!header_read || !file_result || fwrite(file_header, 1, sizeof(file_header), file_result) != sizeof(file_header) || fclose(file_result) != 0) {
+    fprintf(stderr, "Error in file_product.tmp!\nExiting\n");
+    exit(EXIT_FAILURE);
+  }
+  int truncated_complete = polynomial_file_product("file_left.tmp", "file_right.tmp", "file_product.tmp", NULL);
+  printf("resumed with a truncated result: %s, %s product\n", truncated_complete ? "complete" : "failure",
+    file_holds_product("file_product.tmp", file_left, other_right) ? "right" : "wrong");
+  polynomial_free(&other_right);
+
+  remove("file_left.tmp");
+  remove("file_right.tmp");
+  remove("file_product.tmp");
+  polynomial_free(&file_left);
+  polynomial_free(&file_right);
+  polynomial_free(&file_product);
+  polynomial_free(&memory_product);
+
+  printf("\n==========PREPARED PRODUCT==========\n");
+  double *prepared_coefficients = malloc(sizeof(double) * (3 * TEST_PREPARED_DEGREE + 4));
+  if(!prepared_coefficients) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (3 * TEST_PREPARED_DEGREE + 4));
+    exit(EXIT_FAILURE);
+  }
+  for(index = 0; index < 3 * TEST_PREPARED_DEGREE + 4; index++) {
+    prepared_coefficients[index] = (double) ((index * 7) % 13) - 6.0;
+  }
+  Polynomial *prepared_operand = polynomial_create(prepared_coefficients, TEST_PREPARED_DEGREE);
+  PolynomialPrepared *prepared = polynomial_prepare(prepared_operand);
+
+  /*
+   * A small product, two sizes of FFT, the first size again from its cached transform,
+   * a sparse operand, then a non-integral one. All are integral but the last.
+   */
+  unsigned int prepared_degrees[] = { 3, TEST_PREPARED_DEGREE, 3 * TEST_PREPARED_DEGREE, TEST_PREPARED_DEGREE };
+  Polynomial *prepared_others[6];
+  for(index = 0; index < 4; index++) {
+    prepared_others[index] = polynomial_create(prepared_coefficients + index, prepared_degrees[index]);
+  }
+  double sparse_coefficients[TEST_PREPARED_SPARSE_DEGREE + 1] = { 1.0 };
+  sparse_coefficients[TEST_PREPARED_SPARSE_DEGREE] = -2.0;
+  prepared_others[4] = polynomial_create(sparse_coefficients, TEST_PREPARED_SPARSE_DEGREE);
+  for(index = 0; index <= TEST_PREPARED_DEGREE; index++) {
+    prepared_coefficients[index] = sin((double) index) / 3.0;
+  }
+  prepared_others[5] = polynomial_create(prepared_coefficients, TEST_PREPARED_DEGREE);
+  free(prepared_coefficients);
+
+  for(index = 0; index < 6; index++) {
+    Polynomial *prepared_product = polynomial_product_prepared(prepared, prepared_others[index]);
+    Polynomial *expected_product = polynomial_product(prepared_operand, prepared_others[index]);
+    Polynomial *into_product = polynomial_create(sparse_coefficients, 0);
+    polynomial_mul_into(into_product, prepared_operand, prepared_others[index]);
+
+    long prepared_degree = polynomial_get_degree(prepared_product);
+    double *product_coefficients = malloc(sizeof(double) * (prepared_degree + 1));
+    if(!product_coefficients) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(double) * (prepared_degree + 1));
+      exit(EXIT_FAILURE);
+    }
+    polynomial_get_coefficients(prepared_product, product_coefficients);
+
+    int integral = 1;
+    long product_index;
+    for(product_index = 0; product_index <= prepared_degree; product_index++) {
+      integral = integral && product_coefficients[product_index] == floor(product_coefficients[product_index]);
+    }
+    free(product_coefficients);
+
+    printf("degree %ld, same as polynomial_product: %s, same as polynomial_mul_into: %s, integral: %s\n", prepared_degree,
+      polynomial_equals(prepared_product, expected_product) ? "yes" : "no",
+      polynomial_equals(prepared_product, into_product) ? "yes" : "no",
+      integral ? "yes" : "no");
+
+    polynomial_free(&prepared_product);
+    polynomial_free(&expected_product);
+    polynomial_free(&into_product);
+    polynomial_free(&prepared_others[index]);
+  }
+
+  polynomial_free(&prepared_operand);
+  polynomial_prepared_free(&prepared);
+  printf("freed: %s\n", prepared == NULL ? "yes" : "no");
 }
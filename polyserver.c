@@ -0,0 +1,996 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Polynomial.h"
+#include "PolynomialProtocol.h"
+
+#define SERVER_MAX_EVENTS 64
+#define SERVER_READ_SIZE 65536
+
+// a connection stops being read while this many of its requests are waiting for a worker
+#define SERVER_MAX_PENDING 256
+
+#define REGISTRY_INITIAL_BUCKETS 64
+
+#define FRAME_PREFIX_SIZE sizeof(uint32_t)
+#define FRAME_HEADER_SIZE sizeof(PolynomialFrameHeader)
+
+static void* server_allocate(void *pointer, size_t size) {
+  void *allocated = realloc(pointer, size);
+  if(!allocated) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", size);
+    exit(EXIT_FAILURE);
+  }
+
+  return allocated;
+}
+
+
+static void fail(const char *message) {
+  fprintf(stderr, "polyserver: %s: %s\n", message, strerror(errno));
+  exit(EXIT_FAILURE);
+}
+
+
+/*
+ * Growable byte buffers.
+ */
+
+typedef struct {
+  char *data;
+  size_t length;
+  size_t capacity;
+} Buffer;
+
+
+static void buffer_reserve(Buffer *buffer, size_t length) {
+  if(buffer->length + length <= buffer->capacity) {
+    return;
+  }
+
+  size_t capacity = buffer->capacity > 0 ? buffer->capacity * 2 : 256;
+  while(capacity < buffer->length + length) {
+    capacity *= 2;
+  }
+
+  buffer->data = server_allocate(buffer->data, capacity);
+  buffer->capacity = capacity;
+}
+
+
+static void buffer_append(Buffer *buffer, const void *data, size_t length) {
+  buffer_reserve(buffer, length);
+  memcpy(buffer->data + buffer->length, data, length);
+  buffer->length += length;
+}
+
+
+static void buffer_free(Buffer *buffer) {
+  free(buffer->data);
+  buffer->data = NULL;
+  buffer->length = buffer->capacity = 0;
+}
+
+
+/*
+ * Registry of the parsed polynomials, keyed by id.
+ * Readers take a copy of the polynomial they need, which shares its monomials and costs O(1),
+ * so that the registry is only locked while looking it up.
+ */
+
+typedef struct RegistryEntry {
+  uint64_t id;
+  Polynomial *polynomial;
+  struct RegistryEntry *next;
+} RegistryEntry;
+
+typedef struct {
+  pthread_rwlock_t lock;
+  RegistryEntry **buckets;
+  unsigned long buckets_count; // a power of 2
+  unsigned long length;
+  uint64_t next_id;
+} Registry;
+
+
+static void registry_init(Registry *registry) {
+  pthread_rwlock_init(&registry->lock, NULL);
+  registry->buckets_count = REGISTRY_INITIAL_BUCKETS;
+  registry->buckets = calloc(registry->buckets_count, sizeof(RegistryEntry*));
+  if(!registry->buckets) {
+    fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(RegistryEntry*) * registry->buckets_count);
+    exit(EXIT_FAILURE);
+  }
+  registry->length = 0;
+  registry->next_id = 1;
+}
+
+
+/*
+ * @function registry_add
+ *
+ * Takes ownership of polynomial.
+ *
+ * @return uint64_t
+ * The id of polynomial, never 0.
+ */
+static uint64_t registry_add(Registry *registry, Polynomial *polynomial) {
+  RegistryEntry *entry = server_allocate(NULL, sizeof(RegistryEntry));
+  entry->polynomial = polynomial;
+
+  pthread_rwlock_wrlock(&registry->lock);
+
+  if(registry->length >= registry->buckets_count) {
+    unsigned long buckets_count = registry->buckets_count * 2;
+    RegistryEntry **buckets = calloc(buckets_count, sizeof(RegistryEntry*));
+    if(!buckets) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(RegistryEntry*) * buckets_count);
+      exit(EXIT_FAILURE);
+    }
+
+    unsigned long index;
+    for(index = 0; index < registry->buckets_count; index++) {
+      RegistryEntry *current = registry->buckets[index];
+      while(current != NULL) {
+        RegistryEntry *next = current->next;
+        current->next = buckets[current->id & (buckets_count - 1)];
+        buckets[current->id & (buckets_count - 1)] = current;
+        current = next;
+      }
+    }
+
+    free(registry->buckets);
+    registry->buckets = buckets;
+    registry->buckets_count = buckets_count;
+  }
+
+  entry->id = registry->next_id++;
+  RegistryEntry **bucket = &registry->buckets[entry->id & (registry->buckets_count - 1)];
+  entry->next = *bucket;
+  *bucket = entry;
+  registry->length++;
+
+  pthread_rwlock_unlock(&registry->lock);
+
+  return entry->id;
+}
+
+
+/*
+ * @function registry_get
+ *
+ * @return Polynomial*
+ * A copy of polynomial id, to be freed with polynomial_free, or NULL if there is none.
+ */
+static Polynomial* registry_get(Registry *registry, uint64_t id) {
+  Polynomial *copy = NULL;
+
+  pthread_rwlock_rdlock(&registry->lock);
+
+  RegistryEntry *current = registry->buckets[id & (registry->buckets_count - 1)];
+  while(current != NULL && current->id != id) {
+    current = current->next;
+  }
+
+  if(current != NULL) {
+    copy = polynomial_copy(current->polynomial);
+  }
+
+  pthread_rwlock_unlock(&registry->lock);
+
+  return copy;
+}
+
+
+/*
+ * @function registry_remove
+ *
+ * @return int
+ * 1 if polynomial id was removed, 0 if there was none.
+ */
+static int registry_remove(Registry *registry, uint64_t id) {
+  pthread_rwlock_wrlock(&registry->lock);
+
+  RegistryEntry **link = &registry->buckets[id & (registry->buckets_count - 1)];
+  while(*link != NULL && (*link)->id != id) {
+    link = &(*link)->next;
+  }
+
+  RegistryEntry *removed = *link;
+  if(removed != NULL) {
+    *link = removed->next;
+    registry->length--;
+  }
+
+  pthread_rwlock_unlock(&registry->lock);
+
+  if(!removed) {
+    return 0;
+  }
+
+  polynomial_free(&removed->polynomial);
+  free(removed);
+
+  return 1;
+}
+
+
+static void registry_destroy(Registry *registry) {
+  unsigned long index;
+  for(index = 0; index < registry->buckets_count; index++) {
+    RegistryEntry *current = registry->buckets[index];
+    while(current != NULL) {
+      RegistryEntry *next = current->next;
+      polynomial_free(&current->polynomial);
+      free(current);
+      current = next;
+    }
+  }
+
+  free(registry->buckets);
+  pthread_rwlock_destroy(&registry->lock);
+}
+
+
+/*
+ * Connections and jobs.
+ *
+ * Connections belong to the I/O thread, which reads requests, hands them to the workers as jobs,
+ * and writes back the responses the workers complete.
+ * A closed connection is only freed once none of its jobs is left,
+ * and after the events of the current epoll_wait, which may still refer to it, have all been processed.
+ */
+
+typedef struct Connection {
+  int fd;
+  struct Connection *previous; // list of the open connections
+  struct Connection *next; // or of the closed ones to free, once closed
+  Buffer input;
+  Buffer output;
+  size_t output_sent;
+  unsigned int pending; // jobs given to the workers and not completed yet
+  int closed;
+  uint32_t events; // epoll events currently watched
+} Connection;
+
+typedef struct Job {
+  Connection *connection;
+  PolynomialFrameHeader header;
+  char *payload;
+  uint32_t payload_length;
+  Buffer response; // whole frame, length prefix included
+  struct Job *next;
+} Job;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t available;
+  Job *first;
+  Job *last;
+  int stopping;
+} JobQueue;
+
+typedef struct {
+  Registry registry;
+  JobQueue jobs;
+
+  pthread_mutex_t completed_mutex;
+  Job *completed; // in any order
+  int completed_fd; // an eventfd, written by the workers to wake up the I/O thread
+
+  int epoll_fd;
+  Connection *connections; // open ones
+  Connection *closed; // closed ones without any job left, to free after the current events
+} Server;
+
+// epoll data of the descriptors which are not connections
+static char listen_marker, completed_marker, signal_marker;
+
+
+static void job_queue_push(JobQueue *queue, Job *job) {
+  job->next = NULL;
+
+  pthread_mutex_lock(&queue->mutex);
+  if(queue->last != NULL) {
+    queue->last->next = job;
+  } else {
+    queue->first = job;
+  }
+  queue->last = job;
+  pthread_cond_signal(&queue->available);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+
+/*
+ * @function job_queue_pop
+ *
+ * @return Job*
+ * The oldest job, waiting for one if needed. NULL once the server is stopping.
+ */
+static Job* job_queue_pop(JobQueue *queue) {
+  pthread_mutex_lock(&queue->mutex);
+  while(queue->first == NULL && !queue->stopping) {
+    pthread_cond_wait(&queue->available, &queue->mutex);
+  }
+
+  Job *job = queue->first;
+  if(job != NULL) {
+    queue->first = job->next;
+    if(queue->first == NULL) {
+      queue->last = NULL;
+    }
+  }
+  pthread_mutex_unlock(&queue->mutex);
+
+  return job;
+}
+
+
+/*
+ * Requests, executed by the workers.
+ */
+
+static void response_begin(Job *job, POLYNOMIAL_RESPONSE status) {
+  PolynomialFrameHeader header = job->header;
+  header.status = status;
+
+  job->response.length = 0;
+  uint32_t length = FRAME_HEADER_SIZE;
+  buffer_append(&job->response, &length, sizeof(length));
+  buffer_append(&job->response, &header, sizeof(header));
+}
+
+
+static void response_end(Job *job) {
+  uint32_t length = job->response.length - FRAME_PREFIX_SIZE;
+  memcpy(job->response.data, &length, sizeof(length));
+}
+
+
+static void response_id(Job *job, uint64_t id) {
+  response_begin(job, POLYNOMIAL_RESPONSE_OK);
+  buffer_append(&job->response, &id, sizeof(id));
+}
+
+
+static void execute(Registry *registry, Job *job) {
+  uint64_t ids[2];
+
+  switch(job->header.operation) {
+    case POLYNOMIAL_REQUEST_REGISTER: {
+      char *string = server_allocate(NULL, job->payload_length + 1);
+      memcpy(string, job->payload, job->payload_length);
+      string[job->payload_length] = '\0';
+
+      polynomials_errno = POLYNOMIAL_SUCCESS;
+      Polynomial *polynomial = polynomial_create_from_string(string);
+      free(string);
+
+      if(!polynomial && polynomials_errno == POLYNOMIAL_INPUT_ERROR) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      if(!polynomial) {
+        // the null polynomial
+        double zero = 0;
+        polynomial = polynomial_create(&zero, 0);
+      }
+
+      response_id(job, registry_add(registry, polynomial));
+      break;
+    }
+
+    case POLYNOMIAL_REQUEST_UNREGISTER:
+      if(job->payload_length != sizeof(uint64_t)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      memcpy(ids, job->payload, sizeof(uint64_t));
+      response_begin(job, registry_remove(registry, ids[0]) ? POLYNOMIAL_RESPONSE_OK : POLYNOMIAL_RESPONSE_UNKNOWN_ID);
+      break;
+
+    case POLYNOMIAL_REQUEST_EVALUATE: {
+      uint32_t count;
+      if(job->payload_length < sizeof(uint64_t) + sizeof(uint32_t)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      memcpy(ids, job->payload, sizeof(uint64_t));
+      memcpy(&count, job->payload + sizeof(uint64_t), sizeof(uint32_t));
+      if(job->payload_length != sizeof(uint64_t) + sizeof(uint32_t) + (uint64_t) count * sizeof(double)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      Polynomial *polynomial = registry_get(registry, ids[0]);
+      if(!polynomial) {
+        response_begin(job, POLYNOMIAL_RESPONSE_UNKNOWN_ID);
+        break;
+      }
+
+      // the points are copied to be aligned
+      double *points = server_allocate(NULL, sizeof(double) * 2 * (count > 0 ? count : 1));
+      double *values = points + count;
+      memcpy(points, job->payload + sizeof(uint64_t) + sizeof(uint32_t), sizeof(double) * count);
+
+      polynomial_compute_derivatives_batch(polynomial, points, count, values, 1);
+
+      response_begin(job, POLYNOMIAL_RESPONSE_OK);
+      buffer_append(&job->response, values, sizeof(double) * count);
+
+      free(points);
+      polynomial_free(&polynomial);
+      break;
+    }
+
+    case POLYNOMIAL_REQUEST_DERIVE: {
+      if(job->payload_length != sizeof(uint64_t)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      memcpy(ids, job->payload, sizeof(uint64_t));
+      Polynomial *polynomial = registry_get(registry, ids[0]);
+      if(!polynomial) {
+        response_begin(job, POLYNOMIAL_RESPONSE_UNKNOWN_ID);
+        break;
+      }
+
+      polynomial_derivative_in_place(polynomial);
+      response_id(job, registry_add(registry, polynomial));
+      break;
+    }
+
+    case POLYNOMIAL_REQUEST_MULTIPLY: {
+      if(job->payload_length != 2 * sizeof(uint64_t)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      memcpy(ids, job->payload, 2 * sizeof(uint64_t));
+      Polynomial *left = registry_get(registry, ids[0]);
+      Polynomial *right = registry_get(registry, ids[1]);
+      if(!left || !right) {
+        if(left) {
+          polynomial_free(&left);
+        }
+        if(right) {
+          polynomial_free(&right);
+        }
+        response_begin(job, POLYNOMIAL_RESPONSE_UNKNOWN_ID);
+        break;
+      }
+
+      polynomials_errno = POLYNOMIAL_SUCCESS;
+      Polynomial *product = polynomial_product(left, right);
+      polynomial_free(&left);
+      polynomial_free(&right);
+
+      if(!product) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MATH_ERROR);
+        break;
+      }
+
+      response_id(job, registry_add(registry, product));
+      break;
+    }
+
+    case POLYNOMIAL_REQUEST_GET: {
+      if(job->payload_length != sizeof(uint64_t)) {
+        response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+        break;
+      }
+
+      memcpy(ids, job->payload, sizeof(uint64_t));
+      Polynomial *polynomial = registry_get(registry, ids[0]);
+      if(!polynomial) {
+        response_begin(job, POLYNOMIAL_RESPONSE_UNKNOWN_ID);
+        break;
+      }
+
+      char *text = NULL;
+      size_t text_length = 0;
+      FILE *stream = open_memstream(&text, &text_length);
+      if(!stream) {
+        fail("couldn't open a memory stream");
+      }
+      polynomial_write_to_stream(polynomial, stream);
+      fclose(stream);
+
+      response_begin(job, POLYNOMIAL_RESPONSE_OK);
+      buffer_append(&job->response, text, text_length);
+
+      free(text);
+      polynomial_free(&polynomial);
+      break;
+    }
+
+    default:
+      response_begin(job, POLYNOMIAL_RESPONSE_MALFORMED);
+      break;
+  }
+
+  response_end(job);
+}
+
+
+static void* worker_run(void *argument) {
+  Server *server = argument;
+
+  Job *job;
+  while((job = job_queue_pop(&server->jobs)) != NULL) {
+    execute(&server->registry, job);
+
+    free(job->payload);
+    job->payload = NULL;
+
+    pthread_mutex_lock(&server->completed_mutex);
+    job->next = server->completed;
+    server->completed = job;
+    pthread_mutex_unlock(&server->completed_mutex);
+
+    uint64_t one = 1;
+    if(write(server->completed_fd, &one, sizeof(one)) != sizeof(one)) {
+      fail("couldn't wake up the I/O thread");
+    }
+  }
+
+  return NULL;
+}
+
+
+/*
+ * I/O thread.
+ */
+
+static void connection_watch(Server *server, Connection *connection) {
+  uint32_t events = 0;
+  if(connection->pending < SERVER_MAX_PENDING) {
+    events |= EPOLLIN;
+  }
+  if(connection->output_sent < connection->output.length) {
+    events |= EPOLLOUT;
+  }
+
+  if(events != connection->events) {
+    struct epoll_event event = { .events = events, .data.ptr = connection };
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+    connection->events = events;
+  }
+}
+
+
+static void connection_free(Connection *connection) {
+  buffer_free(&connection->input);
+  buffer_free(&connection->output);
+  free(connection);
+}
+
+
+// a closed connection without any job left is freed by server_free_closed
+static void connection_release(Server *server, Connection *connection) {
+  connection->next = server->closed;
+  server->closed = connection;
+}
+
+
+static void server_free_closed(Server *server) {
+  while(server->closed != NULL) {
+    Connection *connection = server->closed;
+    server->closed = connection->next;
+    connection_free(connection);
+  }
+}
+
+
+static void connection_close(Server *server, Connection *connection) {
+  if(connection->closed) {
+    return;
+  }
+
+  epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+  close(connection->fd);
+  connection->closed = 1;
+
+  if(connection->previous != NULL) {
+    connection->previous->next = connection->next;
+  } else {
+    server->connections = connection->next;
+  }
+  if(connection->next != NULL) {
+    connection->next->previous = connection->previous;
+  }
+
+  if(connection->pending == 0) {
+    connection_release(server, connection);
+  }
+}
+
+
+/*
+ * @function connection_flush
+ *
+ * @return int
+ * 0 if the connection was closed.
+ */
+static int connection_flush(Server *server, Connection *connection) {
+  while(connection->output_sent < connection->output.length) {
+    ssize_t sent = send(
+      connection->fd,
+      connection->output.data + connection->output_sent,
+      connection->output.length - connection->output_sent,
+      MSG_NOSIGNAL
+    );
+
+    if(sent < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      if(errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+
+      connection_close(server, connection);
+      return 0;
+    }
+
+    connection->output_sent += sent;
+  }
+
+  if(connection->output_sent == connection->output.length) {
+    connection->output.length = 0;
+    connection->output_sent = 0;
+  }
+
+  connection_watch(server, connection);
+
+  return 1;
+}
+
+
+/*
+ * @function connection_dispatch
+ *
+ * Hands every complete request of the input buffer to the workers,
+ * until the connection has too many pending requests.
+ *
+ * @return int
+ * 0 if the connection was closed.
+ */
+static int connection_dispatch(Server *server, Connection *connection) {
+  size_t offset = 0;
+
+  while(connection->pending < SERVER_MAX_PENDING && connection->input.length - offset >= FRAME_PREFIX_SIZE) {
+    uint32_t length;
+    memcpy(&length, connection->input.data + offset, sizeof(length));
+    if(length < FRAME_HEADER_SIZE || length > POLYNOMIAL_PROTOCOL_MAX_FRAME) {
+      connection_close(server, connection);
+      return 0;
+    }
+
+    if(connection->input.length - offset < FRAME_PREFIX_SIZE + length) {
+      break;
+    }
+
+    Job *job = server_allocate(NULL, sizeof(Job));
+    job->connection = connection;
+    memcpy(&job->header, connection->input.data + offset + FRAME_PREFIX_SIZE, FRAME_HEADER_SIZE);
+    job->payload_length = length - FRAME_HEADER_SIZE;
+    job->payload = server_allocate(NULL, job->payload_length > 0 ? job->payload_length : 1);
+    memcpy(job->payload, connection->input.data + offset + FRAME_PREFIX_SIZE + FRAME_HEADER_SIZE, job->payload_length);
+    job->response.data = NULL;
+    job->response.length = job->response.capacity = 0;
+
+    connection->pending++;
+    job_queue_push(&server->jobs, job);
+
+    offset += FRAME_PREFIX_SIZE + length;
+  }
+
+  memmove(connection->input.data, connection->input.data + offset, connection->input.length - offset);
+  connection->input.length -= offset;
+
+  connection_watch(server, connection);
+
+  return 1;
+}
+
+
+static void connection_read(Server *server, Connection *connection) {
+  for(;;) {
+    buffer_reserve(&connection->input, SERVER_READ_SIZE);
+    ssize_t received = recv(connection->fd, connection->input.data + connection->input.length, SERVER_READ_SIZE, 0);
+
+    if(received == 0) {
+      connection_close(server, connection);
+      return;
+    }
+
+    if(received < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      if(errno != EAGAIN && errno != EWOULDBLOCK) {
+        connection_close(server, connection);
+      }
+      return;
+    }
+
+    connection->input.length += received;
+
+    if(!connection_dispatch(server, connection) || connection->pending >= SERVER_MAX_PENDING) {
+      // the rest stays in the socket until the workers catch up
+      return;
+    }
+  }
+}
+
+
+static void server_accept(Server *server, int listen_fd) {
+  for(;;) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(fd < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    Connection *connection = calloc(1, sizeof(Connection));
+    if(!connection) {
+      fprintf(stderr, "Fatal error: couldn't allocate %zu bytes!\nExiting\n", sizeof(Connection));
+      exit(EXIT_FAILURE);
+    }
+    connection->fd = fd;
+    connection->events = EPOLLIN;
+
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = connection };
+    if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      close(fd);
+      free(connection);
+      continue;
+    }
+
+    connection->next = server->connections;
+    if(server->connections != NULL) {
+      server->connections->previous = connection;
+    }
+    server->connections = connection;
+  }
+}
+
+
+static void server_complete(Server *server) {
+  uint64_t count;
+  if(read(server->completed_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+    fail("couldn't read the completions");
+  }
+
+  pthread_mutex_lock(&server->completed_mutex);
+  Job *job = server->completed;
+  server->completed = NULL;
+  pthread_mutex_unlock(&server->completed_mutex);
+
+  while(job != NULL) {
+    Job *next = job->next;
+    Connection *connection = job->connection;
+    connection->pending--;
+
+    if(connection->closed) {
+      if(connection->pending == 0) {
+        connection_release(server, connection);
+      }
+    } else {
+      buffer_append(&connection->output, job->response.data, job->response.length);
+
+      // requests left in the input buffer while the connection had too many pending ones;
+      // the ones still in the socket will be read once epoll reports them again
+      if(connection->input.length == 0 || connection_dispatch(server, connection)) {
+        connection_flush(server, connection);
+      }
+    }
+
+    buffer_free(&job->response);
+    free(job);
+    job = next;
+  }
+}
+
+
+static void usage(void) {
+  fprintf(stderr,
+    "usage: polyserver [-t threads] [-s socket]\n"
+    "\n"
+    "  -t THREADS     number of workers, 0 (default) for one per processor\n"
+    "  -s SOCKET      path of the Unix socket, " POLYNOMIAL_PROTOCOL_DEFAULT_SOCKET " by default\n"
+  );
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char **argv) {
+  const char *socket_path = POLYNOMIAL_PROTOCOL_DEFAULT_SOCKET;
+  long threads = 0;
+
+  int option;
+  while((option = getopt(argc, argv, "t:s:")) != -1) {
+    switch(option) {
+      case 't': {
+        char *end;
+        threads = strtol(optarg, &end, 10);
+        if(*end != '\0' || threads < 0) {
+          usage();
+        }
+        break;
+      }
+
+      case 's': socket_path = optarg; break;
+      default: usage();
+    }
+  }
+
+  if(optind != argc) {
+    usage();
+  }
+
+  if(threads == 0) {
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads < 1) {
+      threads = 1;
+    }
+  }
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if(strlen(socket_path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "polyserver: socket path too long\n");
+    return EXIT_FAILURE;
+  }
+  strcpy(address.sun_path, socket_path);
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(listen_fd < 0) {
+    fail("couldn't create the socket");
+  }
+
+  unlink(socket_path);
+  if(bind(listen_fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+    fail(socket_path);
+  }
+
+  // SIGINT and SIGTERM stop the server cleanly, through the event loop
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+  int signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+  Server server;
+  registry_init(&server.registry);
+  pthread_mutex_init(&server.jobs.mutex, NULL);
+  pthread_cond_init(&server.jobs.available, NULL);
+  server.jobs.first = server.jobs.last = NULL;
+  server.jobs.stopping = 0;
+  pthread_mutex_init(&server.completed_mutex, NULL);
+  server.completed = NULL;
+  server.completed_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  server.connections = NULL;
+  server.closed = NULL;
+  if(signal_fd < 0 || server.completed_fd < 0 || server.epoll_fd < 0) {
+    fail("couldn't set up the event loop");
+  }
+
+  struct epoll_event event = { .events = EPOLLIN };
+  event.data.ptr = &listen_marker;
+  epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+  event.data.ptr = &completed_marker;
+  epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.completed_fd, &event);
+  event.data.ptr = &signal_marker;
+  epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, signal_fd, &event);
+
+  // workers inherit the blocked signals
+  pthread_t *workers = server_allocate(NULL, sizeof(pthread_t) * threads);
+  long index;
+  for(index = 0; index < threads; index++) {
+    if(pthread_create(&workers[index], NULL, worker_run, &server) != 0) {
+      fail("couldn't start the workers");
+    }
+  }
+
+  fprintf(stderr, "polyserver: listening on %s with %ld workers\n", socket_path, threads);
+
+  int running = 1;
+  struct epoll_event events[SERVER_MAX_EVENTS];
+  while(running) {
+    int count = epoll_wait(server.epoll_fd, events, SERVER_MAX_EVENTS, -1);
+    if(count < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      fail("couldn't wait for events");
+    }
+
+    int current;
+    for(current = 0; current < count; current++) {
+      void *source = events[current].data.ptr;
+
+      if(source == &listen_marker) {
+        server_accept(&server, listen_fd);
+      } else if(source == &completed_marker) {
+        server_complete(&server);
+      } else if(source == &signal_marker) {
+        running = 0;
+      } else {
+        Connection *connection = source;
+        if(connection->closed) {
+          continue;
+        }
+
+        if(events[current].events & (EPOLLERR | EPOLLHUP)) {
+          connection_close(&server, connection);
+          continue;
+        }
+
+        if(events[current].events & EPOLLOUT) {
+          if(!connection_flush(&server, connection)) {
+            continue;
+          }
+        }
+
+        if(events[current].events & EPOLLIN) {
+          connection_read(&server, connection);
+        }
+      }
+    }
+
+    server_free_closed(&server);
+  }
+
+  // stop the workers, then free what they left
+  pthread_mutex_lock(&server.jobs.mutex);
+  server.jobs.stopping = 1;
+  pthread_cond_broadcast(&server.jobs.available);
+  pthread_mutex_unlock(&server.jobs.mutex);
+
+  for(index = 0; index < threads; index++) {
+    pthread_join(workers[index], NULL);
+  }
+  free(workers);
+
+  while(server.connections != NULL) {
+    connection_close(&server, server.connections);
+  }
+  server_complete(&server);
+  server_free_closed(&server);
+
+  fprintf(stderr, "polyserver: stopping, %lu polynomials registered\n", server.registry.length);
+
+  close(listen_fd);
+  unlink(socket_path);
+  close(signal_fd);
+  close(server.completed_fd);
+  close(server.epoll_fd);
+  registry_destroy(&server.registry);
+
+  return EXIT_SUCCESS;
+}
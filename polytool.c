@@ -0,0 +1,518 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Polynomial.h"
+#include "PolynomialBatch.h"
+#include "PolynomialPipeline.h"
+
+#define POLYTOOL_BUFFER_SIZE (1 << 20)
+
+typedef enum {
+  FORMAT_TEXT,
+  FORMAT_BINARY,
+  FORMAT_BINARY_FLOAT
+} FORMAT;
+
+typedef struct {
+  unsigned int threads;
+  FORMAT input_format;
+  FORMAT output_format;
+  int statistics;
+} Options;
+
+typedef struct {
+  const double *points;
+  unsigned long number_of_points;
+  unsigned long processed; // updated atomically by the pipeline's workers
+} EvalContext;
+
+static double timer_start;
+
+
+static double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+
+static void usage(void) {
+  fprintf(stderr,
+    "usage: polytool [options] command [argument] [file]\n"
+    "\n"
+    "Reads polynomials from file, or stdin if it is missing or '-', one per line.\n"
+    "\n"
+    "commands:\n"
+    "  eval POINTS    values of each polynomial at POINTS, one line per polynomial\n"
+    "                 POINTS is a comma-separated list of numbers and of ranges start:stop:step\n"
+    "  sum            sum of all the polynomials\n"
+    "  product        product of all the polynomials\n"
+    "  power N        each polynomial to the power N, a whole number >= 1\n"
+    "  derivative     derivative of each polynomial\n"
+    "  convert        copies the polynomials, to change their format\n"
+    "  unique TOL     copies the first occurrence of each polynomial, in order\n"
+    "                 with TOL > 0, coefficients are first rounded to multiples of TOL, 0 compares them exactly\n"
+    "\n"
+    "options:\n"
+    "  -t THREADS     number of threads, 0 (default) for one per processor\n"
+    "  -i FORMAT      input format, text (default) or binary, whose precision is detected\n"
+    "  -f FORMAT      output format, text (default), binary or binary32, which stores coefficients as floats\n"
+    "  -o FILE        output file instead of stdout\n"
+    "  -s             prints timing statistics to stderr\n"
+  );
+  exit(EXIT_FAILURE);
+}
+
+
+static void fail(const char *message, const char *detail) {
+  fprintf(stderr, "polytool: %s%s%s\n", message, detail ? ": " : "", detail ? detail : "");
+  exit(EXIT_FAILURE);
+}
+
+
+static FORMAT parse_format(const char *string) {
+  if(strcmp(string, "text") == 0) {
+    return FORMAT_TEXT;
+  } else if(strcmp(string, "binary") == 0) {
+    return FORMAT_BINARY;
+  } else if(strcmp(string, "binary32") == 0) {
+    return FORMAT_BINARY_FLOAT;
+  }
+
+  fail("unknown format", string);
+  return FORMAT_TEXT;
+}
+
+
+static double parse_number(const char *string, char **end) {
+  errno = 0;
+  double number = strtod(string, end);
+  if(*end == string || errno != 0) {
+    fail("malformed number", string);
+  }
+
+  return number;
+}
+
+
+/*
+ * @function parse_points
+ *
+ * @return double*
+ * The points described by string, such as "-1,0.5,2:4:0.5". Must be freed with free after use.
+ */
+static double* parse_points(const char *string, unsigned long *number_of_points) {
+  unsigned long capacity = 16;
+  double *points = malloc(sizeof(double) * capacity);
+  if(!points) {
+    fail("out of memory", NULL);
+  }
+
+  *number_of_points = 0;
+  const char *cursor = string;
+  while(*cursor != '\0') {
+    char *end;
+    double start = parse_number(cursor, &end);
+    double stop = start, step = 1;
+
+    if(*end == ':') {
+      stop = parse_number(end + 1, &end);
+      if(*end != ':') {
+        fail("a range must be start:stop:step", string);
+      }
+
+      step = parse_number(end + 1, &end);
+      if(step <= 0 || stop < start) {
+        fail("a range must have start <= stop and step > 0", string);
+      }
+    }
+
+    // computing each point from start avoids accumulating rounding errors
+    unsigned long count = (unsigned long) ((stop - start) / step + 1e-9) + 1;
+    unsigned long index;
+    for(index = 0; index < count; index++) {
+      if(*number_of_points == capacity) {
+        capacity *= 2;
+        points = realloc(points, sizeof(double) * capacity);
+        if(!points) {
+          fail("out of memory", NULL);
+        }
+      }
+
+      points[(*number_of_points)++] = start + index * step;
+    }
+
+    if(*end == ',') {
+      end++;
+    } else if(*end != '\0') {
+      fail("malformed points", string);
+    }
+
+    cursor = end;
+  }
+
+  if(*number_of_points == 0) {
+    fail("no point to evaluate", NULL);
+  }
+
+  return points;
+}
+
+
+static void write_values(FILE *output, const double *values, unsigned long number_of_values) {
+  unsigned long index;
+  for(index = 0; index < number_of_values; index++) {
+    fprintf(output, index == 0 ? "%.17g" : " %.17g", values[index]);
+  }
+
+  fputc('\n', output);
+}
+
+
+/*
+ * Operations run by the pipeline, when both input and output are text.
+ */
+
+static void pipeline_eval(const Polynomial *polynomial, FILE *output, void *context) {
+  EvalContext *eval = context;
+
+  double *values = malloc(sizeof(double) * eval->number_of_points);
+  if(!values) {
+    fail("out of memory", NULL);
+  }
+
+  polynomial_compute_derivatives_batch(polynomial, eval->points, eval->number_of_points, values, 1);
+  write_values(output, values, eval->number_of_points);
+  free(values);
+
+  __atomic_fetch_add(&eval->processed, 1, __ATOMIC_RELAXED);
+}
+
+
+static void pipeline_derivative(const Polynomial *polynomial, FILE *output, void *context) {
+  Polynomial *derivative = polynomial_derivative(polynomial);
+  polynomial_write_to_stream(derivative, output);
+  polynomial_free(&derivative);
+
+  __atomic_fetch_add(&((EvalContext*) context)->processed, 1, __ATOMIC_RELAXED);
+}
+
+
+static void pipeline_power(const Polynomial *polynomial, FILE *output, void *context) {
+  EvalContext *power_context = context;
+
+  Polynomial *power = polynomial_power(polynomial, (int) power_context->points[0]);
+  polynomial_write_to_stream(power, output);
+  polynomial_free(&power);
+
+  __atomic_fetch_add(&power_context->processed, 1, __ATOMIC_RELAXED);
+}
+
+
+static PolynomialBatch* read_batch(FILE *input, FORMAT format) {
+  PolynomialBatch *batch = format != FORMAT_TEXT ?
+    polynomial_batch_create_from_binary_stream(input) :
+    polynomial_batch_create_from_stream(input);
+
+  if(!batch) {
+    fail("couldn't read the polynomials", format != FORMAT_TEXT ? "not a binary batch" : "malformed input");
+  }
+
+  return batch;
+}
+
+
+static void write_batch(const PolynomialBatch *batch, FILE *output, FORMAT format) {
+  // binary batches are written in the precision of the format, whatever the precision they were read in
+  PolynomialBatch *converted = NULL;
+  POLYNOMIAL_BATCH_PRECISION precision = format == FORMAT_BINARY_FLOAT ? POLYNOMIAL_BATCH_FLOAT : POLYNOMIAL_BATCH_DOUBLE;
+  if(format != FORMAT_TEXT && polynomial_batch_get_precision(batch) != precision) {
+    converted = polynomial_batch_convert(batch, precision);
+    batch = converted;
+  }
+
+  int success = format != FORMAT_TEXT ?
+    polynomial_batch_write_to_binary_stream(batch, output) :
+    polynomial_batch_write_to_stream(batch, output);
+
+  if(converted != NULL) {
+    polynomial_batch_free(&converted);
+  }
+
+  if(!success) {
+    fail("couldn't write the polynomials", strerror(errno));
+  }
+}
+
+
+static void write_polynomial(const Polynomial *polynomial, FILE *output, FORMAT format) {
+  if(format == FORMAT_TEXT) {
+    polynomial_write_to_stream(polynomial, output);
+    return;
+  }
+
+  PolynomialBatch *batch = polynomial_batch_create();
+  polynomial_batch_append(batch, polynomial);
+  write_batch(batch, output, format);
+  polynomial_batch_free(&batch);
+}
+
+
+/*
+ * @function product_tree
+ *
+ * Multiplies the polynomials of batch pairwise, then the products pairwise, and so on:
+ * operands stay balanced, so that big products go through the FFT.
+ */
+static Polynomial* product_tree(const PolynomialBatch *batch) {
+  unsigned long length = polynomial_batch_get_length(batch);
+  if(length == 0) {
+    double one = 1;
+    return polynomial_create(&one, 0);
+  }
+
+  Polynomial **factors = malloc(sizeof(Polynomial*) * length);
+  if(!factors) {
+    fail("out of memory", NULL);
+  }
+
+  unsigned long index;
+  for(index = 0; index < length; index++) {
+    factors[index] = polynomial_batch_get(batch, index);
+  }
+
+  while(length > 1) {
+    unsigned long products = 0;
+    for(index = 0; index + 1 < length; index += 2) {
+      Polynomial *product = polynomial_product(factors[index], factors[index + 1]);
+      polynomial_free(&factors[index]);
+      polynomial_free(&factors[index + 1]);
+      factors[products++] = product;
+    }
+
+    if(index < length) {
+      factors[products++] = factors[index];
+    }
+
+    length = products;
+  }
+
+  Polynomial *product = factors[0];
+  free(factors);
+
+  return product;
+}
+
+
+static void print_statistics(const Options *options, const char *command, unsigned long polynomials, double read, double compute, double write) {
+  if(!options->statistics) {
+    return;
+  }
+
+  double total = now() - timer_start;
+  fprintf(stderr, "polytool: %s of %lu polynomials in %.6f s", command, polynomials, total);
+  if(read >= 0) {
+    fprintf(stderr, " (read %.6f s, compute %.6f s, write %.6f s)", read, compute, write);
+  }
+  fprintf(stderr, ", %.0f polynomials/s\n", total > 0 ? polynomials / total : 0.);
+}
+
+
+int main(int argc, char **argv) {
+  timer_start = now();
+
+  Options options = { 0, FORMAT_TEXT, FORMAT_TEXT, 0 };
+  const char *output_filename = NULL;
+
+  int option;
+  while((option = getopt(argc, argv, "t:i:f:o:s")) != -1) {
+    switch(option) {
+      case 't': {
+        char *end;
+        double threads = parse_number(optarg, &end);
+        if(*end != '\0' || threads < 0) {
+          fail("malformed number of threads", optarg);
+        }
+        options.threads = (unsigned int) threads;
+        break;
+      }
+
+      case 'i': options.input_format = parse_format(optarg); break;
+      case 'f': options.output_format = parse_format(optarg); break;
+      case 'o': output_filename = optarg; break;
+      case 's': options.statistics = 1; break;
+      default: usage();
+    }
+  }
+
+  if(optind >= argc) {
+    usage();
+  }
+
+  const char *command = argv[optind++];
+  const char *argument = NULL;
+  if(strcmp(command, "eval") == 0 || strcmp(command, "power") == 0 || strcmp(command, "unique") == 0) {
+    if(optind >= argc) {
+      usage();
+    }
+    argument = argv[optind++];
+  } else if(strcmp(command, "sum") != 0 && strcmp(command, "product") != 0
+    && strcmp(command, "derivative") != 0 && strcmp(command, "convert") != 0) {
+    fail("unknown command", command);
+  }
+
+  const char *input_filename = optind < argc ? argv[optind++] : "-";
+  if(optind < argc) {
+    usage();
+  }
+
+  FILE *input = stdin;
+  if(strcmp(input_filename, "-") != 0) {
+    input = fopen(input_filename, options.input_format != FORMAT_TEXT ? "rb" : "r");
+    if(!input) {
+      fail(input_filename, strerror(errno));
+    }
+  }
+
+  FILE *output = stdout;
+  if(output_filename != NULL) {
+    output = fopen(output_filename, options.output_format != FORMAT_TEXT ? "wb" : "w");
+    if(!output) {
+      fail(output_filename, strerror(errno));
+    }
+  }
+
+  setvbuf(input, NULL, _IOFBF, POLYTOOL_BUFFER_SIZE);
+  setvbuf(output, NULL, _IOFBF, POLYTOOL_BUFFER_SIZE);
+  polynomial_batch_set_threads(options.threads);
+
+  EvalContext context = { NULL, 0, 0 };
+  double power = 0, tolerance = 0;
+  if(strcmp(command, "eval") == 0) {
+    context.points = parse_points(argument, &context.number_of_points);
+  } else if(strcmp(command, "unique") == 0) {
+    char *end;
+    tolerance = parse_number(argument, &end);
+    if(*end != '\0' || !(tolerance >= 0)) {
+      fail("the tolerance must be a number >= 0", argument);
+    }
+  } else if(argument != NULL) {
+    char *end;
+    power = parse_number(argument, &end);
+    if(*end != '\0' || !(power >= 1 && power <= INT_MAX) || power != (int) power) {
+      fail("the power must be a whole number >= 1", argument);
+    }
+    context.points = &power;
+  }
+
+  int per_polynomial = strcmp(command, "eval") == 0 || strcmp(command, "power") == 0 || strcmp(command, "derivative") == 0;
+
+  if(per_polynomial && options.input_format == FORMAT_TEXT && options.output_format == FORMAT_TEXT) {
+    // text to text: stream the polynomials through the pipeline, whatever the size of the input
+    PolynomialPipelineOptions pipeline = { POLYNOMIAL_PIPELINE_CUSTOM, 0, options.threads, 0, NULL, &context };
+    pipeline.custom = command[0] == 'e' ? pipeline_eval : command[0] == 'p' ? pipeline_power : pipeline_derivative;
+
+    polynomials_errno = POLYNOMIAL_SUCCESS;
+    if(!polynomial_pipeline_run_streams(input, output, &pipeline)) {
+      fflush(output);
+      fail(polynomials_errno == POLYNOMIAL_INPUT_ERROR ?
+        "couldn't read the polynomials, malformed ones were written as empty lines" :
+        "couldn't write the results", NULL);
+    }
+
+    if(fflush(output) != 0) {
+      fail("couldn't write the results", strerror(errno));
+    }
+
+    print_statistics(&options, command, context.processed, -1, -1, -1);
+  } else {
+    double read_start = now();
+    PolynomialBatch *batch = read_batch(input, options.input_format);
+    unsigned long length = polynomial_batch_get_length(batch);
+
+    double compute_start = now();
+    double write_start;
+
+    if(strcmp(command, "eval") == 0) {
+      double *values = malloc(sizeof(double) * length * context.number_of_points);
+      if(!values && length > 0) {
+        fail("out of memory", NULL);
+      }
+
+      polynomial_batch_compute_points(batch, context.points, context.number_of_points, values);
+
+      write_start = now();
+      unsigned long index;
+      for(index = 0; index < length; index++) {
+        write_values(output, values + index * context.number_of_points, context.number_of_points);
+      }
+      free(values);
+    } else if(strcmp(command, "derivative") == 0) {
+      PolynomialBatch *derivatives = polynomial_batch_derivative(batch);
+
+      write_start = now();
+      write_batch(derivatives, output, options.output_format);
+      polynomial_batch_free(&derivatives);
+    } else if(strcmp(command, "power") == 0) {
+      PolynomialBatch *powers = polynomial_batch_create();
+      unsigned long index;
+      for(index = 0; index < length; index++) {
+        Polynomial *polynomial = polynomial_batch_get(batch, index);
+        Polynomial *powered = polynomial_power(polynomial, (int) power);
+        polynomial_batch_append(powers, powered);
+        polynomial_free(&powered);
+        polynomial_free(&polynomial);
+      }
+
+      write_start = now();
+      write_batch(powers, output, options.output_format);
+      polynomial_batch_free(&powers);
+    } else if(strcmp(command, "sum") == 0 || strcmp(command, "product") == 0) {
+      Polynomial *result = command[0] == 's' ? polynomial_batch_sum(batch) : product_tree(batch);
+
+      write_start = now();
+      write_polynomial(result, output, options.output_format);
+      polynomial_free(&result);
+    } else if(strcmp(command, "unique") == 0) {
+      PolynomialBatch *unique = polynomial_batch_unique(batch, tolerance);
+
+      write_start = now();
+      write_batch(unique, output, options.output_format);
+      polynomial_batch_free(&unique);
+    } else { // convert
+      write_start = now();
+      write_batch(batch, output, options.output_format);
+    }
+
+    polynomial_batch_free(&batch);
+
+    if(fflush(output) != 0) {
+      fail("couldn't write the results", strerror(errno));
+    }
+
+    double write_end = now();
+    print_statistics(&options, command, length, compute_start - read_start, write_start - compute_start, write_end - write_start);
+  }
+
+  if(context.points != &power) {
+    free((double*) context.points);
+  }
+
+  if(input != stdin) {
+    fclose(input);
+  }
+
+  if(output != stdout && fclose(output) != 0) {
+    fail("couldn't write the results", strerror(errno));
+  }
+
+  return EXIT_SUCCESS;
+}